@@ -4,14 +4,18 @@
 \***********************************************************************/
 
 // 20170830  Remove FET simulation
+// 20261017  Write binary hit file with G4CMPHitWriter if name ends in .bin
 
 #ifndef ChargeElectrodeSensitivity_h
 #define ChargeElectrodeSensitivity_h 1
 
 #include "G4CMPElectrodeHit.hh"
 #include "G4CMPElectrodeSensitivity.hh"
+#include <fstream>
 #include <memory>
 
+class G4CMPHitWriter;
+
 
 class ChargeElectrodeSensitivity final : public G4CMPElectrodeSensitivity {
 public:
@@ -33,6 +37,7 @@ protected:
 
 private:
   std::ofstream output;
+  G4CMPHitWriter* hitWriter;		// Binary output, for ".bin" files
   G4String fileName;
 };
 
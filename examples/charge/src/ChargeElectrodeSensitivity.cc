@@ -7,9 +7,11 @@
 //
 // 20170816  Output file name moved to example-specific configuration
 // 20170830  Remove FET simulation
+// 20261017  Write binary hit file with G4CMPHitWriter if name ends in .bin
 
 #include "ChargeElectrodeSensitivity.hh"
 #include "ChargeConfigManager.hh"
+#include "G4CMPHitWriter.hh"
 #include "G4CMPUtils.hh"
 #include "G4Event.hh"
 #include "G4RunManager.hh"
@@ -24,11 +26,12 @@
 #include <fstream>
 
 ChargeElectrodeSensitivity::ChargeElectrodeSensitivity(G4String name) :
-  G4CMPElectrodeSensitivity(name), fileName("") {
+  G4CMPElectrodeSensitivity(name), hitWriter(0), fileName("") {
   SetOutputFile(ChargeConfigManager::GetHitOutput());
 }
 
 ChargeElectrodeSensitivity::~ChargeElectrodeSensitivity() {
+  delete hitWriter;			// Sends remaining hits for writing
   if (output.is_open()) output.close();
   if (!output.good()) {
     G4cerr << "Error closing output file, " << fileName << ".\n"
@@ -43,6 +46,12 @@ void ChargeElectrodeSensitivity::EndOfEvent(G4HCofThisEvent* HCE) {
 
   G4RunManager* runMan = G4RunManager::GetRunManager();
 
+  if (hitWriter) {
+    hitWriter->Add(runMan->GetCurrentRun()->GetRunID(),
+		   runMan->GetCurrentEvent()->GetEventID(), *hitVec);
+    return;
+  }
+
   if (output.good()) {
     for (G4CMPElectrodeHit* hit : *hitVec) {
       output << runMan->GetCurrentRun()->GetRunID() << ','
@@ -67,7 +76,17 @@ void ChargeElectrodeSensitivity::EndOfEvent(G4HCofThisEvent* HCE) {
 void ChargeElectrodeSensitivity::SetOutputFile(const G4String &fn) {
   if (fileName != fn) {
     if (output.is_open()) output.close();
+    delete hitWriter;
+    hitWriter = 0;
     fileName = fn;
+
+    // Binary output is buffered and written by a separate thread
+    if (fileName.size() > 4 &&
+	fileName.compare(fileName.size()-4, 4, ".bin") == 0) {
+      hitWriter = new G4CMPHitWriter(fileName);
+      return;
+    }
+
     output.open(fileName, std::ios_base::app);
     if (!output.good()) {
       G4ExceptionDescription msg;
@@ -7,6 +7,9 @@
 #define PhononSensitivity_h 1
 
 #include "G4CMPElectrodeSensitivity.hh"
+#include <fstream>
+
+class G4CMPHitWriter;
 
 class PhononSensitivity final : public G4CMPElectrodeSensitivity {
 public:
@@ -32,6 +35,7 @@ protected:
 
 private:
   std::ofstream output;
+  G4CMPHitWriter* hitWriter;		// Binary output, for ".bin" files
   G4String fileName;
 };
 
@@ -5,6 +5,7 @@
 
 #include "PhononSensitivity.hh"
 #include "G4CMPElectrodeHit.hh"
+#include "G4CMPHitWriter.hh"
 #include "G4Event.hh"
 #include "G4HCofThisEvent.hh"
 #include "G4PhononLong.hh"
@@ -19,7 +20,7 @@
 
 
 PhononSensitivity::PhononSensitivity(G4String name) :
-  G4CMPElectrodeSensitivity(name), fileName("") {
+  G4CMPElectrodeSensitivity(name), hitWriter(0), fileName("") {
   SetOutputFile(PhononConfigManager::GetHitOutput());
 }
 
@@ -44,6 +45,7 @@ PhononSensitivity& PhononSensitivity::operator=(PhononSensitivity&& in) {
 */
 
 PhononSensitivity::~PhononSensitivity() {
+  delete hitWriter;			// Sends remaining hits for writing
   if (output.is_open()) output.close();
   if (!output.good()) {
     G4cerr << "Error closing output file, " << fileName << ".\n"
@@ -58,6 +60,12 @@ void PhononSensitivity::EndOfEvent(G4HCofThisEvent* HCE) {
 
   G4RunManager* runMan = G4RunManager::GetRunManager();
 
+  if (hitWriter) {
+    hitWriter->Add(runMan->GetCurrentRun()->GetRunID(),
+		   runMan->GetCurrentEvent()->GetEventID(), *hitVec);
+    return;
+  }
+
   if (output.good()) {
     for (G4CMPElectrodeHit* hit : *hitVec) {
       output << runMan->GetCurrentRun()->GetRunID() << ','
@@ -82,7 +90,17 @@ void PhononSensitivity::EndOfEvent(G4HCofThisEvent* HCE) {
 void PhononSensitivity::SetOutputFile(const G4String &fn) {
   if (fileName != fn) {
     if (output.is_open()) output.close();
+    delete hitWriter;
+    hitWriter = 0;
     fileName = fn;
+
+    // Binary output is buffered and written by a separate thread
+    if (fileName.size() > 4 &&
+	fileName.compare(fileName.size()-4, 4, ".bin") == 0) {
+      hitWriter = new G4CMPHitWriter(fileName);
+      return;
+    }
+
     output.open(fileName, std::ios_base::app);
     if (!output.good()) {
       G4ExceptionDescription msg;
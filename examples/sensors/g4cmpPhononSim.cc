@@ -0,0 +1,34 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// Usage: g4cmpPhononSim <hits.csv|hits.bin> [output] [channels] [templates] [noisePSD]
+
+#include "PhononPulseDigitizerModule.hh"
+
+int main(int argc, char** argv) {
+  G4String filename;
+  if (argc == 1) {
+    G4cout << "Enter path to data file to be processed: " << G4endl;
+    G4cin >> filename;
+  } else {
+    filename = argv[1];
+  }
+
+  PhononPulseDigitizerModule pulsesim;
+  if (argc > 2) {
+    pulsesim.SetOutputFile(argv[2]);
+  } else {
+    pulsesim.SetOutputFile("PhononPulses");
+  }
+
+  if (argc > 3) pulsesim.SetChannelFilename(argv[3]);
+  if (argc > 4) pulsesim.SetTemplateFilename(argv[4]);
+  if (argc > 5) pulsesim.SetNoiseFilename(argv[5]);
+
+  pulsesim.Build();
+  pulsesim.PostProcess(filename);
+
+  return 0;
+}
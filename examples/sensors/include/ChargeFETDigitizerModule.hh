@@ -3,11 +3,28 @@
  * License version 3 or later. See G4CMP/LICENSE for the full license. *
 \***********************************************************************/
 
+// Traces may be written either as CSV text (one line per channel), or,
+// if the output file name ends in ".bin", as binary records:
+//
+//   | Item        | Type            | Content                          |
+//   |-------------|-----------------|----------------------------------|
+//   | magic       | char[8]         | "G4CMPFET" (once, at file start) |
+//   | runID       | int32           |                                  |
+//   | eventID     | int32           |                                  |
+//   | numChannels | uint32          | C                                |
+//   | timeBins    | uint32          | N                                |
+//   | traces      | float[C][N]     | Channel 1 first                  |
+//
+// in host byte order.  Records are repeated for each event.
+
 #ifndef CHARGEFETDIGITIZERMODULE_HH
 #define CHARGEFETDIGITIZERMODULE_HH
 
 #include "G4VDigitizerModule.hh"
+#include "G4ThreeVector.hh"
 #include <fstream>
+#include <map>
+#include <utility>
 
 class ChargeFETDigitizerMessenger;
 class G4CMPMeshElectricField;
@@ -26,7 +43,11 @@ class ChargeFETDigitizerModule : public G4VDigitizerModule
 
     void Build();
     virtual void Digitize();
-    void PostProcess(const G4String& fileName);
+    void PostProcess(const G4String& fileName);	// CSV or binary hit file
+
+    // Digitize hits from one event directly, without going through a file
+    void DigitizeHits(const vector<G4CMPElectrodeHit*>& hits,
+                      G4int RunID, G4int EventID);
 
     // Methods for Messenger
     void     EnableFETSim();
@@ -63,10 +84,25 @@ class ChargeFETDigitizerModule : public G4VDigitizerModule
   private:
     void ReadFETConstantsFile();
     void BuildFETTemplates();
-    vector<vector<G4double> > CalculateTraces(const vector<G4double>& scaleFactors);
+    void FindCrossTerms();
     void BuildRamoFields();
-    void WriteFETTraces(const vector<vector<G4double> >& FETTraces,
-                        G4int RunID, G4int EventID);
+
+    // Collect charges for one event, then make and write traces
+    void AddCharge(const G4ThreeVector& position, G4double charge);
+    void ProcessEvent(G4int RunID, G4int EventID);
+    void CalculateScaleFactors();
+    void CalculateTraces();
+    void WriteFETTraces(G4int RunID, G4int EventID);
+    void WriteBinaryTraces(G4int RunID, G4int EventID);
+
+    // Hits read from file are grouped by (run, event), as their order in
+    // the file is not guaranteed; each event is processed after reading
+    void CollectCharge(G4int RunID, G4int EventID,
+                       const G4ThreeVector& position, G4double charge);
+    void ProcessCollected();
+
+    void ReadCSVHits(std::istream& input);
+    void ReadBinaryHits(std::istream& input);
 
     ChargeFETDigitizerMessenger* messenger;
     // FET constants
@@ -82,6 +118,7 @@ class ChargeFETDigitizerModule : public G4VDigitizerModule
     G4bool rebuildFETTemplates;
     G4bool rebuildRamoFields;
     // File Stuff
+    G4bool binaryOutput;
     std::ofstream outputFile;
     std::ifstream constantsFile;
     std::ifstream templateFile;
@@ -90,8 +127,22 @@ class ChargeFETDigitizerModule : public G4VDigitizerModule
     G4String templateFilename;
     G4String ramoFileDir;
     // FETSim Quantities
-    vector<vector<vector<G4double> > > FETTemplates; //4x4x4096 = 4 channels w/ cross-talk terms
+    vector<G4double> FETTemplates; //4x4x4096 = 4 channels w/ cross-talk terms, flattened
+    vector<vector<size_t> > crossTerms; // Non-zero templates for each channel
     vector<G4CMPMeshElectricField> RamoFields;
+    // Buffers reused for each event
+    vector<G4ThreeVector> chargePositions;
+    vector<G4double> charges;
+    vector<G4double> potentials;
+    vector<G4double> scaleFactors;
+    vector<G4double> traces;            // numChannels x timeBins, flattened
+    vector<float> traceOutput;
+    // Charges read from file, per (run, event), until end of input
+    struct EventCharges {
+      vector<G4ThreeVector> positions;
+      vector<G4double> charges;
+    };
+    std::map<std::pair<G4int,G4int>, EventCharges> collected;
 };
 
 #endif // CHARGEFETDIGITIZERMODULE_HH
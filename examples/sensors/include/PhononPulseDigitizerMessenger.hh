@@ -0,0 +1,42 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+#ifndef PHONONPULSEMESSENGER_HH
+#define PHONONPULSEMESSENGER_HH 1
+
+#include "G4UImessenger.hh"
+
+class PhononPulseDigitizerModule;
+class G4UIdirectory;
+class G4UIcmdWithoutParameter;
+class G4UIcmdWithAString;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithADoubleAndUnit;
+
+class PhononPulseDigitizerMessenger : public G4UImessenger
+{
+  public:
+    PhononPulseDigitizerMessenger(PhononPulseDigitizerModule* digitizer);
+    ~PhononPulseDigitizerMessenger();
+    void SetNewValue(G4UIcommand* command, G4String NewValue);
+  private:
+    PhononPulseDigitizerModule* pulse;
+    G4UIdirectory*             pulseDir;
+    G4UIcmdWithoutParameter*   EnableCmd;
+    G4UIcmdWithoutParameter*   DisableCmd;
+    G4UIcmdWithAString*        SetOutputFileCmd;
+    G4UIcmdWithAString*        SetChannelFileCmd;
+    G4UIcmdWithAString*        SetTemplateFileCmd;
+    G4UIcmdWithAString*        SetNoiseFileCmd;
+    G4UIcmdWithAnInteger*      SetTimeBinCmd;
+    G4UIcmdWithADoubleAndUnit* SetUnitTimeCmd;
+    G4UIcmdWithADoubleAndUnit* SetPreTrigCmd;
+    G4UIcmdWithADoubleAndUnit* SetRiseTimeCmd;
+    G4UIcmdWithADoubleAndUnit* SetDecayTimeCmd;
+    G4UIcmdWithAnInteger*      SetBatchSizeCmd;
+    G4UIcmdWithoutParameter*   UpdateCmd;
+};
+
+#endif
@@ -0,0 +1,180 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// Phonon sensor pulse simulation.  Absorbed phonon energy (EDep times
+// track weight) is binned in time for each channel, convolved with that
+// channel's pulse template, and noise drawn from a power spectral density
+// is added.  Events are collected in batches, and each batch is processed
+// together; convolution and noise use FFTs, two channels per transform.
+// Hits read from a file are first collected by (run, event), so an
+// event's hits need not be contiguous in the file; each event is written
+// once, after the whole file is read.
+//
+// Each hit is assigned to the channel whose position (from the channel
+// file) is nearest to the hit's final position.  Without a channel file,
+// all hits go to a single channel.
+//
+// Input files (whitespace separated text):
+//   Channel file:  One line per channel, "x y z" of sensor center [mm]
+//   Template file: numChannels x timeBins values, channel 1 first, for
+//                  1 eV of absorbed energy.  If missing, a pulse with
+//                  riseTime and decayTime, and unit peak, is used.
+//   Noise file:    One line per frequency, "f[Hz] S1 S2 ...", with the
+//                  one-sided PSD of each channel [(pulse units)^2/Hz].
+//                  A single PSD column is used for all channels.  If no
+//                  file is given, no noise is added.
+//
+// Output is written in the same formats as ChargeFETDigitizerModule:
+// CSV text, or binary records if the file name ends in ".bin" (magic
+// "G4CMPPHN" instead of "G4CMPFET").
+
+#ifndef PHONONPULSEDIGITIZERMODULE_HH
+#define PHONONPULSEDIGITIZERMODULE_HH
+
+#include "G4VDigitizerModule.hh"
+#include "G4ThreeVector.hh"
+#include "SensorFFT.hh"
+#include <fstream>
+#include <map>
+#include <utility>
+#include <vector>
+
+class PhononPulseDigitizerMessenger;
+class G4CMPElectrodeHit;
+class G4String;
+
+using std::vector;
+
+class PhononPulseDigitizerModule : public G4VDigitizerModule
+{
+  public:
+    PhononPulseDigitizerModule(G4String modName);
+    // Default constructor only to be used for stand-alone post-processing!
+    PhononPulseDigitizerModule();
+    virtual ~PhononPulseDigitizerModule();   // Processes last batch
+
+    void Build();
+    virtual void Digitize();
+    void PostProcess(const G4String& fileName);   // CSV or binary hit file
+
+    // Digitize hits from one event directly, without going through a file
+    void DigitizeHits(const vector<G4CMPElectrodeHit*>& hits,
+                      G4int RunID, G4int EventID);
+
+    // Make and write traces for all events collected so far
+    void ProcessBatch();
+
+    // Channel for phonon absorbed at position (see above)
+    virtual size_t GetChannel(const G4ThreeVector& position) const;
+
+    // Methods for Messenger
+    void     EnablePhononSim();
+    void     DisablePhononSim();
+    G4bool   PhononSimIsEnabled() const {return enabledForSD;}
+
+    void     SetOutputFile(const G4String& name);
+    G4String GetOutputFile() const {return outputFilename;}
+
+    void     SetChannelFilename(const G4String& name);
+    G4String GetChannelFilename() const {return channelFilename;}
+
+    void     SetTemplateFilename(const G4String& name);
+    G4String GetTemplateFilename() const {return templateFilename;}
+
+    void     SetNoiseFilename(const G4String& name);
+    G4String GetNoiseFilename() const {return noiseFilename;}
+
+    void     SetTimeBins(size_t n);
+    size_t   GetTimeBins() const {return timeBins;}
+
+    void     SetUnitTime(G4double n);
+    G4double GetUnitTime() const {return dt;}
+
+    void     SetPreTrig(G4double n);
+    G4double GetPreTrig() const {return preTrig;}
+
+    void     SetRiseTime(G4double n);
+    G4double GetRiseTime() const {return riseTime;}
+
+    void     SetDecayTime(G4double n);
+    G4double GetDecayTime() const {return decayTime;}
+
+    void     SetBatchSize(size_t n) {batchSize = (n>0 ? n : 1);}
+    size_t   GetBatchSize() const {return batchSize;}
+
+    size_t   GetNumberOfChannels() const {return numChannels;}
+
+  private:
+    void ReadChannelFile();
+    void BuildTemplates();
+    void ReadNoiseFile();
+
+    // Energy binned in time for current event; hits for an event already
+    // in the batch are added to its slot, even if not contiguous in file
+    void StartEvent(G4int RunID, G4int EventID);
+    void AddEnergy(const G4ThreeVector& position, G4double time,
+                   G4double energy);
+
+    // Hits read from file are grouped by (run, event), as their order in
+    // the file is not guaranteed; events are binned after reading
+    void CollectHit(G4int RunID, G4int EventID, const G4ThreeVector& position,
+                    G4double time, G4double energy);
+    void ProcessCollected();
+
+    void ReadCSVHits(std::istream& input);
+    void ReadBinaryHits(std::istream& input);
+
+    // Convolve (and add noise to) channels a and b of event in batch
+    void CalculateTraces(size_t event, size_t chanA, size_t chanB);
+    void AddNoise(size_t chanA, size_t chanB);
+    void WriteTraces(G4int RunID, G4int EventID);
+
+    PhononPulseDigitizerMessenger* messenger;
+    // Pulse constants
+    G4double dt;
+    G4double preTrig;
+    G4double riseTime;
+    G4double decayTime;
+    size_t numChannels;
+    size_t timeBins;
+    size_t batchSize;
+    // Enable/Disable during sim
+    G4bool enabledForSD;
+    // Internal flags to not waste time on unnecessary recalculating
+    G4bool rebuildChannels;
+    G4bool rebuildTemplates;
+    G4bool rebuildNoise;
+    // File Stuff
+    G4bool binaryOutput;
+    std::ofstream outputFile;
+    G4String outputFilename;
+    G4String channelFilename;
+    G4String templateFilename;
+    G4String noiseFilename;
+    // Sensor quantities
+    vector<G4ThreeVector> channelPositions;
+    SensorFFT fft;                               // Twice trace length
+    vector<vector<SensorFFT::Complex> > templateSpectra;
+    vector<vector<G4double> > noiseAmplitude;    // Per channel, per frequency
+    // Batch of events waiting to be processed
+    vector<G4int> batchRunIDs;
+    vector<G4int> batchEventIDs;
+    vector<G4double> batchEnergy;                // event x channel x timeBins
+    std::map<std::pair<G4int,G4int>, size_t> batchSlots;  // (run,event)
+    size_t currentSlot;                          // Event receiving hits
+    // Buffers reused for each event
+    vector<SensorFFT::Complex> spectrum;
+    vector<G4double> traces;                     // numChannels x timeBins
+    vector<float> traceOutput;
+    // Hits read from file, per (run, event), until end of input
+    struct EventHits {
+      vector<G4ThreeVector> positions;
+      vector<G4double> times;
+      vector<G4double> energies;
+    };
+    std::map<std::pair<G4int,G4int>, EventHits> collected;
+};
+
+#endif // PHONONPULSEDIGITIZERMODULE_HH
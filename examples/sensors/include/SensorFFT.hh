@@ -0,0 +1,42 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// Radix-2 complex FFT of fixed length, with twiddle factors and bit
+// reversal computed once.  Used by the sensor digitizers for pulse
+// convolution and noise generation.  Length must be a power of two.
+
+#ifndef SENSORFFT_HH
+#define SENSORFFT_HH
+
+#include "G4Types.hh"
+#include <complex>
+#include <vector>
+
+class SensorFFT
+{
+  public:
+    typedef std::complex<G4double> Complex;
+
+    explicit SensorFFT(size_t n=0) { SetSize(n); }
+
+    void   SetSize(size_t n);
+    size_t GetSize() const {return size;}
+
+    // Smallest power of two not less than n
+    static size_t PowerOfTwo(size_t n);
+
+    // In-place transforms of exactly GetSize() values; Inverse includes 1/N
+    void Forward(std::vector<Complex>& data) const { Transform(data, false); }
+    void Inverse(std::vector<Complex>& data) const { Transform(data, true); }
+
+  private:
+    void Transform(std::vector<Complex>& data, G4bool inverse) const;
+
+    size_t size;
+    std::vector<size_t>  bitReverse;
+    std::vector<Complex> twiddle;    // exp(-2 pi i k/N), k < N/2
+};
+
+#endif // SENSORFFT_HH
@@ -14,13 +14,26 @@
 #include "G4SDManager.hh"
 #include "G4Run.hh"
 #include "G4Event.hh"
+#include "G4CMPHitBlock.hh"
+#include <algorithm>
 #include <sstream>
+#include <stdint.h>
+
+namespace {
+  const char traceMagic[8] = { 'G','4','C','M','P','F','E','T' };
+  const size_t traceBlock = 512;	// Bins per pass in CalculateTraces()
+
+  G4bool EndsWith(const G4String& name, const G4String& suffix) {
+    return (name.size() >= suffix.size() &&
+            name.compare(name.size()-suffix.size(), suffix.size(), suffix) == 0);
+  }
+}
 
 ChargeFETDigitizerModule::ChargeFETDigitizerModule(G4String modName) :
   G4VDigitizerModule(modName), messenger(new ChargeFETDigitizerMessenger(this)),
   decayTime(40e-6*s), dt(800e-9*s), preTrig(4096e-7*s), numChannels(4),
   timeBins(4096), enabledForSD(false), rereadConfigFile(true),
-  rebuildFETTemplates(true), rebuildRamoFields(true),
+  rebuildFETTemplates(true), rebuildRamoFields(true), binaryOutput(false),
   outputFilename("FETOutput"),
   configFilename("config/G4CMP/FETSim/ConstantsFET"),
   templateFilename("config/G4CMP/FETSim/FETTemplates"),
@@ -31,7 +44,7 @@ ChargeFETDigitizerModule::ChargeFETDigitizerModule() :
   G4VDigitizerModule("NoSim"), messenger(nullptr),
   decayTime(40e-6*s), dt(800e-9*s), preTrig(4096e-7*s), numChannels(4),
   timeBins(4096), enabledForSD(false), rereadConfigFile(true),
-  rebuildFETTemplates(true), rebuildRamoFields(true),
+  rebuildFETTemplates(true), rebuildRamoFields(true), binaryOutput(false),
   outputFilename("FETOutput"),
   configFilename("config/G4CMP/FETSim/ConstantsFET"),
   templateFilename("config/G4CMP/FETSim/FETTemplates"),
@@ -65,54 +78,58 @@ void ChargeFETDigitizerModule::Build()
 void ChargeFETDigitizerModule::Digitize()
 {
   if (!enabledForSD) return;
-  G4HCofThisEvent* HCE =
-    G4RunManager::GetRunManager()->GetCurrentEvent()->GetHCofThisEvent();
+  const G4Event* event = G4RunManager::GetRunManager()->GetCurrentEvent();
+  G4HCofThisEvent* HCE = event ? event->GetHCofThisEvent() : nullptr;
+  if (!HCE) return;
+
   G4SDManager* fSDM = G4SDManager::GetSDMpointer();
   G4int HCID = fSDM->GetCollectionID("G4CMPElectrodeHit");
   G4CMPElectrodeHitsCollection* hitCol =
     static_cast<G4CMPElectrodeHitsCollection*>(HCE->GetHC(HCID));
-  vector<G4CMPElectrodeHit*>* hitVec = hitCol->GetVector();
+  if (!hitCol) return;
 
-  vector<G4double> scaleFactors(numChannels,0);
-  G4double position[4] = {0.,0.,0.,0.};
-  G4ThreeVector vecPosition;
-  for(size_t chan = 0; chan < numChannels; ++chan) {
-    for(size_t hitIdx=0; hitIdx < hitVec->size(); ++hitIdx) {
-      if(hitVec->at(hitIdx)->GetParticleName()=="G4CMPDriftElectron" ||
-         hitVec->at(hitIdx)->GetParticleName()=="G4CMPDriftHole") {
-        vecPosition = hitVec->at(hitIdx)->GetFinalPosition();
-        position[0] = vecPosition.getX();
-        position[1] = vecPosition.getY();
-        position[2] = vecPosition.getZ();
-        if(hitVec->at(hitIdx)->GetParticleName()=="G4CMPDriftElectron")
-          scaleFactors[chan] -= -1 * RamoFields[chan].GetPotential(position);
-        else
-          scaleFactors[chan] -= 1 * RamoFields[chan].GetPotential(position);
-      }
-    }
+  G4int runID = G4RunManager::GetRunManager()->GetCurrentRun()->GetRunID();
+  DigitizeHits(*hitCol->GetVector(), runID, event->GetEventID());
+}
+
+void ChargeFETDigitizerModule::DigitizeHits(
+  const vector<G4CMPElectrodeHit*>& hits, G4int RunID, G4int EventID)
+{
+  for (const G4CMPElectrodeHit* hit : hits) {
+    const G4String& name = hit->GetParticleName();
+    if (name == "G4CMPDriftElectron")
+      AddCharge(hit->GetFinalPosition(), -1.);
+    else if (name == "G4CMPDriftHole")
+      AddCharge(hit->GetFinalPosition(), 1.);
   }
 
-  vector<vector<G4double> > FETTraces(CalculateTraces(scaleFactors));
-  G4int runID = G4RunManager::GetRunManager()->GetCurrentRun()->GetRunID();
-  G4int eventID = G4RunManager::GetRunManager()->GetCurrentEvent()->GetEventID();
-  WriteFETTraces(FETTraces, runID, eventID);
+  ProcessEvent(RunID, EventID);
 }
 
 void ChargeFETDigitizerModule::PostProcess(const G4String& fileName)
 {
-  std::ifstream input(fileName);
+  G4bool binaryInput = EndsWith(fileName, ".bin");
+  std::ifstream input(fileName, binaryInput ? std::ios::binary : std::ios::in);
   if (!input.good()) {
     G4ExceptionDescription msg;
     msg << "Error reading data input file from " << fileName;
     G4Exception("ChargeFETDigitizerModule::PostProcess", "Charge002",
     FatalException, msg);
   }
+
+  if (binaryInput) ReadBinaryHits(input);
+  else ReadCSVHits(input);
+}
+
+// Hits are collected by (run, event), then processed once file is read
+
+void ChargeFETDigitizerModule::ReadCSVHits(std::istream& input)
+{
   G4double throw_away;
   G4String particleName;
-  G4double position[4] = {0.,0.,0.,0.};
+  G4ThreeVector position;
   G4double charge;
-  G4int RunID, EventID;
-  vector<G4double> scaleFactors(numChannels,0);
+  G4int RunID = -1, EventID = -1;
 
   G4String line;
   G4String entry;
@@ -139,8 +156,8 @@ void ChargeFETDigitizerModule::PostProcess(const G4String& fileName)
 
     for (size_t i=0; i<3; ++i) {
       std::getline(ssLine,entry,',');
-      std::istringstream(entry) >> position[i];
-      position[i] *= m;
+      std::istringstream(entry) >> throw_away;
+      position[i] = throw_away*m;
     }
 
     std::getline(ssLine,entry,',');
@@ -148,29 +165,121 @@ void ChargeFETDigitizerModule::PostProcess(const G4String& fileName)
 
     if (particleName == "G4CMPDriftElectron") {
       charge = -1;
-    } else if (particleName == "G4CMPDriftElectron") {
+    } else if (particleName == "G4CMPDriftHole") {
       charge = 1;
     } else {
       continue;
     }
-    for(size_t chan = 0; chan < numChannels; ++chan) {
-      scaleFactors[chan] -= charge*RamoFields[chan].GetPotential(position);
+
+    CollectCharge(RunID, EventID, position, charge);
+  }
+
+  ProcessCollected();
+}
+
+void ChargeFETDigitizerModule::ReadBinaryHits(std::istream& input)
+{
+  if (!G4CMPHitBlock::ReadHeader(input)) {
+    G4Exception("ChargeFETDigitizerModule::ReadBinaryHits", "Charge008",
+                FatalException, "Input is not a G4CMP binary hit file.");
+    return;
+  }
+
+  G4CMPHitBlock block;
+  while (input.peek() != EOF && block.Read(input)) {
+    for (size_t i=0; i<block.Size(); ++i) {
+      const G4String& name = block.GetParticleName(i);
+      G4double charge = (name == "G4CMPDriftElectron" ? -1. :
+                         name == "G4CMPDriftHole" ? 1. : 0.);
+      if (charge == 0.) continue;
+
+      CollectCharge(block.runID[i], block.eventID[i],
+                    G4ThreeVector(block.finalX[i], block.finalY[i],
+                                  block.finalZ[i])*m, charge);
     }
   }
 
-  vector<vector<G4double> > FETTraces(CalculateTraces(scaleFactors));
-  WriteFETTraces(FETTraces, RunID, EventID);
+  ProcessCollected();
+}
+
+void ChargeFETDigitizerModule::CollectCharge(G4int RunID, G4int EventID,
+                                             const G4ThreeVector& position,
+                                             G4double charge)
+{
+  EventCharges& event = collected[std::make_pair(RunID, EventID)];
+  event.positions.push_back(position);
+  event.charges.push_back(charge);
+}
+
+// Events are processed in (run, event) order, and released as they go
+
+void ChargeFETDigitizerModule::ProcessCollected()
+{
+  for (auto& event : collected) {
+    chargePositions.swap(event.second.positions);
+    charges.swap(event.second.charges);
+    ProcessEvent(event.first.first, event.first.second);
+    vector<G4ThreeVector>().swap(event.second.positions);
+    vector<G4double>().swap(event.second.charges);
+  }
+
+  collected.clear();
+}
+
+void ChargeFETDigitizerModule::AddCharge(const G4ThreeVector& position,
+                                         G4double charge)
+{
+  chargePositions.push_back(position);
+  charges.push_back(charge);
+}
+
+void ChargeFETDigitizerModule::ProcessEvent(G4int RunID, G4int EventID)
+{
+  CalculateScaleFactors();
+  CalculateTraces();
+  if (binaryOutput) WriteBinaryTraces(RunID, EventID);
+  else WriteFETTraces(RunID, EventID);
+
+  chargePositions.clear();
+  charges.clear();
 }
 
-vector<vector<G4double> > ChargeFETDigitizerModule::CalculateTraces(
-                                    const vector<G4double>& scaleFactors)
+// Induced charge on each channel, from Ramo potential at final positions
+
+void ChargeFETDigitizerModule::CalculateScaleFactors()
 {
-  vector<vector<G4double> > FETTraces(numChannels,vector<G4double>(timeBins,0.));
-  for(size_t chan=0; chan < numChannels; ++chan)
-    for(size_t cross=0; cross < numChannels; ++cross)
-      for(size_t bin=0; bin < timeBins; ++bin)
-        FETTraces[chan][bin] += scaleFactors[cross]*FETTemplates[chan][cross][bin];
-  return FETTraces;
+  scaleFactors.assign(numChannels, 0.);
+  if (chargePositions.empty()) return;
+
+  size_t nFields = std::min(numChannels, RamoFields.size());
+  for (size_t chan = 0; chan < nFields; ++chan) {
+    RamoFields[chan].GetPotentials(chargePositions, potentials);
+    for (size_t i = 0; i < charges.size(); ++i)
+      scaleFactors[chan] -= charges[i]*potentials[i];
+  }
+}
+
+// Sum of templates weighted by scale factors, skipping empty cross-terms;
+// bins are done in blocks so each part of the trace stays in cache.
+
+void ChargeFETDigitizerModule::CalculateTraces()
+{
+  traces.assign(numChannels*timeBins, 0.);
+
+  for (size_t chan=0; chan < numChannels; ++chan) {
+    G4double* trace = &traces[chan*timeBins];
+    for (size_t first=0; first < timeBins; first += traceBlock) {
+      size_t last = std::min(first+traceBlock, timeBins);
+      for (size_t cross : crossTerms[chan]) {
+        const G4double scale = scaleFactors[cross];
+        if (scale == 0.) continue;
+
+        const G4double* tmpl = &FETTemplates[(chan*numChannels+cross)*timeBins];
+        for (size_t bin=first; bin < last; ++bin)
+          trace[bin] += scale*tmpl[bin];
+      }
+    }
+  }
 }
 
 void ChargeFETDigitizerModule::ReadFETConstantsFile()
@@ -247,32 +356,45 @@ void ChargeFETDigitizerModule::ReadFETConstantsFile()
 
 void ChargeFETDigitizerModule::BuildFETTemplates()
 {
-  FETTemplates = vector<vector<vector<G4double> > >
-    (numChannels, vector<vector<G4double> >
-    (numChannels, vector<G4double>(timeBins, 0) ) );
+  FETTemplates.assign(numChannels*numChannels*timeBins, 0.);
   templateFile.open(templateFilename.c_str());
   if(templateFile.good()) {
-    for(size_t i=0; i<numChannels; ++i)
-      for(size_t j=0; j<numChannels; ++j)
-        for(size_t k=0; k<timeBins; ++k)
-          templateFile >> FETTemplates[i][j][k];
+    for(size_t k=0; k<FETTemplates.size(); ++k)
+      templateFile >> FETTemplates[k];
   } else {
     G4Exception("ChargeFETDigitizerModule::BuildFETTemplate", "Charge007",
 		JustWarning,
 	"Reading from template file failed. Using default pulse templates.");
 
     for(size_t i=0; i<numChannels; ++i) {
+      G4double* tmpl = &FETTemplates[(i*numChannels+i)*timeBins];
       size_t ndt = static_cast<size_t>(preTrig/dt);
       for(size_t j=0; j<ndt; ++j)
-        FETTemplates[i][i][j] = 0;
+        tmpl[j] = 0;
       for(size_t k=1; k<timeBins-ndt+1; ++k)
-        FETTemplates[i][i][k+ndt-1] = exp(-k*dt/decayTime);
+        tmpl[k+ndt-1] = exp(-(k*dt)/decayTime);
     }
   }
   templateFile.close();
+  FindCrossTerms();
   rebuildFETTemplates = false;
 }
 
+// Record which templates are non-zero, so empty ones can be skipped
+
+void ChargeFETDigitizerModule::FindCrossTerms()
+{
+  crossTerms.assign(numChannels, vector<size_t>());
+  for(size_t i=0; i<numChannels; ++i) {
+    for(size_t j=0; j<numChannels; ++j) {
+      const G4double* tmpl = &FETTemplates[(i*numChannels+j)*timeBins];
+      if (std::any_of(tmpl, tmpl+timeBins,
+                      [](G4double v) { return v != 0.; }))
+        crossTerms[i].push_back(j);
+    }
+  }
+}
+
 void ChargeFETDigitizerModule::BuildRamoFields()
 {
   if (RamoFields.size()) RamoFields.clear();
@@ -293,18 +415,31 @@ void ChargeFETDigitizerModule::BuildRamoFields()
   rebuildRamoFields = false;
 }
 
-void ChargeFETDigitizerModule::WriteFETTraces(
-  const vector<vector<G4double> >& traces, G4int RunID, G4int EventID)
+void ChargeFETDigitizerModule::WriteFETTraces(G4int RunID, G4int EventID)
 {
   for(size_t chan = 0; chan < numChannels; ++chan) {
+    const G4double* trace = &traces[chan*timeBins];
     outputFile << RunID << "," << EventID << "," << chan+1 << ",";
     for(size_t bin = 0; bin < timeBins-1; ++bin) {
-      outputFile << traces[chan][bin] << ",";
+      outputFile << trace[bin] << ",";
     }
-    outputFile << traces[chan][timeBins-1] << "\n";
+    outputFile << trace[timeBins-1] << "\n";
   }
 }
 
+void ChargeFETDigitizerModule::WriteBinaryTraces(G4int RunID, G4int EventID)
+{
+  traceOutput.assign(traces.begin(), traces.end());
+
+  int32_t ids[2] = { RunID, EventID };
+  uint32_t sizes[2] = { static_cast<uint32_t>(numChannels),
+                        static_cast<uint32_t>(timeBins) };
+  outputFile.write(reinterpret_cast<const char*>(ids), sizeof(ids));
+  outputFile.write(reinterpret_cast<const char*>(sizes), sizeof(sizes));
+  outputFile.write(reinterpret_cast<const char*>(traceOutput.data()),
+                   traceOutput.size()*sizeof(float));
+}
+
 void ChargeFETDigitizerModule::EnableFETSim()
 {
   enabledForSD = true;
@@ -315,10 +450,12 @@ void ChargeFETDigitizerModule::EnableFETSim()
 
 void ChargeFETDigitizerModule::SetOutputFile(const G4String& fn)
 {
-  if (outputFilename != fn) {
+  if (outputFilename != fn || !outputFile.is_open()) {
     if (outputFile.is_open()) outputFile.close();
     outputFilename = fn;
-    outputFile.open(outputFilename, std::ios_base::app);
+    binaryOutput = EndsWith(outputFilename, ".bin");
+    outputFile.open(outputFilename, binaryOutput ?
+                    std::ios_base::app|std::ios_base::binary : std::ios_base::app);
     if (!outputFile.good()) {
       G4ExceptionDescription msg;
       msg << "Error opening output file, " << outputFilename << ".\n"
@@ -326,6 +463,10 @@ void ChargeFETDigitizerModule::SetOutputFile(const G4String& fn)
       G4Exception("ChargeFETDigitizerModule::SetOutputFile", "Charge006",
                   JustWarning, msg);
       outputFile.close();
+    } else if (binaryOutput) {
+      outputFile.seekp(0, std::ios_base::end);
+      if (outputFile.tellp() == std::streampos(0))
+        outputFile.write(traceMagic, sizeof(traceMagic));
     } else {
       outputFile << "Run ID,Event ID,Channel,Pulse (4096 bins)" << G4endl;
     }
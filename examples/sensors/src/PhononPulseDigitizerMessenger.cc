@@ -0,0 +1,114 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+#include "PhononPulseDigitizerMessenger.hh"
+#include "PhononPulseDigitizerModule.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithoutParameter.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+
+PhononPulseDigitizerMessenger::PhononPulseDigitizerMessenger(
+                   PhononPulseDigitizerModule* digitizer) : pulse(digitizer)
+{
+  pulseDir = new G4UIdirectory("/g4cmp/PhononSim/");
+  pulseDir->SetGuidance("Phonon sensor pulse simulation commands");
+
+  EnableCmd = new G4UIcmdWithoutParameter("/g4cmp/PhononSim/EnablePhononSim",this);
+  EnableCmd->SetGuidance("Enable phonon pulse simulation during run.");
+
+  DisableCmd = new G4UIcmdWithoutParameter("/g4cmp/PhononSim/DisablePhononSim",this);
+  DisableCmd->SetGuidance("Disable phonon pulse simulation during run.");
+
+  SetOutputFileCmd = new G4UIcmdWithAString("/g4cmp/PhononSim/SetOutputFile",this);
+  SetOutputFileCmd->SetGuidance("Set path to pulse output file (binary if .bin).");
+
+  SetChannelFileCmd = new G4UIcmdWithAString("/g4cmp/PhononSim/SetChannelFile",this);
+  SetChannelFileCmd->SetGuidance("Set path to file of channel positions.");
+
+  SetTemplateFileCmd = new G4UIcmdWithAString("/g4cmp/PhononSim/SetTemplateFile",this);
+  SetTemplateFileCmd->SetGuidance("Set path to pulse template file.");
+
+  SetNoiseFileCmd = new G4UIcmdWithAString("/g4cmp/PhononSim/SetNoiseFile",this);
+  SetNoiseFileCmd->SetGuidance("Set path to noise PSD file.");
+
+  SetTimeBinCmd = new G4UIcmdWithAnInteger("/g4cmp/PhononSim/SetNumberOfBins",this);
+  SetTimeBinCmd->SetGuidance("Set number of digitizer bins");
+  SetTimeBinCmd->SetParameterName("value",false);
+  SetTimeBinCmd->SetRange("value>0");
+
+  SetUnitTimeCmd = new G4UIcmdWithADoubleAndUnit("/g4cmp/PhononSim/SetUnitTime",this);
+  SetUnitTimeCmd->SetGuidance("Set dt for pulse bins");
+  SetUnitTimeCmd->SetUnitCategory("Time");
+
+  SetPreTrigCmd = new G4UIcmdWithADoubleAndUnit("/g4cmp/PhononSim/SetPreTriggerTime",this);
+  SetPreTrigCmd->SetGuidance("Set pre-trigger time for pulse");
+  SetPreTrigCmd->SetUnitCategory("Time");
+
+  SetRiseTimeCmd = new G4UIcmdWithADoubleAndUnit("/g4cmp/PhononSim/SetRiseTime",this);
+  SetRiseTimeCmd->SetGuidance("Pulse rise time (if not using templates)");
+  SetRiseTimeCmd->SetUnitCategory("Time");
+
+  SetDecayTimeCmd = new G4UIcmdWithADoubleAndUnit("/g4cmp/PhononSim/SetDecayTime",this);
+  SetDecayTimeCmd->SetGuidance("Pulse decay time (if not using templates)");
+  SetDecayTimeCmd->SetUnitCategory("Time");
+
+  SetBatchSizeCmd = new G4UIcmdWithAnInteger("/g4cmp/PhononSim/SetBatchSize",this);
+  SetBatchSizeCmd->SetGuidance("Number of events to collect before making pulses");
+  SetBatchSizeCmd->SetParameterName("value",false);
+  SetBatchSizeCmd->SetRange("value>0");
+
+  UpdateCmd = new G4UIcmdWithoutParameter("/g4cmp/PhononSim/Update",this);
+  UpdateCmd->SetGuidance("Reread files and rebuild templates after changing parameters.");
+}
+
+PhononPulseDigitizerMessenger::~PhononPulseDigitizerMessenger()
+{
+    delete pulseDir;
+    delete EnableCmd;
+    delete DisableCmd;
+    delete SetOutputFileCmd;
+    delete SetChannelFileCmd;
+    delete SetTemplateFileCmd;
+    delete SetNoiseFileCmd;
+    delete SetTimeBinCmd;
+    delete SetUnitTimeCmd;
+    delete SetPreTrigCmd;
+    delete SetRiseTimeCmd;
+    delete SetDecayTimeCmd;
+    delete SetBatchSizeCmd;
+    delete UpdateCmd;
+}
+
+void PhononPulseDigitizerMessenger::SetNewValue(G4UIcommand* command, G4String NewValue)
+{
+  if (command == EnableCmd)
+    pulse->EnablePhononSim();
+  else if (command == DisableCmd)
+    pulse->DisablePhononSim();
+  else if (command == SetOutputFileCmd)
+    pulse->SetOutputFile(NewValue);
+  else if (command == SetChannelFileCmd)
+    pulse->SetChannelFilename(NewValue);
+  else if (command == SetTemplateFileCmd)
+    pulse->SetTemplateFilename(NewValue);
+  else if (command == SetNoiseFileCmd)
+    pulse->SetNoiseFilename(NewValue);
+  else if (command == SetTimeBinCmd)
+    pulse->SetTimeBins(SetTimeBinCmd->ConvertToInt(NewValue));
+  else if (command == SetUnitTimeCmd)
+    pulse->SetUnitTime(SetUnitTimeCmd->ConvertToDimensionedDouble(NewValue));
+  else if (command == SetPreTrigCmd)
+    pulse->SetPreTrig(SetPreTrigCmd->ConvertToDimensionedDouble(NewValue));
+  else if (command == SetRiseTimeCmd)
+    pulse->SetRiseTime(SetRiseTimeCmd->ConvertToDimensionedDouble(NewValue));
+  else if (command == SetDecayTimeCmd)
+    pulse->SetDecayTime(SetDecayTimeCmd->ConvertToDimensionedDouble(NewValue));
+  else if (command == SetBatchSizeCmd)
+    pulse->SetBatchSize(SetBatchSizeCmd->ConvertToInt(NewValue));
+  else if (command == UpdateCmd)
+    pulse->Build();
+}
@@ -0,0 +1,626 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+#include "PhononPulseDigitizerModule.hh"
+#include "PhononPulseDigitizerMessenger.hh"
+#include "G4CMPElectrodeHit.hh"
+#include "G4CMPHitBlock.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4VDigitizerModule.hh"
+#include "G4String.hh"
+#include "G4RunManager.hh"
+#include "G4SDManager.hh"
+#include "G4Run.hh"
+#include "G4Event.hh"
+#include "Randomize.hh"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <sstream>
+#include <stdint.h>
+
+namespace {
+  const char traceMagic[8] = { 'G','4','C','M','P','P','H','N' };
+
+  G4bool EndsWith(const G4String& name, const G4String& suffix) {
+    return (name.size() >= suffix.size() &&
+            name.compare(name.size()-suffix.size(), suffix.size(), suffix) == 0);
+  }
+
+  G4bool IsPhonon(const G4String& name) {
+    return name.compare(0, 6, "phonon") == 0;
+  }
+}
+
+PhononPulseDigitizerModule::PhononPulseDigitizerModule(G4String modName) :
+  G4VDigitizerModule(modName), messenger(new PhononPulseDigitizerMessenger(this)),
+  dt(1.6e-6*s), preTrig(1024*1.6e-6*s), riseTime(20e-6*s), decayTime(200e-6*s),
+  numChannels(1), timeBins(4096), batchSize(64), enabledForSD(false),
+  rebuildChannels(true), rebuildTemplates(true), rebuildNoise(true),
+  binaryOutput(false), outputFilename("PhononPulses"), channelFilename(""),
+  templateFilename(""), noiseFilename(""), currentSlot(0)
+{}
+
+PhononPulseDigitizerModule::PhononPulseDigitizerModule() :
+  G4VDigitizerModule("NoSim"), messenger(nullptr),
+  dt(1.6e-6*s), preTrig(1024*1.6e-6*s), riseTime(20e-6*s), decayTime(200e-6*s),
+  numChannels(1), timeBins(4096), batchSize(64), enabledForSD(false),
+  rebuildChannels(true), rebuildTemplates(true), rebuildNoise(true),
+  binaryOutput(false), outputFilename("PhononPulses"), channelFilename(""),
+  templateFilename(""), noiseFilename(""), currentSlot(0)
+{}
+
+PhononPulseDigitizerModule::~PhononPulseDigitizerModule()
+{
+  ProcessBatch();
+  delete messenger;
+  if (outputFile.is_open()) outputFile.close();
+  if (!outputFile.good()) {
+    G4ExceptionDescription msg;
+    msg << "Error closing output file, " << outputFilename << ".\n"
+        << "Expect bad things like loss of data.";
+    G4Exception("PhononPulseDigitizerModule::~PhononPulseDigitizerModule",
+                "Phonon005", FatalException, msg);
+  }
+}
+
+void PhononPulseDigitizerModule::Build()
+{
+  ProcessBatch();       // Finish events made with previous configuration
+
+  SetOutputFile(outputFilename);
+  if (rebuildChannels)
+    ReadChannelFile();
+  if (rebuildTemplates)
+    BuildTemplates();
+  if (rebuildNoise)
+    ReadNoiseFile();
+}
+
+void PhononPulseDigitizerModule::Digitize()
+{
+  if (!enabledForSD) return;
+  const G4Event* event = G4RunManager::GetRunManager()->GetCurrentEvent();
+  G4HCofThisEvent* HCE = event ? event->GetHCofThisEvent() : nullptr;
+  if (!HCE) return;
+
+  G4SDManager* fSDM = G4SDManager::GetSDMpointer();
+  G4int HCID = fSDM->GetCollectionID("G4CMPElectrodeHit");
+  G4CMPElectrodeHitsCollection* hitCol =
+    static_cast<G4CMPElectrodeHitsCollection*>(HCE->GetHC(HCID));
+  if (!hitCol) return;
+
+  G4int runID = G4RunManager::GetRunManager()->GetCurrentRun()->GetRunID();
+  DigitizeHits(*hitCol->GetVector(), runID, event->GetEventID());
+}
+
+void PhononPulseDigitizerModule::DigitizeHits(
+  const vector<G4CMPElectrodeHit*>& hits, G4int RunID, G4int EventID)
+{
+  StartEvent(RunID, EventID);
+  for (const G4CMPElectrodeHit* hit : hits) {
+    if (!IsPhonon(hit->GetParticleName())) continue;
+    AddEnergy(hit->GetFinalPosition(), hit->GetFinalTime(),
+              hit->GetEnergyDeposit()*hit->GetWeight());
+  }
+}
+
+void PhononPulseDigitizerModule::PostProcess(const G4String& fileName)
+{
+  G4bool binaryInput = EndsWith(fileName, ".bin");
+  std::ifstream input(fileName, binaryInput ? std::ios::binary : std::ios::in);
+  if (!input.good()) {
+    G4ExceptionDescription msg;
+    msg << "Error reading data input file from " << fileName;
+    G4Exception("PhononPulseDigitizerModule::PostProcess", "Phonon002",
+                FatalException, msg);
+  }
+
+  if (binaryInput) ReadBinaryHits(input);
+  else ReadCSVHits(input);
+}
+
+// Hits are collected by (run, event), then processed once file is read
+
+void PhononPulseDigitizerModule::ReadCSVHits(std::istream& input)
+{
+  G4double value[11];   // Numeric columns after particle name
+  G4String particleName;
+  G4int RunID = -1, EventID = -1;
+
+  G4String line;
+  G4String entry;
+  std::getline(input, line); //Grab column headers first
+  while (!std::getline(input, line).eof()) {
+    std::istringstream ssLine(line);
+
+    std::getline(ssLine,entry,',');
+    std::istringstream(entry) >> RunID;
+
+    std::getline(ssLine,entry,',');
+    std::istringstream(entry) >> EventID;
+
+    std::getline(ssLine,entry,',');     // Track ID
+
+    std::getline(ssLine,entry,',');
+    std::istringstream(entry) >> particleName;
+    if (!IsPhonon(particleName)) continue;
+
+    // Columns: E, start(x,y,z), start time, EDep, weight, final(x,y,z,t)
+    for (size_t i=0; i<11; ++i) {
+      std::getline(ssLine,entry,',');
+      std::istringstream(entry) >> value[i];
+    }
+
+    CollectHit(RunID, EventID,
+               G4ThreeVector(value[7], value[8], value[9])*m, value[10]*ns,
+               value[5]*value[6]*eV);
+  }
+
+  ProcessCollected();
+}
+
+void PhononPulseDigitizerModule::ReadBinaryHits(std::istream& input)
+{
+  if (!G4CMPHitBlock::ReadHeader(input)) {
+    G4Exception("PhononPulseDigitizerModule::ReadBinaryHits", "Phonon008",
+                FatalException, "Input is not a G4CMP binary hit file.");
+    return;
+  }
+
+  G4CMPHitBlock block;
+  while (input.peek() != EOF && block.Read(input)) {
+    for (size_t i=0; i<block.Size(); ++i) {
+      if (!IsPhonon(block.GetParticleName(i))) continue;
+
+      CollectHit(block.runID[i], block.eventID[i],
+                 G4ThreeVector(block.finalX[i], block.finalY[i],
+                               block.finalZ[i])*m, block.finalTime[i]*ns,
+                 block.EDep[i]*block.weight[i]*eV);
+    }
+  }
+
+  ProcessCollected();
+}
+
+void PhononPulseDigitizerModule::CollectHit(G4int RunID, G4int EventID,
+                                            const G4ThreeVector& position,
+                                            G4double time, G4double energy)
+{
+  EventHits& event = collected[std::make_pair(RunID, EventID)];
+  event.positions.push_back(position);
+  event.times.push_back(time);
+  event.energies.push_back(energy);
+}
+
+// Events are binned in (run, event) order, each one complete, so only the
+// trace processing is batched; hits are released as they go
+
+void PhononPulseDigitizerModule::ProcessCollected()
+{
+  for (auto& event : collected) {
+    EventHits& hits = event.second;
+    StartEvent(event.first.first, event.first.second);
+    for (size_t i=0; i<hits.energies.size(); ++i)
+      AddEnergy(hits.positions[i], hits.times[i], hits.energies[i]);
+
+    vector<G4ThreeVector>().swap(hits.positions);
+    vector<G4double>().swap(hits.times);
+    vector<G4double>().swap(hits.energies);
+  }
+
+  collected.clear();
+  ProcessBatch();
+}
+
+// New event is added to batch; full batch is processed first.  An event
+// already in the batch is reused.
+
+void PhononPulseDigitizerModule::StartEvent(G4int RunID, G4int EventID)
+{
+  if (rebuildChannels || rebuildTemplates || rebuildNoise) Build();
+
+  std::pair<G4int,G4int> key(RunID, EventID);
+  auto slot = batchSlots.find(key);
+  if (slot != batchSlots.end()) {
+    currentSlot = slot->second;
+    return;
+  }
+
+  if (batchRunIDs.size() >= batchSize) ProcessBatch();
+
+  currentSlot = batchRunIDs.size();
+  batchSlots[key] = currentSlot;
+  batchRunIDs.push_back(RunID);
+  batchEventIDs.push_back(EventID);
+  batchEnergy.resize(batchEnergy.size() + numChannels*timeBins, 0.);
+}
+
+void PhononPulseDigitizerModule::AddEnergy(const G4ThreeVector& position,
+                                           G4double time, G4double energy)
+{
+  if (batchRunIDs.empty() || energy == 0.) return;
+
+  G4double tbin = (time + preTrig)/dt;
+  if (tbin < 0. || tbin >= timeBins) return;   // Outside of trace
+
+  size_t event = currentSlot;
+  size_t chan = std::min(GetChannel(position), numChannels-1);
+  batchEnergy[(event*numChannels + chan)*timeBins + size_t(tbin)] += energy/eV;
+}
+
+size_t PhononPulseDigitizerModule::GetChannel(const G4ThreeVector& position) const
+{
+  size_t nearest = 0;
+  G4double dist2 = DBL_MAX;
+  for (size_t chan=0; chan<channelPositions.size(); ++chan) {
+    G4double d2 = (position - channelPositions[chan]).mag2();
+    if (d2 < dist2) {
+      dist2 = d2;
+      nearest = chan;
+    }
+  }
+  return nearest;
+}
+
+void PhononPulseDigitizerModule::ProcessBatch()
+{
+  if (batchRunIDs.empty()) return;
+
+  for (size_t event=0; event<batchRunIDs.size(); ++event) {
+    traces.assign(numChannels*timeBins, 0.);
+    for (size_t chan=0; chan<numChannels; chan += 2)
+      CalculateTraces(event, chan, chan+1);
+
+    WriteTraces(batchRunIDs[event], batchEventIDs[event]);
+  }
+
+  batchRunIDs.clear();
+  batchEventIDs.clear();
+  batchEnergy.clear();
+  batchSlots.clear();
+}
+
+// Two real channels are transformed together, as real and imaginary
+// parts, and separated in frequency space.  Output of both convolutions
+// (and of noise) is real, so inverse transform gives both traces at once.
+
+void PhononPulseDigitizerModule::CalculateTraces(size_t event, size_t chanA,
+                                                 size_t chanB)
+{
+  const size_t N = fft.GetSize();
+  const G4bool useB = (chanB < numChannels);
+
+  const G4double* energyA = &batchEnergy[(event*numChannels + chanA)*timeBins];
+  const G4double* energyB = useB ? energyA + timeBins : nullptr;
+
+  spectrum.assign(N, SensorFFT::Complex(0.,0.));
+  for (size_t bin=0; bin<timeBins; ++bin) {
+    spectrum[bin] = SensorFFT::Complex(energyA[bin], useB ? energyB[bin] : 0.);
+  }
+
+  fft.Forward(spectrum);
+
+  const vector<SensorFFT::Complex>& tmplA = templateSpectra[chanA];
+  const vector<SensorFFT::Complex>& tmplB = templateSpectra[useB ? chanB : chanA];
+  const SensorFFT::Complex i(0.,1.);
+  for (size_t k=0; k<=N/2; ++k) {
+    size_t j = (N-k) % N;
+    SensorFFT::Complex zk = spectrum[k], zj = spectrum[j];
+    SensorFFT::Complex Ak = 0.5*(zk + std::conj(zj));
+    SensorFFT::Complex Bk = -0.5*i*(zk - std::conj(zj));
+    spectrum[k] = Ak*tmplA[k] + i*Bk*tmplB[k];
+    spectrum[j] = std::conj(Ak)*tmplA[j] + i*std::conj(Bk)*tmplB[j];
+  }
+
+  if (!noiseAmplitude.empty()) AddNoise(chanA, useB ? chanB : numChannels);
+
+  fft.Inverse(spectrum);
+
+  for (size_t bin=0; bin<timeBins; ++bin) {
+    traces[chanA*timeBins + bin] = spectrum[bin].real();
+    if (useB) traces[chanB*timeBins + bin] = spectrum[bin].imag();
+  }
+}
+
+// Gaussian noise in each frequency bin, with variance set by PSD, and
+// Hermitian symmetry so that the noise is real
+
+void PhononPulseDigitizerModule::AddNoise(size_t chanA, size_t chanB)
+{
+  const size_t N = fft.GetSize();
+  const G4bool useB = (chanB < numChannels);
+  const SensorFFT::Complex i(0.,1.);
+
+  for (size_t k=0; k<=N/2; ++k) {
+    G4bool realOnly = (k == 0 || k == N/2);
+    G4double scale = realOnly ? 1. : std::sqrt(0.5);
+
+    G4double ampA = noiseAmplitude[chanA][k] * scale;
+    SensorFFT::Complex noiseA(ampA*G4RandGauss::shoot(),
+                              realOnly ? 0. : ampA*G4RandGauss::shoot());
+    SensorFFT::Complex noiseB(0.,0.);
+    if (useB) {
+      G4double ampB = noiseAmplitude[chanB][k] * scale;
+      noiseB = SensorFFT::Complex(ampB*G4RandGauss::shoot(),
+                                  realOnly ? 0. : ampB*G4RandGauss::shoot());
+    }
+
+    spectrum[k] += noiseA + i*noiseB;
+    if (!realOnly) spectrum[N-k] += std::conj(noiseA) + i*std::conj(noiseB);
+  }
+}
+
+void PhononPulseDigitizerModule::ReadChannelFile()
+{
+  channelPositions.clear();
+  if (!channelFilename.empty()) {
+    std::ifstream channelFile(channelFilename);
+    if (!channelFile.good()) {
+      G4ExceptionDescription msg;
+      msg << "Error reading channel file from " << channelFilename << ".\n"
+          << "Using a single channel.";
+      G4Exception("PhononPulseDigitizerModule::ReadChannelFile", "Phonon001",
+                  JustWarning, msg);
+    }
+
+    G4double x, y, z;
+    while (channelFile >> x >> y >> z)
+      channelPositions.push_back(G4ThreeVector(x, y, z)*mm);
+  }
+
+  size_t nChan = std::max<size_t>(channelPositions.size(), 1);
+  if (nChan != numChannels) {
+    numChannels = nChan;
+    rebuildTemplates = true;
+    rebuildNoise = true;
+  }
+  rebuildChannels = false;
+}
+
+void PhononPulseDigitizerModule::BuildTemplates()
+{
+  // Linear convolution of two traces fits in twice the trace length
+  fft.SetSize(SensorFFT::PowerOfTwo(2*timeBins));
+
+  vector<G4double> pulses(numChannels*timeBins, 0.);
+
+  std::ifstream templateFile;
+  if (!templateFilename.empty()) templateFile.open(templateFilename);
+  if (templateFile.is_open() && templateFile.good()) {
+    for (size_t k=0; k<pulses.size(); ++k)
+      templateFile >> pulses[k];
+  } else {
+    if (!templateFilename.empty()) {
+      G4Exception("PhononPulseDigitizerModule::BuildTemplates", "Phonon007",
+                  JustWarning,
+        "Reading from template file failed. Using default pulse templates.");
+    }
+
+    G4double peak = 0.;
+    for (size_t k=0; k<timeBins; ++k) {
+      G4double t = k*dt;
+      pulses[k] = exp(-t/decayTime) - exp(-t/riseTime);
+      peak = std::max(peak, pulses[k]);
+    }
+
+    // Rise and decay may be set in either order, so only check them here
+    if (!(peak > 0.)) {
+      G4ExceptionDescription msg;
+      msg << "Default pulse with rise time " << riseTime/us << " us and"
+          << " decay time " << decayTime/us << " us has no positive peak"
+          << " within " << timeBins << " bins.\n"
+          << "Rise time must be shorter than decay time.";
+      G4Exception("PhononPulseDigitizerModule::BuildTemplates", "Phonon009",
+                  FatalException, msg);
+      return;
+    }
+
+    for (size_t k=0; k<timeBins; ++k) pulses[k] /= peak;
+    for (size_t i=1; i<numChannels; ++i)
+      std::copy(pulses.begin(), pulses.begin()+timeBins,
+                pulses.begin()+i*timeBins);
+  }
+
+  templateSpectra.assign(numChannels, vector<SensorFFT::Complex>());
+  for (size_t i=0; i<numChannels; ++i) {
+    vector<SensorFFT::Complex>& tmpl = templateSpectra[i];
+    tmpl.assign(fft.GetSize(), SensorFFT::Complex(0.,0.));
+    for (size_t k=0; k<timeBins; ++k) tmpl[k] = pulses[i*timeBins+k];
+    fft.Forward(tmpl);
+  }
+
+  rebuildTemplates = false;
+  rebuildNoise = true;                  // Frequency bins may have changed
+}
+
+// PSD is interpolated to FFT frequencies, and converted to amplitude of
+// each frequency bin for a transform of length N
+
+void PhononPulseDigitizerModule::ReadNoiseFile()
+{
+  noiseAmplitude.clear();
+  rebuildNoise = false;
+  if (noiseFilename.empty()) return;
+
+  std::ifstream noiseFile(noiseFilename);
+  if (!noiseFile.good()) {
+    G4ExceptionDescription msg;
+    msg << "Error reading noise PSD file from " << noiseFilename << ".\n"
+        << "No noise will be added.";
+    G4Exception("PhononPulseDigitizerModule::ReadNoiseFile", "Phonon003",
+                JustWarning, msg);
+    return;
+  }
+
+  vector<G4double> freq;
+  vector<vector<G4double> > psd;
+  G4String line;
+  while (std::getline(noiseFile, line)) {
+    if (line.empty() || line[0] == '#') continue;
+    std::istringstream ssLine(line);
+
+    G4double f, S;
+    if (!(ssLine >> f)) continue;
+    freq.push_back(f);
+    psd.push_back(vector<G4double>());
+    while (ssLine >> S) psd.back().push_back(S);
+  }
+
+  size_t nCols = psd.empty() ? 0 : psd.front().size();
+  for (const vector<G4double>& row : psd) nCols = std::min(nCols, row.size());
+  if (nCols != 1 && nCols < numChannels) {
+    G4ExceptionDescription msg;
+    msg << "Noise PSD file " << noiseFilename << " has " << nCols
+        << " columns for " << numChannels << " channels.\n"
+        << "No noise will be added.";
+    G4Exception("PhononPulseDigitizerModule::ReadNoiseFile", "Phonon004",
+                JustWarning, msg);
+    return;
+  }
+
+  const size_t N = fft.GetSize();
+  const G4double fs = 1./(dt/s);
+  noiseAmplitude.assign(numChannels, vector<G4double>(N/2+1, 0.));
+  for (size_t k=0; k<=N/2; ++k) {
+    G4double f = k*fs/N;
+    size_t hi = std::lower_bound(freq.begin(), freq.end(), f) - freq.begin();
+    size_t lo = (hi > 0 ? hi-1 : 0);
+    if (hi >= freq.size()) hi = lo = freq.size()-1;
+    G4double frac = (hi > lo) ? (f-freq[lo])/(freq[hi]-freq[lo]) : 0.;
+
+    for (size_t chan=0; chan<numChannels; ++chan) {
+      size_t col = (nCols == 1) ? 0 : chan;
+      G4double S = psd[lo][col] + frac*(psd[hi][col]-psd[lo][col]);
+      noiseAmplitude[chan][k] = std::sqrt(std::max(S, 0.)*N*fs/2.);
+    }
+  }
+}
+
+void PhononPulseDigitizerModule::WriteTraces(G4int RunID, G4int EventID)
+{
+  if (binaryOutput) {
+    traceOutput.assign(traces.begin(), traces.end());
+
+    int32_t ids[2] = { RunID, EventID };
+    uint32_t sizes[2] = { static_cast<uint32_t>(numChannels),
+                          static_cast<uint32_t>(timeBins) };
+    outputFile.write(reinterpret_cast<const char*>(ids), sizeof(ids));
+    outputFile.write(reinterpret_cast<const char*>(sizes), sizeof(sizes));
+    outputFile.write(reinterpret_cast<const char*>(traceOutput.data()),
+                     traceOutput.size()*sizeof(float));
+    return;
+  }
+
+  for(size_t chan = 0; chan < numChannels; ++chan) {
+    const G4double* trace = &traces[chan*timeBins];
+    outputFile << RunID << "," << EventID << "," << chan+1 << ",";
+    for(size_t bin = 0; bin < timeBins-1; ++bin) {
+      outputFile << trace[bin] << ",";
+    }
+    outputFile << trace[timeBins-1] << "\n";
+  }
+}
+
+void PhononPulseDigitizerModule::EnablePhononSim()
+{
+  enabledForSD = true;
+  if (templateSpectra.empty()) { // Need to initiate first build.
+    Build();
+  }
+}
+
+void PhononPulseDigitizerModule::DisablePhononSim()
+{
+  ProcessBatch();
+  enabledForSD = false;
+}
+
+void PhononPulseDigitizerModule::SetOutputFile(const G4String& fn)
+{
+  if (outputFilename != fn || !outputFile.is_open()) {
+    ProcessBatch();
+    if (outputFile.is_open()) outputFile.close();
+    outputFilename = fn;
+    binaryOutput = EndsWith(outputFilename, ".bin");
+    outputFile.open(outputFilename, binaryOutput ?
+                    std::ios_base::app|std::ios_base::binary : std::ios_base::app);
+    if (!outputFile.good()) {
+      G4ExceptionDescription msg;
+      msg << "Error opening output file, " << outputFilename << ".\n"
+          << "Will continue simulation.";
+      G4Exception("PhononPulseDigitizerModule::SetOutputFile", "Phonon006",
+                  JustWarning, msg);
+      outputFile.close();
+    } else if (binaryOutput) {
+      outputFile.seekp(0, std::ios_base::end);
+      if (outputFile.tellp() == std::streampos(0))
+        outputFile.write(traceMagic, sizeof(traceMagic));
+    } else {
+      outputFile << "Run ID,Event ID,Channel,Pulse (" << timeBins << " bins)"
+                 << G4endl;
+    }
+  }
+}
+
+void PhononPulseDigitizerModule::SetChannelFilename(const G4String& name)
+{
+  if (channelFilename == name) return;
+  channelFilename = name;
+  rebuildChannels = true;
+}
+
+void PhononPulseDigitizerModule::SetTemplateFilename(const G4String& name)
+{
+  if (templateFilename == name) return;
+  templateFilename = name;
+  rebuildTemplates = true;
+}
+
+void PhononPulseDigitizerModule::SetNoiseFilename(const G4String& name)
+{
+  if (noiseFilename == name) return;
+  noiseFilename = name;
+  rebuildNoise = true;
+}
+
+void PhononPulseDigitizerModule::SetTimeBins(size_t n)
+{
+  if (timeBins == n) return;
+  ProcessBatch();
+  timeBins = n;
+  rebuildTemplates = true;
+}
+
+void PhononPulseDigitizerModule::SetUnitTime(G4double n)
+{
+  if (dt == n) return;
+  ProcessBatch();
+  dt = n;
+  rebuildTemplates = true;
+}
+
+void PhononPulseDigitizerModule::SetPreTrig(G4double n)
+{
+  if (preTrig == n) return;
+  ProcessBatch();
+  preTrig = n;
+}
+
+void PhononPulseDigitizerModule::SetRiseTime(G4double n)
+{
+  if (riseTime == n) return;
+  ProcessBatch();
+  riseTime = n;
+  rebuildTemplates = true;
+}
+
+void PhononPulseDigitizerModule::SetDecayTime(G4double n)
+{
+  if (decayTime == n) return;
+  ProcessBatch();
+  decayTime = n;
+  rebuildTemplates = true;
+}
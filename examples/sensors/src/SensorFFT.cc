@@ -0,0 +1,78 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+#include "SensorFFT.hh"
+#include "G4Exception.hh"
+#include "G4PhysicalConstants.hh"
+#include <cmath>
+#include <utility>
+
+size_t SensorFFT::PowerOfTwo(size_t n)
+{
+  size_t p = 1;
+  while (p < n) p <<= 1;
+  return p;
+}
+
+void SensorFFT::SetSize(size_t n)
+{
+  if (n > 0 && n != PowerOfTwo(n)) {
+    G4ExceptionDescription msg;
+    msg << "FFT length " << n << " is not a power of two.";
+    G4Exception("SensorFFT::SetSize", "Sensor001", FatalErrorInArgument, msg);
+  }
+
+  size = n;
+  bitReverse.resize(n);
+  twiddle.resize(n/2);
+
+  size_t nbits = 0;
+  while ((size_t(1) << nbits) < n) ++nbits;
+
+  for (size_t i=0; i<n; ++i) {
+    size_t r = 0;
+    for (size_t b=0; b<nbits; ++b)
+      if (i & (size_t(1) << b)) r |= size_t(1) << (nbits-1-b);
+    bitReverse[i] = r;
+  }
+
+  for (size_t k=0; k<n/2; ++k)
+    twiddle[k] = std::polar(1., -twopi*k/n);
+}
+
+// Iterative Cooley-Tukey; the inverse uses conjugate twiddles
+
+void SensorFFT::Transform(std::vector<Complex>& data, G4bool inverse) const
+{
+  if (data.size() != size) {
+    G4ExceptionDescription msg;
+    msg << "Data length " << data.size() << " does not match FFT length "
+        << size;
+    G4Exception("SensorFFT::Transform", "Sensor002", FatalErrorInArgument,
+                msg);
+    return;
+  }
+
+  for (size_t i=0; i<size; ++i)
+    if (i < bitReverse[i]) std::swap(data[i], data[bitReverse[i]]);
+
+  for (size_t len=2; len<=size; len <<= 1) {
+    const size_t half = len/2;
+    const size_t step = size/len;
+    for (size_t start=0; start<size; start += len) {
+      for (size_t k=0; k<half; ++k) {
+        Complex w = inverse ? std::conj(twiddle[k*step]) : twiddle[k*step];
+        Complex t = w*data[start+k+half];
+        data[start+k+half] = data[start+k] - t;
+        data[start+k] += t;
+      }
+    }
+  }
+
+  if (inverse) {
+    const G4double norm = 1./size;
+    for (Complex& v : data) v *= norm;
+  }
+}
@@ -13,6 +13,7 @@
 //             Add "quiet" argument to MatInv to suppress warnings.
 // 20200908  Replace four-arg ctor and UseMesh() with copy constructor.
 // 20200914  Include gradient precalculation in BuildTInverse action.
+// 20261017  Take over V, Grad and UseValues() from base class.
 
 #ifndef G4CMPBiLinearInterp_h 
 #define G4CMPBiLinearInterp_h 
@@ -57,6 +58,9 @@ public:
   void UseMesh(const std::vector<point3d>& xyz, const std::vector<G4double>& v,
 	       const std::vector<tetra3d>& tetra);
 
+  // Replace values at mesh points without rebuilding tables
+  void UseValues(const std::vector<G4double>& v);
+
   // Evaluate mesh at arbitrary location, optionally suppressing errors
   G4double GetValue(const G4double pos[], G4bool quiet=false) const;
   G4ThreeVector GetGrad(const G4double pos[], G4bool quiet=false) const;
@@ -69,6 +73,8 @@ protected:
 
 private:
   std::vector<point2d> X;
+  std::vector<G4double> V;		// Values at mesh points
+  std::vector<G4ThreeVector> Grad;	// Gradients across tetrahedra
   std::vector<tetra2d> Tetrahedra;	// For 2D, these are triangles!
   std::vector<tetra2d> Neighbors;
   std::vector<mat2x2> TInverse;		// Matrix for barycenter calculation
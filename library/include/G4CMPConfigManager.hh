@@ -46,12 +46,21 @@
 // 20220921  G4CMP-319:  Add temperature setting for use with QP sensors.
 // 20221117  G4CMP-343:  Add option flag to preserve all internal phonons.
 // 20240506  G4CMP-371:  Add flag to keep or discard below-minimum track energy.
+// 20261017  Add flag to enable grid index for mesh field lookups.
+// 20261017  Add flag to save and reuse binary mesh field tables.
+// 20261017  Add parameter to resample mesh fields onto a regular grid.
+// 20261017  Add directory for cached phonon kinematics tables.
+// 20261017  Add flag to use precomputed film response in KaplanQP.
+// 20261017  Add phonon importance map and ratio for weight-window process.
+// 20261017  Add flag to tabulate scattering rate models.
+// 20261017  Mesh cache setting may name a directory for cache files.
 
 #include "globals.hh"
 #include <iosfwd>
 
 class G4CMPConfigMessenger;
 class G4VNIELPartition;
+class G4CMPVPhononImportance;
 
 
 class G4CMPConfigManager {
@@ -76,6 +85,8 @@ public:
   static G4bool UseKVSolver()            { return Instance()->useKVsolver; }
   static G4bool FanoStatisticsEnabled()  { return Instance()->fanoEnabled; }
   static G4bool KeepKaplanPhonons()      { return Instance()->kaplanKeepPh; }
+  static G4bool UseKaplanFastMode()      { return Instance()->kaplanFast; }
+  static G4bool UseRateTables()          { return Instance()->rateTables; }
   static G4bool CreateChargeCloud()      { return Instance()->chargeCloud; }
   static G4bool RecordMinETracks()       { return Instance()->recordMinE; }
   static G4double GetSurfaceClearance()  { return Instance()->clearance; }
@@ -94,11 +105,18 @@ public:
   static G4double GetHDTrapIonMFP()      { return Instance()->hDTrapIonMFP; }
   static G4double GetHATrapIonMFP()      { return Instance()->hATrapIonMFP; }
   static G4double GetTemperature()       { return Instance()->temperature; }
+  static G4bool UseMeshIndex()           { return Instance()->meshIndex; }
+  static G4bool UseMeshCache()           { return Instance()->meshCache; }
+  static G4double GetMeshGridStep()      { return Instance()->meshGridStep; }
+  static G4double GetImportanceRatio()   { return Instance()->importanceRatio; }
 
   static const G4String& GetLatticeDir() { return Instance()->LatticeDir; }
   static const G4String& GetIVRateModel() { return Instance()->IVRateModel; }
+  static const G4String& GetKinCacheDir() { return Instance()->kinCacheDir; }
+  static const G4String& GetMeshCacheDir() { return Instance()->meshCacheDir; }
 
   static const G4VNIELPartition* GetNIELPartition() { return Instance()->nielPartition; }
+  static const G4CMPVPhononImportance* GetPhononImportance() { return Instance()->phononImportance; }
 
   // Change values (e.g., via Messenger) -- pass strings by value for toLower()
   static void SetVerboseLevel(G4int value) { Instance()->verbose = value; }
@@ -118,8 +136,16 @@ public:
   static void UseKVSolver(G4bool value) { Instance()->useKVsolver = value; }
   static void EnableFanoStatistics(G4bool value) { Instance()->fanoEnabled = value; }
   static void KeepKaplanPhonons(G4bool value) { Instance()->kaplanKeepPh = value; }
+  static void UseKaplanFastMode(G4bool value) { Instance()->kaplanFast = value; }
+  static void UseRateTables(G4bool value) { Instance()->rateTables = value; }
   static void SetIVRateModel(G4String value) { Instance()->IVRateModel = value; }
   static void CreateChargeCloud(G4bool value) { Instance()->chargeCloud = value; }
+  static void UseMeshIndex(G4bool value) { Instance()->meshIndex = value; }
+  static void UseMeshCache(G4bool value) { Instance()->meshCache = value; }
+  static void SetMeshCache(const G4String& value) { Instance()->setMeshCache(value); }
+  static void SetMeshGridStep(G4double value) { Instance()->meshGridStep = value; }
+  static void SetImportanceRatio(G4double value) { Instance()->importanceRatio = value; }
+  static void SetKinCacheDir(const G4String& dir) { Instance()->kinCacheDir = dir; }
 
   static void SetETrappingMFP(G4double value) { Instance()->eTrapMFP = value; }
   static void SetHTrappingMFP(G4double value) { Instance()->hTrapMFP = value; }
@@ -132,6 +158,10 @@ public:
   static void SetNIELPartition(const G4String& value) { Instance()->setNIEL(value); }
   static void SetNIELPartition(G4VNIELPartition* niel) { Instance()->setNIEL(niel); }
 
+  // NOTE:  Importance map is not owned; must persist through end of job
+  static void SetPhononImportance(const G4CMPVPhononImportance* imp)
+  { Instance()->phononImportance = imp; }
+
   // These settings require the geometry to be rebuilt
   static void SetLatticeDir(const G4String& dir)
   { Instance()->LatticeDir=dir; UpdateGeometry(); }
@@ -158,6 +188,9 @@ private:
   void setNIEL(G4String value);
   void setNIEL(G4VNIELPartition* niel);
 
+  // Flag value enables or disables mesh cache; anything else is directory
+  void setMeshCache(const G4String& value);
+
 private:
   G4int verbose;	 // Global verbosity (all processes, lattices)
   G4int fPhysicsModelID; // ID key to get aux. track info.
@@ -167,6 +200,8 @@ private:
   G4String version;	// Version name string extracted from .g4cmp-version
   G4String LatticeDir;	// Lattice data directory ($G4LATTICEDATA)
   G4String IVRateModel;	// Model for IV rate ($G4CMP_IV_RATE_MODEL)
+  G4String kinCacheDir;	// Phonon kinematics table cache ($G4CMP_KIN_CACHE)
+  G4String meshCacheDir; // Mesh table cache, or beside input ($G4CMP_MESH_CACHE)
   G4double eTrapMFP;	// Mean free path for electron trapping
   G4double hTrapMFP;	// Mean free path for hole trapping
   G4double eDTrapIonMFP; // Mean free path for e- on e-trap ionization ($G4CMP_EETRAPION_MFP)
@@ -186,9 +221,16 @@ private:
   G4bool useKVsolver;	 // Use K-Vg eigensolver ($G4CMP_USE_KVSOLVER)
   G4bool fanoEnabled;	 // Apply Fano statistics to ionization energy deposits ($G4CMP_FANO_ENABLED)
   G4bool kaplanKeepPh;   // Emit or iterate over all phonons in KaplanQP ($G4CMP_KAPLAN_KEEP)
+  G4bool kaplanFast;     // Use tabulated film response in KaplanQP ($G4CMP_KAPLAN_FAST)
+  G4bool rateTables;     // Interpolate scattering rates from tables ($G4CMP_RATE_TABLES)
   G4bool chargeCloud;    // Produce e/h pairs around position ($G4CMP_CHARGE_CLOUD) 
   G4bool recordMinE;     // Store below-minimum track energy as NIEL when killed
+  G4bool meshIndex;      // Grid index to seed field mesh searches ($G4CMP_MESH_INDEX)
+  G4bool meshCache;      // Reuse binary mesh tables ($G4CMP_MESH_CACHE)
+  G4double meshGridStep;  // Resampling grid spacing ($G4CMP_MESH_GRID)
+  G4double importanceRatio; // Importance change to split/roulette ($G4CMP_IMPORTANCE_RATIO)
   G4VNIELPartition* nielPartition; // Function class to compute non-ionizing ($G4CMP_NIEL_FUNCTION)
+  const G4CMPVPhononImportance* phononImportance; // Map for phonon weight window
 
   G4CMPConfigMessenger* messenger;	// User interface (UI) commands
 };
@@ -43,6 +43,14 @@
 // 20220921  G4CMP-319:  Add temperature setting for use with QP sensors.
 // 20221117  G4CMP-343:  Add option flag to preserve all internal phonons.
 // 20240506  G4CMP-371:  Add flag to keep or discard below-minimum track energy.
+// 20261017  Add flag to enable grid index for mesh field lookups.
+// 20261017  Add flag to save and reuse binary mesh field tables.
+// 20261017  Add parameter to resample mesh fields onto a regular grid.
+// 20261017  Add directory for cached phonon kinematics tables.
+// 20261017  Add flag to use precomputed film response in KaplanQP.
+// 20261017  Add importance ratio for phonon weight window.
+// 20261017  Add flag to tabulate scattering rate models.
+// 20261017  Mesh cache command takes flag or directory name.
 
 #include "G4UImessenger.hh"
 
@@ -96,6 +104,13 @@ private:
   G4UIcmdWithABool*   kaplanKeepCmd;
   G4UIcmdWithABool*   ehCloudCmd;
   G4UIcmdWithABool*   recordMinECmd;
+  G4UIcmdWithABool*   meshIndexCmd;
+  G4UIcmdWithAString* meshCacheCmd;
+  G4UIcmdWithADoubleAndUnit*  meshGridCmd;
+  G4UIcmdWithAString* kinCacheCmd;
+  G4UIcmdWithABool*   kaplanFastCmd;
+  G4UIcmdWithADouble* importanceCmd;
+  G4UIcmdWithABool*   rateTablesCmd;
 
 private:
   G4CMPConfigMessenger(const G4CMPConfigMessenger&);	// Copying is forbidden
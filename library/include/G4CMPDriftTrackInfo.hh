@@ -12,32 +12,23 @@
 // $Id$
 //
 // 20161111 Initial commit - R. Agnese
+// 20261017 Use thread-local G4Allocator, with large pages, for track info
+// 20261017 Guard operator delete against missing thread-local allocator
 
 #ifndef G4CMPDriftTrackInfo_hh
 #define G4CMPDriftTrackInfo_hh 1
 
 #include "G4CMPVTrackInfo.hh"
-/*
 #include "G4Allocator.hh"
 
-class G4CMPDriftTrackInfo;
-
-extern G4Allocator<G4CMPDriftTrackInfo> G4CMPDriftTrackInfoAllocator;
-*/
-
 class G4CMPDriftTrackInfo: public G4CMPVTrackInfo {
 public:
   G4CMPDriftTrackInfo() = delete;
   G4CMPDriftTrackInfo(const G4LatticePhysical* lat, G4int valIdx);
 
-/*
-  void *operator new(size_t) noexcept {
-    return static_cast<void*>(G4CMPDriftTrackInfoAllocator.MallocSingle());
-  }
-  void operator delete(void* info) noexcept {
-    G4CMPDriftTrackInfoAllocator.FreeSingle(static_cast<G4CMPDriftTrackInfo*>(info));
-  }
-*/
+  // Memory allocation using thread-local G4Allocator; implemented below
+  inline void* operator new(size_t size);
+  inline void  operator delete(void* info, size_t size);
 
   G4int ValleyIndex() const                                { return valleyIdx; }
   void SetValleyIndex(G4int valIdx);
@@ -48,4 +39,29 @@ private:
   G4int valleyIdx;
 };
 
+
+// Pooled memory reused from track to track and event to event
+
+extern G4ThreadLocal G4Allocator<G4CMPDriftTrackInfo>* G4CMPDriftTrackInfoAllocator;
+
+// Derived classes have different size; fall back to normal allocation
+
+inline void* G4CMPDriftTrackInfo::operator new(size_t size) {
+  if (size != sizeof(G4CMPDriftTrackInfo)) return ::operator new(size);
+
+  if (!G4CMPDriftTrackInfoAllocator) {
+    G4CMPDriftTrackInfoAllocator = new G4Allocator<G4CMPDriftTrackInfo>;
+    G4CMPDriftTrackInfoAllocator->IncreasePageSize(16);	// Millions per event
+  }
+  return (void*)G4CMPDriftTrackInfoAllocator->MallocSingle();
+}
+
+// Without a pool in this thread, object was not allocated from one
+
+inline void G4CMPDriftTrackInfo::operator delete(void* info, size_t size) {
+  if (size != sizeof(G4CMPDriftTrackInfo) || !G4CMPDriftTrackInfoAllocator)
+    ::operator delete(info);
+  else G4CMPDriftTrackInfoAllocator->FreeSingle((G4CMPDriftTrackInfo*)info);
+}
+
 #endif
@@ -0,0 +1,38 @@
+//  G4CMPEigenSolver3x3.hh
+//
+//  Eigensystem of a real symmetric 3x3 matrix, using fixed-size arrays.
+//  Replaces the general Numerical Recipes solver (G4CMPEigenSolver) for
+//  the Christoffel matrix, where it is called for every new phonon
+//  direction.  The closed form (trigonometric) solution is used when the
+//  eigenvalues are well separated.  Otherwise, as for transverse modes
+//  near symmetry axes, cyclic Jacobi rotations are used, which give
+//  accurate eigenvectors for degenerate eigenvalues.  Results follow
+//  G4CMPEigenSolver:  eigenvalues in d[] sorted in descending order, with
+//  corresponding eigenvectors in columns of z.
+//
+//  20261017  New class, for use with G4CMPPhononKinematics
+
+#ifndef _G4CMPEigenSolver3x3_hh
+#define _G4CMPEigenSolver3x3_hh
+
+#include "G4Types.hh"
+
+struct G4CMPEigenSolver3x3 {
+  double z[3][3];		// Eigenvectors in columns
+  double d[3];			// Eigenvalues, largest first
+
+  G4CMPEigenSolver3x3() : z{{1.,0.,0.},{0.,1.,0.},{0.,0.,1.}}, d{0.,0.,0.} {;}
+
+  explicit G4CMPEigenSolver3x3(const double a[3][3]) { setup(a); }
+
+  // Only upper triangle of a is used
+  void setup(const double a[3][3]);
+
+private:
+  G4bool analytic(const double a[3][3]);	// False if near degenerate
+  void jacobi(double a[3][3]);
+  void rotate(double a[3][3], int p, int q);
+  void sort();
+};
+
+#endif	/* _G4CMPEigenSolver3x3_hh */
@@ -30,6 +30,7 @@
 // 20220816  Add generated track counts, for convenience before filling
 // 20220816  G4CMP-308 -- Support generating multiple primary positions.
 // 20240105  Add UpdateSummary() function to set position and track info
+// 20261017  Add reusable buffer for primaries filled into event.
 
 #ifndef G4CMPEnergyPartition_hh
 #define G4CMPEnergyPartition_hh 1
@@ -191,6 +192,8 @@ protected:
   };
     
   std::vector<Data> particles;	// Combined phonons and charge carriers
+
+  mutable std::vector<G4PrimaryParticle*> primaryBuffer; // For event filling
 };
 
 #endif	/* G4CMPEnergyPartition_hh */
@@ -12,6 +12,8 @@
 // 20170801  Add counter to track instances of null-lattice, for reflections.
 // 20210901  Add local verbosity flag for reporting diagnostics; use instead
 //	     of G4CMP global setting.
+// 20261017  Remember volume, lattice, touchable and valley of previous track
+//	     to skip reconfiguring field for each new track.
 
 #ifndef G4CMPFieldManager_h
 #define G4CMPFieldManager_h 1
@@ -19,6 +21,7 @@
 #include "globals.hh"
 #include "G4FieldManager.hh"
 #include <vector>
+#include <stdint.h>
 
 class G4CMPEqEMField;
 class G4CMPLocalElectroMagField;
@@ -28,6 +31,7 @@ class G4LatticeLogical;
 class G4LatticePhysical;
 class G4MagInt_Driver;
 class G4MagIntegratorStepper;
+class G4VPhysicalVolume;
 
 
 class G4CMPFieldManager : public G4FieldManager {
@@ -61,6 +65,12 @@ private:
   G4int latticeNulls;		// Count consective cases of no lattice
   const G4int maxLatticeNulls;	// Maximum allowed cases (reflection == 2)
 
+  // Configuration for previous track, to skip redundant updates
+  const G4VPhysicalVolume* lastVolume;
+  const G4LatticePhysical* lastLattice;	// Lattice found for lastVolume
+  uintptr_t lastTouchID;		// From G4CMPGlobalLocalTransformStore
+  G4int lastValley;			// -2 to force update
+
   // NOTE: All pointers are kept in order to delete in dtor
   void CreateTransport();
   G4CMPEqEMField* theEqMotion;
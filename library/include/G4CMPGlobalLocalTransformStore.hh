@@ -17,6 +17,8 @@
 // 20161102  Rob Agnese
 // 20170605  Pass touchable from track, not just local PV
 // 20200519  Convert to thread-local singleton (for use by worker threads)
+// 20261017  Expose touchable identifier, so clients can detect volume changes
+// 20261017  Include copy numbers in identifier, for replicated volumes
 
 #include "G4AffineTransform.hh"
 #include "G4ThreadLocalSingleton.hh"
@@ -30,6 +32,12 @@ class G4CMPGlobalLocalTransformStore {
 public:
   static const G4AffineTransform& ToLocal(const G4VTouchable*);
   static const G4AffineTransform& ToGlobal(const G4VTouchable*);
+
+  // Identifier for touchable's volume chain and copy numbers, same key as
+  // used for cache
+  static uintptr_t ID(const G4VTouchable* touch) {
+    return Instance().Hash(touch);
+  }
   
   static void Reset();
   
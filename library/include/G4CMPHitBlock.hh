@@ -0,0 +1,108 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file library/include/G4CMPHitBlock.hh
+/// \brief Definition of the G4CMPHitBlock container.  Stores the contents
+///	   of many G4CMPElectrodeHits in columns (one vector per quantity),
+///	   for compact binary output by G4CMPHitWriter, and for reading the
+///	   output back (see G4CMP/tools/g4cmpHitReader).
+///
+///	   Binary file format (version 1), in host byte order:
+///
+///	   | Item        | Type          | Content                           |
+///	   |-------------|---------------|-----------------------------------|
+///	   | magic       | char[8]       | "G4CMPHIT"                        |
+///	   | version     | uint32        | 1                                 |
+///	   | byteOrder   | uint32        | 0x01020304, to detect swapping    |
+///	   | (blocks)    |               | Repeated until end of file        |
+///
+///	   Each block of N hits, with M distinct particle names:
+///
+///	   | Item        | Type          | Content                           |
+///	   |-------------|---------------|-----------------------------------|
+///	   | nHits       | uint32        | N                                 |
+///	   | nNames      | uint32        | M                                 |
+///	   | names       | M x (uint32,  | Length and characters of each     |
+///	   |             |   char[len])  | particle name                     |
+///	   | runID       | int32[N]      |                                   |
+///	   | eventID     | int32[N]      |                                   |
+///	   | trackID     | int32[N]      |                                   |
+///	   | particle    | uint16[N]     | Index into block's name list      |
+///	   | startE      | float[N]      | Start energy [eV]                 |
+///	   | startX,Y,Z  | 3 x float[N]  | Start position [m]                |
+///	   | startTime   | double[N]     | Start time [ns]                   |
+///	   | EDep        | float[N]      | Energy deposited [eV]             |
+///	   | weight      | float[N]      | Track weight                      |
+///	   | finalX,Y,Z  | 3 x float[N]  | End position [m]                  |
+///	   | finalTime   | double[N]     | Final time [ns]                   |
+///
+///	   Units are the same as the CSV hit files written by the examples.
+///	   Times are kept in double precision, as hits may arrive over many
+///	   orders of magnitude in time.
+//
+// $Id$
+//
+// 20261017  New class, for use with G4CMPHitWriter
+
+#ifndef G4CMPHitBlock_hh
+#define G4CMPHitBlock_hh 1
+
+#include "G4Types.hh"
+#include "G4String.hh"
+#include <iosfwd>
+#include <vector>
+#include <stdint.h>
+
+class G4CMPElectrodeHit;
+
+
+class G4CMPHitBlock {
+public:
+  G4CMPHitBlock() {;}
+  explicit G4CMPHitBlock(size_t capacity) { Reserve(capacity); }
+
+  void Reserve(size_t capacity);
+  void Clear();				// Keeps allocated capacity
+
+  size_t Size() const { return runID.size(); }
+  G4bool Empty() const { return runID.empty(); }
+
+  // Copy hit contents into columns, converting to output units
+  void Add(G4int run, G4int event, const G4CMPElectrodeHit& hit);
+
+  const G4String& GetParticleName(size_t i) const {
+    return names[particle[i]];
+  }
+
+  // Binary I/O; return false on failure, or at end of file for Read
+  static G4bool WriteHeader(std::ostream& os);
+  static G4bool ReadHeader(std::istream& is);
+  G4bool Write(std::ostream& os) const;
+  G4bool Read(std::istream& is);
+
+  // Write hits as CSV lines, in same format as example applications
+  static void PrintHeader(std::ostream& os);
+  void Print(std::ostream& os) const;
+
+public:		// Simple container, provide direct access to columns
+  std::vector<int32_t> runID;
+  std::vector<int32_t> eventID;
+  std::vector<int32_t> trackID;
+  std::vector<uint16_t> particle;	// Index into names
+  std::vector<float> startE;		// [eV]
+  std::vector<float> startX, startY, startZ;	// [m]
+  std::vector<double> startTime;	// [ns]
+  std::vector<float> EDep;		// [eV]
+  std::vector<float> weight;
+  std::vector<float> finalX, finalY, finalZ;	// [m]
+  std::vector<double> finalTime;	// [ns]
+
+  std::vector<G4String> names;		// Particle names used in block
+
+private:
+  uint16_t NameIndex(const G4String& name);
+};
+
+#endif	/* G4CMPHitBlock_hh */
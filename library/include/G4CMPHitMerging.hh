@@ -16,6 +16,9 @@
 // 20220826  For use with primary generator, need to pass in G4Event*
 // 20220828  Add interface to process "left over" accumulators to primaries
 // 20240420  Add ability to set voltage bias from client code
+// 20261017  Replace map of accumulators with flat open-addressed table,
+//		reused from event to event; add batch ProcessSteps().
+// 20261017  Flag occupied table slots separately; any track ID is valid.
 
 #ifndef G4CMPHitMerging_hh
 #define G4CMPHitMerging_hh 1
@@ -23,7 +26,6 @@
 #include "G4CMPProcessUtils.hh"
 #include "G4CMPStepAccumulator.hh"
 #include "G4ThreeVector.hh"
-#include <map>
 #include <vector>
 
 class G4CMPEnergyPartition;
@@ -62,6 +64,12 @@ public:
   G4bool ProcessStep(const G4Step& step);
   G4bool ProcessStep(const G4Step* step);
 
+  // Process list of steps from primary generator, filling event with new
+  // primaries.  Return value indicates if any primaries were added.
+  // NOTE:  Call FinishOutput() after last batch of steps in event.
+  G4bool ProcessSteps(const std::vector<G4CMPStepInfo>& steps,
+		      G4Event* primaryEvent);
+
   // Transfer generated secondaries into process return object
   void FillOutput(G4VParticleChange* aParticleChange);
 
@@ -81,6 +89,14 @@ protected:
   // Process accumulator for track unconditionally to new primaries
   void FlushAccumulator(G4int trkID, G4Event* primaryEvent);
 
+  // Get accumulator for track, creating it if needed, or null if not found
+  G4CMPStepAccumulator* GetAccumulator(G4int trkID);
+  G4CMPStepAccumulator* FindAccumulator(G4int trkID);
+  size_t FindSlot(G4int trkID) const;	// Slot for track, or first empty
+
+  void ClearAccumulators();		// Empty table, keeping capacity
+  void ResizeAccumulators(size_t size);	// Rehash occupied slots
+
   // Create secondaries along the specified trajectory
   void GeneratePositions(size_t npos, const G4ThreeVector& start,
 			 const G4ThreeVector& end);
@@ -93,9 +109,14 @@ private:
   G4double combiningStepLength;		// Steps within which to accumulate
   G4bool readyForOutput;		// Flag if hit data ready for use
 
-  // Collection of accumulators for individual tracks in event
-  std::map<G4int, G4CMPStepAccumulator> trackAccum;
+  // Accumulators for individual tracks in event, in open-addressed table
+  // (linear probing, power-of-two size), indexed by track ID
+  std::vector<G4int> accumTrackID;		// Track ID in slot (any value)
+  std::vector<G4bool> accumFilled;		// Slot is occupied
+  std::vector<G4CMPStepAccumulator> accumSlots;
+  std::vector<size_t> accumUsed;		// Occupied slots, in order
   G4CMPStepAccumulator* accumulator;	// Sums multiple steps along track
+  G4double readyTime;			// Time of accumulator for output
   G4int currentEventID;			// Remember event for clearing accums
 
   G4CMPEnergyPartition* partitioner;	// Creates secondary kinematics
@@ -0,0 +1,64 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file library/include/G4CMPHitWriter.hh
+/// \brief Definition of the G4CMPHitWriter class.  Buffered binary output
+///	   of G4CMPElectrodeHits, for use by sensitive detectors in place
+///	   of formatted text output.
+///
+///	   Each sensitive detector (i.e., each worker thread) should have its
+///	   own writer.  Hits are copied into a G4CMPHitBlock; full blocks are
+///	   passed to a background thread which writes them to the file.  All
+///	   writers for the same file name share one output stream and thread,
+///	   so blocks from different workers are interleaved in the file.
+///
+///	   See G4CMPHitBlock.hh for the file format; G4CMP/tools/g4cmpHitReader
+///	   will convert the file to CSV text.
+//
+// $Id$
+//
+// 20261017  New class, for use with electrode sensitive detectors
+
+#ifndef G4CMPHitWriter_hh
+#define G4CMPHitWriter_hh 1
+
+#include "G4Types.hh"
+#include "G4String.hh"
+#include <vector>
+
+class G4CMPElectrodeHit;
+class G4CMPHitBlock;
+
+
+class G4CMPHitWriter {
+public:
+  explicit G4CMPHitWriter(const G4String& fileName, size_t blockSize=65536);
+  virtual ~G4CMPHitWriter();		// Sends last block for writing
+
+  const G4String& GetFileName() const { return fileName; }
+  G4bool IsOpen() const { return output != 0; }
+
+  // Copy hits into current block, passing full blocks to output thread
+  void Add(G4int runID, G4int eventID, const G4CMPElectrodeHit* hit);
+  void Add(G4int runID, G4int eventID,
+	   const std::vector<G4CMPElectrodeHit*>& hits);
+
+  // Pass current block to output thread, even if not full
+  void Flush();
+
+private:
+  class Output;				// Shared file and thread, in .cc
+
+  G4String fileName;
+  size_t blockSize;			// Hits per block sent to output
+  Output* output;
+  G4CMPHitBlock* block;			// Current block being filled
+
+  // No copying allowed
+  G4CMPHitWriter(const G4CMPHitWriter&);
+  G4CMPHitWriter& operator=(const G4CMPHitWriter&);
+};
+
+#endif	/* G4CMPHitWriter_hh */
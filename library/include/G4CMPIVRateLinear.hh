@@ -10,6 +10,7 @@
 // $Id$
 //
 // 20170815  Move G4CMPProcessUtils inheritance to base class
+// 20261017  Add interface for tabulation vs. field in HV space
 
 #ifndef G4CMPIVRateLinear_hh
 #define G4CMPIVRateLinear_hh 1
@@ -23,6 +24,12 @@ public:
   virtual ~G4CMPIVRateLinear() {;}
 
   virtual G4double Rate(const G4Track& aTrack) const;
+
+  // Rate depends only on magnitude of electric field in HV space (V/cm)
+  virtual G4bool CanTabulate() const { return true; }
+  virtual G4double RateVariable(const G4Track& aTrack) const;
+  virtual G4double RateFromVariable(G4double field, G4int chan=0) const;
+  virtual G4double RateVariableScale(G4int /*chan*/=0) const;
 };
 
 #endif	/* G4CMPIVRateLinear_hh */
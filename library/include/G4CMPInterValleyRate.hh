@@ -9,6 +9,7 @@
 // $Id$
 //
 // 20170919  Add interface for threshold identification
+// 20261017  Add interface for tabulation vs. kinetic energy
 
 #ifndef G4CMPInterValleyRate_hh
 #define G4CMPInterValleyRate_hh 1
@@ -31,6 +32,12 @@ public:
 
   virtual G4double Threshold(G4double Eabove=0.) const;
 
+  // Rate depends only on kinetic energy
+  virtual G4bool CanTabulate() const { return true; }
+  virtual G4double RateVariable(const G4Track& aTrack) const;
+  virtual G4double RateFromVariable(G4double energy, G4int chan=0) const;
+  virtual G4double RateVariableScale(G4int chan=0) const;
+
   // Initialize numerical parameters below
   virtual void LoadDataForTrack(const G4Track* track);
 
@@ -49,7 +56,7 @@ private:
   const G4double hbar_4th;
   const G4double m_electron;
 
-  // Kinematic parameters set by Rate()
+  // Kinematic parameters set by RateFromVariable()
   mutable G4double eTrk;	// Track kinetic energy
 
   G4double density;		// Crystal density (from G4Material)
@@ -0,0 +1,71 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file library/include/G4CMPInverseCDFTable.hh
+/// \brief Definition of the G4CMPInverseCDFTable class.  Tabulates the
+///	   inverse cumulative distribution of a family of PDFs, so that
+///	   random values may be drawn in constant time, without rejection.
+///
+///	   The family is parametrized by a "row" coordinate v, tabulated on
+///	   a uniform grid between vmin and vmax.  Each row is a PDF of the
+///	   sampling variable s, on [0,1].  The client maps v and s to its
+///	   own variables (e.g., using a logarithm of energy for v, and a
+///	   change of variables in s to smooth out endpoint singularities).
+///
+///	   Each row stores the normalized CDF on a uniform grid in s, and a
+///	   "guide table" (Chen & Asau, 1974) of starting bins on a uniform
+///	   grid in probability, so the bin search takes a step or two.  The
+///	   PDF is taken to be constant within each bin.
+///
+///	   Between rows, a draw is taken from one of the two adjacent rows,
+///	   chosen with probability given by the linear interpolation weight.
+//
+// $Id$
+//
+// 20261017  New class, for use with G4CMPKaplanQP energy distributions
+
+#ifndef G4CMPInverseCDFTable_hh
+#define G4CMPInverseCDFTable_hh 1
+
+#include "globals.hh"
+#include <functional>
+#include <vector>
+
+
+class G4CMPInverseCDFTable {
+public:
+  // PDF (need not be normalized) as function of row v and sampling s
+  typedef std::function<G4double(G4double v, G4double s)> PDF;
+
+  G4CMPInverseCDFTable();
+  G4CMPInverseCDFTable(G4double vmin, G4double vmax, size_t nRows,
+		       const PDF& pdf, size_t nBins=512, size_t nGuide=128);
+
+  // Fill table, integrating PDF over nBins in s for each of nRows
+  void Build(G4double vmin, G4double vmax, size_t nRows, const PDF& pdf,
+	     size_t nBins=512, size_t nGuide=128);
+
+  void Clear();
+
+  G4bool IsReady() const { return !cdfTable.empty(); }
+  G4bool InRange(G4double v) const {
+    return (IsReady() && v >= vMin && v <= vMax);
+  }
+
+  // Draw sampling variable s in [0,1] for specified row coordinate
+  G4double Sample(G4double v) const;
+
+private:
+  G4double InverseCDF(size_t row, G4double prob) const;
+
+  G4double vMin, vMax, vStep;
+  size_t nRows;
+  size_t nBins;				// Uniform intervals in s
+  size_t nGuide;			// Uniform intervals in probability
+  std::vector<G4double> cdfTable;	// nRows*(nBins+1) CDF values
+  std::vector<G4int> guideTable;	// nRows*nGuide starting bins
+};
+
+#endif	/* G4CMPInverseCDFTable_hh */
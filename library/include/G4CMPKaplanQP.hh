@@ -53,13 +53,22 @@
 //		new DoDirectAbsorption() boolean test.
 // 20240502  G4CMP-344: Reusable vector buffers to avoid memory churn.
 // 20240502  G4CMP-379: Add Fermi-Dirac thermal probability for QP energies.
+// 20261017  Sample QP and phonon energies from inverse-CDF tables, built on
+//		first use, instead of by rejection.
+// 20261017  Add fast mode, sampling tabulated cascade results for each film.
+// 20261017  Film response tables shared between threads; quiet flag for
+//		DoCascade() replaces changing verboseLevel while tabulating.
+// 20261017  Add PrepareFilmResponse() to build table at initialization.
 
 #ifndef G4CMPKaplanQP_hh
 #define G4CMPKaplanQP_hh 1
 
 #include "G4Types.hh"
+#include "G4CMPInverseCDFTable.hh"
 #include <fstream>
+#include <map>
 #include <vector>
+#include <stdint.h>
 
 class G4MaterialPropertiesTable;
 
@@ -90,6 +99,11 @@ public:
   G4double AbsorbPhonon(G4double energy,
 			std::vector<G4double>& reflectedEnergies) const;
 
+  // Fast mode:  build film response table for properties in advance (e.g.,
+  // at detector construction), so worker threads only need to look it up
+  static void PrepareFilmResponse(G4MaterialPropertiesTable* prop,
+				  G4int vb=0);
+
   // Set temperature for use by thermalization functions
   void SetTemperature(G4double temp) { temperature = temp; }
 
@@ -117,6 +131,31 @@ protected:
 	    phononLifetime > 0. && phononLifetimeSlope >= 0.);
   }
 
+  // Run quasiparticle/phonon cascade for phonon which enters the film
+  // NOTE:  quiet suppresses diagnostic output, for use when tabulating
+  G4double DoCascade(G4double energy, std::vector<G4double>& reflectedEnergies,
+		     G4bool quiet=false) const;
+
+  // Cascade results, as fractions of incident energy, at log-spaced
+  // incident energies, for fast mode (see G4CMPConfigManager)
+  struct FilmResponse {
+    std::vector<G4double> eDep;		// Deposited energy per cascade
+    std::vector<size_t> reflStart;	// First reflected phonon per cascade
+    std::vector<G4double> reflected;	// Reflected phonon energies
+  };
+
+  // Get table for current film parameters, running cascades on first use
+  // Tables are shared by all threads; returns null if too many are in use
+  const FilmResponse* GetFilmResponse() const;
+  G4bool InFilmResponse(G4double energy) const;
+
+  // Run cascades for table, using random engine seeded from key
+  void FillFilmResponse(FilmResponse& response, uint64_t key) const;
+
+  // Fill reflected phonons from randomly chosen cascade, return EDep
+  G4double SampleFilmResponse(const FilmResponse& response, G4double energy,
+			      std::vector<G4double>& reflectedEnergies) const;
+
   // Compute the probability of a phonon reentering the crystal without breaking
   // any Cooper pairs.
   G4double CalcEscapeProbability(G4double energy,
@@ -159,12 +198,20 @@ protected:
   G4double PhononEnergyRand(G4double Energy) const;
   G4double PhononEnergyPDF(G4double E, G4double x) const;
 
+  // Tables of above distributions in units of bandgap, built on first use
+  // NOTE:  Return null if energy (E/gap) is outside of tabulated range
+  const G4CMPInverseCDFTable* GetQPEnergyTable(G4double Energy) const;
+  const G4CMPInverseCDFTable* GetPhononEnergyTable(G4double Energy) const;
+
   // Encapsulate below-bandgap logic
   G4bool IsSubgap(G4double energy) const { return (energy < 2.*gapEnergy); }
   G4bool DirectAbsorb(G4double energy) const {
     return (IsSubgap(energy) && energy > 2.*absorberGap);
   }
 
+  // Verbosity within DoCascade(), zero for quiet cascades
+  G4int CascadeVerbose() const { return (quietCascade ? 0 : verboseLevel); }
+
   // Write summary of interaction to output "kaplanqp_stats" file
   void ReportAbsorption(G4double energy, G4double EDep,
 			const std::vector<G4double>& reflectedEnergies) const;
@@ -172,6 +219,7 @@ protected:
 private:
   G4int verboseLevel;			// For diagnostic messages
   mutable G4bool keepAllPhonons;	// Copy of flag KeepKaplanPhonons()
+  mutable G4bool quietCascade;		// Set for duration of DoCascade()
 
   G4MaterialPropertiesTable* filmProperties;
   G4double filmThickness;	// Quantities extracted from properties table
@@ -193,6 +241,14 @@ private:
   mutable std::vector<G4double> newQPEnergies;	// Intermediate processing
   mutable std::vector<G4double> newPhonEnergies;
 
+  // Energy sampling tables; QP tables depend on temperature (kT/gap)
+  mutable std::map<G4double, G4CMPInverseCDFTable> qpEnergyTables;
+  mutable G4CMPInverseCDFTable phononEnergyTable;
+
+  // Shared film response tables used by this instance, keyed by hash of
+  // film parameters, to avoid locking after first use
+  mutable std::map<uint64_t, const FilmResponse*> filmResponses;
+
   mutable std::ofstream output;		// Diagnostic output under G4CMP_DEBUG
 };
 
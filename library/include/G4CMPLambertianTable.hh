@@ -0,0 +1,86 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file library/include/G4CMPLambertianTable.hh
+/// \brief Definition of the G4CMPLambertianTable class.  Tabulates the
+///	   wavevector directions which give an inward group velocity for a
+///	   given lattice, phonon mode and surface normal, so that diffuse
+///	   (Lambertian) reflections may be drawn directly, without retries.
+///
+///	   Directions are binned uniformly in sin^2(theta) and phi about
+///	   the inward normal, where the Lambertian distribution is flat.
+///	   Each cell is tested with 2x2 trial directions.  Cells next to
+///	   one with an inward trial are tested again with 4x4 trials, and
+///	   this is repeated outward from each newly found cell, to trace
+///	   the edge of the admissible region.  A cell is used if it, or
+///	   any of its neighbours, has an inward trial.  A sample is drawn
+///	   by choosing a used cell at random, then a uniform point in it.
+///
+///	   Cells along the edge of the admissible region will return some
+///	   outward directions, so callers must test each result and draw
+///	   again if needed, falling back to plain Lambertian draws with
+///	   retries if the table keeps failing.  The accepted directions
+///	   follow the Lambertian distribution over the admissible region
+///	   covered by used cells.  This is approximate: an admissible
+///	   pocket smaller than a cell, and away from every inward trial
+///	   and its neighbours, is not sampled.
+//
+// $Id$
+//
+// 20261017  New class, for use with G4CMPPhononBoundaryProcess
+// 20261017  Refine cells next to inward cells with 4x4 trial directions
+
+#ifndef G4CMPLambertianTable_hh
+#define G4CMPLambertianTable_hh 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+#include <vector>
+
+class G4LatticePhysical;
+
+
+class G4CMPLambertianTable {
+public:
+  G4CMPLambertianTable();
+  G4CMPLambertianTable(const G4LatticePhysical* lattice, G4int mode,
+		       const G4ThreeVector& surfNorm, size_t nS=32,
+		       size_t nPhi=64);
+
+  // Fill table for outward normal, using 2x2 trial directions per cell,
+  // and 4x4 trials along the edge of the admissible region
+  void Build(const G4LatticePhysical* lattice, G4int mode,
+	     const G4ThreeVector& surfNorm, size_t nS=32, size_t nPhi=64);
+
+  void Clear();
+
+  G4bool IsReady() const { return !cellCDF.empty(); }
+  const G4ThreeVector& GetNormal() const { return normal; }
+
+  // Fraction of Lambertian distribution with inward group velocity
+  G4double GetAcceptance() const { return acceptance; }
+
+  // Draw wavevector direction, rotated from table normal to surfNorm
+  G4ThreeVector Sample() const;
+  G4ThreeVector Sample(const G4ThreeVector& surfNorm) const;
+
+private:
+  // Unit wavevector into volume, for s = sin^2(theta) about normal
+  G4ThreeVector Direction(G4double s, G4double phi) const;
+
+  // Test nTrial x nTrial directions in each cell; flag cells with any
+  // inward group velocity, and return number of inward trials
+  G4int TestCells(const G4LatticePhysical* lattice, G4int mode,
+		  const std::vector<size_t>& cells, size_t nTrial,
+		  std::vector<G4bool>& inward) const;
+
+  G4ThreeVector normal;			// Outward surface normal
+  G4ThreeVector axis1, axis2;		// Transverse axes for phi
+  size_t nS, nPhi;			// Uniform intervals in sin^2, phi
+  G4double acceptance;
+  std::vector<G4double> cellCDF;	// nS*nPhi cumulative cell weights
+};
+
+#endif	/* G4CMPLambertianTable_hh */
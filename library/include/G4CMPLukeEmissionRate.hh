@@ -11,6 +11,7 @@
 // 20170815  Move G4CMPProcessUtils inheritance to base class
 // 20170907  Make process non-forced; TimeStepper will trigger recalculation
 // 20170919  Add interface for threshold identification
+// 20261017  Add interface for tabulation vs. wavevector
 
 #ifndef G4CMPLukeEmissionRate_hh
 #define G4CMPLukeEmissionRate_hh 1
@@ -25,6 +26,18 @@ public:
 
   virtual G4double Rate(const G4Track& aTrack) const;
   virtual G4double Threshold(G4double Eabove=0.) const;
+
+  // Rate depends only on wavevector, separately for electrons and holes
+  virtual G4bool CanTabulate() const { return true; }
+  virtual G4int RateChannel(const G4Track& aTrack) const;
+  virtual G4double RateVariable(const G4Track& aTrack) const;
+  virtual G4double RateFromVariable(G4double kmag, G4int chan=0) const;
+  virtual G4double RateVariableScale(G4int chan=0) const;
+
+protected:
+  // Parameters for charge carrier "channel" (0 = electron, 1 = hole)
+  G4double ScatterLength(G4int chan) const;
+  G4double SoundWavevector(G4int chan) const;
 };
 
 #endif	/* G4CMPLukeEmissionRate_hh */
@@ -19,6 +19,12 @@
 // 20190509  Migrate to 2D/3D mesh base class, handle dimensional reduction
 // 20190612  Mesh pointer ctor should set axes to kUndefined
 // 20200520  For thread-safety, move reusable "pos" buffer here
+// 20261017  Use binary cache of 3D mesh tables, if enabled.
+// 20261017  Share mesh tables between fields built from same input file.
+// 20261017  Add GetFieldValues(), GetPotentials() for lists of points.
+// 20261017  Add BuildGrid() to resample 3D mesh onto regular grid.
+// 20261017  Pass "quiet" flag to batch functions, same defaults as single
+//		point functions.
 
 #ifndef G4CMPMeshElectricField_h 
 #define G4CMPMeshElectricField_h 1
@@ -71,6 +77,20 @@ public:
   // Call through to interpolator (e.g., for use with FET code)
   virtual G4double GetPotential(const G4double Point[3]) const;
 
+  // Evaluate field or potential at many points (e.g., for field maps);
+  // "quiet" suppresses "outside of hull" warnings, with defaults matching
+  // GetFieldValue() (quiet) and GetPotential() (not quiet) above
+  void GetFieldValues(const std::vector<G4ThreeVector>& points,
+		      std::vector<G4ThreeVector>& efield,
+		      G4bool quiet=true) const;
+  void GetPotentials(const std::vector<G4ThreeVector>& points,
+		     std::vector<G4double>& potential,
+		     G4bool quiet=false) const;
+  void GetFieldValues(const std::vector<G4ThreeVector>& points,
+		      std::vector<G4ThreeVector>& efield,
+		      std::vector<G4double>& potential,
+		      G4bool quiet=false) const;
+
   // Get access to mesh interpolator for client access or copying
   const G4CMPVMeshInterpolator* GetInterpolator() const { return Interp; }
 
@@ -83,6 +103,15 @@ private:
   EAxis xCoord, yCoord;			// 2D coordinates for projection
 
   void BuildInterp(const G4String& EPotFileName, G4double Vscale=1.);
+  void ReadEPotFile(const G4String& EPotFileName, G4double Vscale);
+
+  // Load or save binary mesh tables alongside input file ($G4CMP_MESH_CACHE)
+  G4bool LoadCache(const G4String& EPotFileName, G4double Vscale);
+  void SaveCache(const G4String& EPotFileName, G4double Vscale) const;
+
+  // Resample 3D mesh onto regular grid with given step ($G4CMP_MESH_GRID)
+  void BuildGrid(const G4String& EPotFileName, G4double Vscale,
+		 G4double step);
 
   // Construct 3D mesh interpolator
   void BuildInterp(const std::vector<std::array<G4double,3> >& xyz,
@@ -98,6 +127,16 @@ private:
   void Project2D(const G4double Point[3], G4double Project[2]) const;
   void Expand2Dat(const G4double Point[3], G4ThreeVector& Efield) const;
 
+  // Convert mesh gradients at list of points to field vectors
+  void Grad2Field(const std::vector<G4ThreeVector>& points,
+		  std::vector<G4ThreeVector>& efield) const;
+
+  // Fill mesh coordinates from list of points, projecting for 2D meshes
+  void FillMeshPoints(const std::vector<G4ThreeVector>& points) const;
+
+private:
+  mutable std::vector<std::array<G4double,3> > meshPts_;	// Reusable
+
 private:
   mutable G4ThreeVector pos_;		// Reusale buffer for calculations
 };
@@ -13,14 +13,19 @@
 // 20181010  J. Singh -- Use new G4CMPAnharmonicDecay for boundary decays
 // 20181011  M. Kelsey -- Add LoadDataForTrack() to initialize decay utility.
 // 20220906  M. Kelsey -- Encapsulate specular reflection in function.
+// 20261017  Add cache of Lambertian tables for direct diffuse reflection.
 
 #ifndef G4CMPPhononBoundaryProcess_h
 #define G4CMPPhononBoundaryProcess_h 1
 
 #include "G4VPhononProcess.hh"
 #include "G4CMPBoundaryUtils.hh"
+#include "G4CMPLambertianTable.hh"
+#include <map>
+#include <tuple>
 
 class G4CMPAnharmonicDecay;
+class G4LatticePhysical;
 
 class G4CMPPhononBoundaryProcess : public G4VPhononProcess,
 				   public G4CMPBoundaryUtils {
@@ -57,9 +62,18 @@ protected:
   G4ThreeVector GetLambertianVector(const G4ThreeVector& surfNorm,
 				    G4int mode) const;
 
+  // Table of inward directions for surface normal, null if not available
+  const G4CMPLambertianTable*
+  GetLambertianTable(const G4ThreeVector& surfNorm, G4int mode) const;
+
 private:
   G4CMPAnharmonicDecay* anharmonicDecay;
 
+  // Diffuse reflection tables by lattice, mode, and gridded normal
+  typedef std::tuple<const G4LatticePhysical*, G4int, G4int, G4int, G4int>
+  LambertKey;
+  mutable std::map<LambertKey, G4CMPLambertianTable> lambertTables;
+
   // hide assignment operator as private
   G4CMPPhononBoundaryProcess(G4CMPPhononBoundaryProcess&);
   G4CMPPhononBoundaryProcess(G4CMPPhononBoundaryProcess&&);
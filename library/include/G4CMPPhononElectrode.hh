@@ -34,6 +34,7 @@
 /// directly absorb phonons below 2*bandgap.
 // 
 // 20221006  M. Kelsey -- Adapted from SuperCDMS simulation version
+// 20261017  Build KaplanQP fast mode table when surface table is assigned
 
 #ifndef G4CMPPhononElectrode_hh
 #define G4CMPPhononElectrode_hh 1
@@ -61,6 +62,9 @@ public:
     return new G4CMPPhononElectrode(*this);
   }
 
+  // Build KaplanQP film response table (fast mode) before run starts
+  virtual void UseSurfaceTable(G4MaterialPropertiesTable* surfProp);
+
   // Assumes that user has configured a border surface only at sensor pads
   virtual G4bool IsNearElectrode(const G4Step&) const;
 
@@ -0,0 +1,35 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file library/include/G4CMPPhononEnergyImportance.hh
+/// \brief Definition of the G4CMPPhononEnergyImportance class.  Assigns
+///	   phonon importance by bands of kinetic energy (frequency), for
+///	   example to favor phonons which have downconverted below some
+///	   energy, or which are able to break Cooper pairs in a sensor.
+///
+///	   Usage:  auto imp = new G4CMPPhononEnergyImportance;
+///		   imp->AddBand(0.*meV, 4.);	// Low-energy phonons
+///		   imp->AddBand(2.*meV, 1.);
+///		   G4CMPConfigManager::SetPhononImportance(imp);
+//
+// $Id$
+//
+// 20261017  New class, for use with G4CMPPhononWeightWindow
+
+#ifndef G4CMPPhononEnergyImportance_hh
+#define G4CMPPhononEnergyImportance_hh 1
+
+#include "G4CMPVPhononImportance.hh"
+
+
+class G4CMPPhononEnergyImportance : public G4CMPVPhononImportance {
+public:
+  G4CMPPhononEnergyImportance() {;}
+  virtual ~G4CMPPhononEnergyImportance() {;}
+
+  virtual G4double GetImportance(const G4Track& track) const;
+};
+
+#endif	/* G4CMPPhononEnergyImportance_hh */
@@ -3,13 +3,19 @@
 //
 //  20160628  Tabulating on nx and ny is just wrong; use theta, phi
 //  20170525  Drop unnecessary empty destructor ("rule of five" semantics)
+//  20261017  Add batch group-velocity lookup over structure-of-arrays input
+//  20261017  Add binary cache of lookup data, used by initialize()
+//  20261017  Replace per-quantity grid interpolators with interleaved
+//		records, indexed directly on the uniform theta-phi grid
+//  20261017  Tabulate only irreducible wedge of crystal symmetry group
+//  20261017  Cache holds record table; lookupData released after use
 
 #ifndef G4CMPPhononKinTable_hh
 #define G4CMPPhononKinTable_hh
 
-#include "G4CMPInterpolator.hh"
 #include "G4PhysicalConstants.hh"
 #include "G4ThreeVector.hh"
+#include <cstdint>
 #include <string>
 #include <vector>
 using std::string;
@@ -21,12 +27,27 @@ class G4CMPPhononKinematics;
 // ++++++++++++++++++++++++++++++ G4CMPPhononKinTable +++++++++++++++++++++++++
 class G4CMPPhononKinTable {
 public:
+  // NOTE: If the full sphere is requested, and symmetry is used, only the
+  //       irreducible wedge is tabulated, with the same angular steps
   G4CMPPhononKinTable(G4CMPPhononKinematics* map, G4double thmin=0.,
 		      G4double thmax=pi, G4int nth=250, G4double phmin=0.,
-		      G4double phmax=twopi, G4int nph=250);
+		      G4double phmax=twopi, G4int nph=250,
+		      G4bool useSymmetry=true);
 
   void initialize();		// Trigger filling of lookup tables
 
+public:
+  // Symmetry used to reduce table, as Laue class of elasticity tensor.
+  // Chosen from lattice's Bravais group (G4CMPCrystalGroup), and checked
+  // against elasticity tensor; a lower symmetry is used if that fails
+  enum Symmetry { NO_SYMMETRY,		// Full sphere tabulated
+		  INVERSION,		// -1:    z >= 0
+		  ORTHORHOMBIC,		// mmm:   x,y,z >= 0
+		  TETRAGONAL_LOW,	// 4/m:   x > 0, y,z >= 0
+		  TETRAGONAL,		// 4/mmm: x >= y >= 0, z >= 0
+		  CUBIC };		// m-3m:  z >= x >= y >= 0
+  Symmetry getSymmetry() const { return symmetry; }
+
 public:
   // Symbolic identifiers for various arrays, to use with lookup table
   enum DataTypes { N_X, N_Y, N_Z, THETA, PHI,	// Wavevector
@@ -57,15 +78,61 @@ public:
 
   double interpGroupVelocity(int mode, const G4ThreeVector& k)
   { return interpGeneral(mode, k, V_G); }
+
+  // Group velocity vector from one lookup; equivalent to the product of
+  // interpGroupVelocity() and interpGroupVelocity_N()
+  G4ThreeVector interpGroupVelocityVector(int mode, const G4ThreeVector& k);
+
+  // All kinematic quantities for wavevector, from one lookup
+  void interpKinematics(int mode, const G4ThreeVector& k, G4double& vphase,
+			G4ThreeVector& slowness, G4ThreeVector& vgroup,
+			G4ThreeVector& polarization);
+
+  // Group velocity vectors for n wavevectors (need not be unit length),
+  // passed as separate component arrays; equivalent to the product of
+  // interpGroupVelocity() and interpGroupVelocity_N() for each entry
+  void interpGroupVelocities(size_t n, const G4int* mode,
+			     const G4double* kx, const G4double* ky,
+			     const G4double* kz, G4double* vx,
+			     G4double* vy, G4double* vz);
   
   // Dump lookup table for external use
   void write();
 
+  // NOTE: write() and the cache contain only the tabulated wedge
+
+  // Binary copy of record table, reused by initialize() when the cache
+  // directory is set (G4CMPConfigManager::GetKinCacheDir())
+  // NOTE: key identifies lattice kinematics and binning; LoadCache()
+  //       rejects a file with a different key or incompatible layout
+  uint64_t cacheKey() const;
+  G4bool SaveCache(const G4String& fname, uint64_t key) const;
+  G4bool LoadCache(const G4String& fname, uint64_t key);
+
 protected:
   // Internal drivers for lookup tables
   double interpolateEven(double theta, double phi, int MODE, int TYPE_OUT,
 			 bool SILENT=true);
-  double interpolateEven(G4CMPGridInterp& grid, double theta, double phi);
+
+  // Bilinear interpolation of nType consecutive DataTypes, from firstType
+  void interpolateRecord(double theta, double phi, int MODE, int firstType,
+			 int nType, double* result) const;
+
+  // Symmetry operation as signed permutation, k'[i] = sign[i]*k[perm[i]]
+  struct SymOp {
+    G4int perm[3];
+    G4double sign[3];
+  };
+
+  // Map wavevector into tabulated wedge; returns angles and operation used
+  void mapToWedge(G4double kx, G4double ky, G4double kz, G4double& theta,
+		  G4double& phi, SymOp& op) const;
+
+  // Apply inverse of operation to vector quantities in full data record
+  void mapFromWedge(const SymOp& op, double* record) const;
+
+  // Restore vector (x,y,z) from wedge, v[perm[i]] = sign[i]*v'[i]
+  void mapFromWedge(const SymOp& op, double& x, double& y, double& z) const;
 
 private:
   G4double thetaMin, thetaMax, thetaStep;   // Range and steps for wavevector
@@ -73,18 +140,27 @@ private:
   G4double phiMin, phiMax, phiStep;
   G4int phiCount;
 
+  // Choose symmetry and reduce angular ranges to wedge, keeping steps
+  void setUpSymmetry();
+  Symmetry chooseSymmetry() const;
+  G4bool isSymmetryOf(const SymOp& op) const;	// Leaves Cijkl unchanged
+
   // Populate full table for interpolation
   void setUpDataVectors();
   void generateLookupTable();
-  void generateMultiEvenTable();
-  G4CMPGridInterp generateEvenTable(int MODE, DataTypes TYPE_OUT);
-  void clearQuantityMap();
+  void generateRecordTable();
 
 private:
   G4CMPPhononKinematics* mapper;	// Not owned; client responsibility
   G4bool lookupReady;			// Flag once tables are filled
-  vector<vector<G4CMPGridInterp> > quantityMap;
-  vector<vector<vector<double> > > lookupData;
+  G4bool useSymmetry;			// Reduce full sphere to wedge
+  Symmetry symmetry;
+  vector<vector<vector<double> > > lookupData;	// Released after records
+
+  // All DataTypes for each mode and grid point, stored contiguously, so
+  // one lookup reads every quantity.  Record (mode,ith,iph) is at index
+  // ((mode*(thetaCount+1) + ith)*(phiCount+1) + iph) * NUM_DATA_TYPES
+  vector<double> recordTable;
 };
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
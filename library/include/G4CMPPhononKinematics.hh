@@ -5,16 +5,16 @@
 //  Created by Daniel Palken in 2014 for G4CMP
 //
 //  20170525  Drop unnecessary empty destructor ("rule of five" semantics)
+//  20261017  Expose lattice, for use in keying kinematics table cache
+//  20261017  Use specialized 3x3 eigensolver, cache recent directions
 
-#include "G4CMPEigenSolver.hh" // Numerical Recipes III code
-#include "G4CMPMatrix.hh"
+#include "G4CMPEigenSolver3x3.hh"
 #include "G4PhononPolarization.hh"
 #include "G4ThreeVector.hh"
 #include <string>
 #include <vector>
 using std::string;
 using std::vector;
-using G4CMP::matrix;
 
 class G4LatticeLogical;
 
@@ -26,8 +26,6 @@ public:
   // Direct calculations
   void computeKinematics(const G4ThreeVector& n_dir);
   void fillChristoffelMatrix(const G4ThreeVector& n_dir);
-  void computeGroupVelocity(int mode, size_t idx, const matrix<double>& epol,
-			    const G4ThreeVector& slow);
   const G4ThreeVector& getGroupVelocity(int mode, const G4ThreeVector& n_dir);
   const G4ThreeVector& getPolarization(int mode, const G4ThreeVector& n_dir);
   const G4ThreeVector& getSlowness(int mode, const G4ThreeVector& n_dir);
@@ -35,18 +33,33 @@ public:
 
 public:
   const G4String& getLatticeName() const;	// For use with lookup table
+  const G4LatticeLogical* getLattice() const { return lattice; }
 
 private:
   G4LatticeLogical* lattice;
 
+  // Kinematics for all modes in one direction
+  struct Solution {
+    G4ThreeVector ndir;			// Unit vector, or zero if unused
+    double vphase[G4PhononPolarization::NUM_MODES];
+    G4ThreeVector slowness[G4PhononPolarization::NUM_MODES];
+    G4ThreeVector vgroup[G4PhononPolarization::NUM_MODES];
+    G4ThreeVector polarization[G4PhononPolarization::NUM_MODES];
+  };
+
+  void solve(const G4ThreeVector& ndir, Solution& soln);
+  G4ThreeVector groupVelocity(const G4ThreeVector& epol,
+			      const G4ThreeVector& slow) const;
+
+  // Recently used directions, indexed by hash of direction
+  static const size_t cacheSize = 64;	// Must be power of two
+  size_t cacheIndex(const G4ThreeVector& ndir) const;
+  vector<Solution> cache;
+  size_t current;			// Result of last computeKinematics()
+
   // Data buffers to compute kinematics for all modes in specified direction
-  G4ThreeVector last_ndir;		// Buffer to handle caching results
-  G4CMPEigenSolver eigenSys;
-  matrix<double> christoffel;
-  double vphase[G4PhononPolarization::NUM_MODES];
-  G4ThreeVector slowness[G4PhononPolarization::NUM_MODES];
-  G4ThreeVector vgroup[G4PhononPolarization::NUM_MODES];
-  G4ThreeVector polarization[G4PhononPolarization::NUM_MODES];
+  G4CMPEigenSolver3x3 eigenSys;
+  double christoffel[3][3];
 };
 
 #endif /* G4CMPPhononKinematics_hh */
@@ -0,0 +1,51 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file library/include/G4CMPPhononSurfaceImportance.hh
+/// \brief Definition of the G4CMPPhononSurfaceImportance class.  Assigns
+///	   phonon importance by bands of distance to the nearest of a set
+///	   of planar surfaces (e.g., faces instrumented with sensors).
+///	   Surfaces are specified by a point and a normal, in the local
+///	   coordinates of the crystal volume.
+///
+///	   Usage:  auto imp = new G4CMPPhononSurfaceImportance;
+///		   imp->AddSurface(G4ThreeVector(0,0,h/2), G4ThreeVector(0,0,1));
+///		   imp->AddBand(0.*mm, 8.);	// Close to sensors
+///		   imp->AddBand(1.*mm, 4.);
+///		   imp->AddBand(3.*mm, 1.);	// Bulk of crystal
+///		   G4CMPConfigManager::SetPhononImportance(imp);
+//
+// $Id$
+//
+// 20261017  New class, for use with G4CMPPhononWeightWindow
+
+#ifndef G4CMPPhononSurfaceImportance_hh
+#define G4CMPPhononSurfaceImportance_hh 1
+
+#include "G4CMPVPhononImportance.hh"
+#include "G4ThreeVector.hh"
+#include <vector>
+
+
+class G4CMPPhononSurfaceImportance : public G4CMPVPhononImportance {
+public:
+  G4CMPPhononSurfaceImportance() {;}
+  virtual ~G4CMPPhononSurfaceImportance() {;}
+
+  virtual G4double GetImportance(const G4Track& track) const;
+
+  // Point and normal are in local coordinates of crystal volume
+  void AddSurface(const G4ThreeVector& point, const G4ThreeVector& normal);
+  void ClearSurfaces() { points.clear(); normals.clear(); }
+
+  // Distance from local position to nearest surface (DBL_MAX if none)
+  G4double GetDistance(const G4ThreeVector& localPos) const;
+
+private:
+  std::vector<G4ThreeVector> points;
+  std::vector<G4ThreeVector> normals;	// Unit vectors
+};
+
+#endif	/* G4CMPPhononSurfaceImportance_hh */
@@ -13,18 +13,16 @@
 //
 // 20161111 Initial commit - R. Agnese
 // 20170728 M. Kelsey -- Replace "k" function args with "theK" (-Wshadow)
+// 20261017 Use thread-local G4Allocator, with large pages, for track info
+// 20261017 Add last-applied importance, for G4CMPPhononWeightWindow
+// 20261017 Guard operator delete against missing thread-local allocator
 
 #ifndef G4CMPPhononTrackInfo_hh
 #define G4CMPPhononTrackInfo_hh 1
 
 #include "G4CMPVTrackInfo.hh"
-#include "G4ThreeVector.hh"
-
-/* NOTE: Avoiding use of G4Allocator for performance reasons
 #include "G4Allocator.hh"
-class G4CMPPhononTrackInfo;
-extern G4Allocator<G4CMPPhononTrackInfo> G4CMPPhononTrackInfoAllocator;
-*/
+#include "G4ThreeVector.hh"
 
 
 class G4CMPPhononTrackInfo : public G4CMPVTrackInfo {
@@ -32,25 +30,49 @@ public:
   G4CMPPhononTrackInfo() = delete;
   G4CMPPhononTrackInfo(const G4LatticePhysical* lat, G4ThreeVector k);
 
-/* NOTE: Avoiding use of G4Allocator for performance reasons
-  void *operator new(size_t) noexcept {
-    return static_cast<void*>(G4CMPPhononTrackInfoAllocator.MallocSingle());
-  }
-
-  void operator delete(void* info) noexcept {
-    G4CMPPhononTrackInfoAllocator.FreeSingle(static_cast<G4CMPPhononTrackInfo*>(info));
-  }
-*/
+  // Memory allocation using thread-local G4Allocator; implemented below
+  inline void* operator new(size_t size);
+  inline void  operator delete(void* info, size_t size);
 
   void SetK(G4ThreeVector theK)          { waveVec = theK; }
   void SetWaveVector(G4ThreeVector theK) { waveVec = theK; }
   G4ThreeVector k() const                { return waveVec; }
   G4ThreeVector WaveVector() const       { return waveVec; }
 
+  // Importance at which track weight was last set; negative if never set
+  void SetImportance(G4double imp)       { importance = imp; }
+  G4double Importance() const            { return importance; }
+
   virtual void Print() const override;
 
 private:
   G4ThreeVector waveVec;
+  G4double importance;
 };
 
+
+// Pooled memory reused from track to track and event to event
+
+extern G4ThreadLocal G4Allocator<G4CMPPhononTrackInfo>* G4CMPPhononTrackInfoAllocator;
+
+// Derived classes have different size; fall back to normal allocation
+
+inline void* G4CMPPhononTrackInfo::operator new(size_t size) {
+  if (size != sizeof(G4CMPPhononTrackInfo)) return ::operator new(size);
+
+  if (!G4CMPPhononTrackInfoAllocator) {
+    G4CMPPhononTrackInfoAllocator = new G4Allocator<G4CMPPhononTrackInfo>;
+    G4CMPPhononTrackInfoAllocator->IncreasePageSize(16);	// Millions per event
+  }
+  return (void*)G4CMPPhononTrackInfoAllocator->MallocSingle();
+}
+
+// Without a pool in this thread, object was not allocated from one
+
+inline void G4CMPPhononTrackInfo::operator delete(void* info, size_t size) {
+  if (size != sizeof(G4CMPPhononTrackInfo) || !G4CMPPhononTrackInfoAllocator)
+    ::operator delete(info);
+  else G4CMPPhononTrackInfoAllocator->FreeSingle((G4CMPPhononTrackInfo*)info);
+}
+
 #endif
@@ -0,0 +1,65 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file library/include/G4CMPPhononWeightWindow.hh
+/// \brief Definition of the G4CMPPhononWeightWindow process, to split or
+///	   roulette phonon tracks in flight, according to the importance
+///	   map registered with G4CMPConfigManager::SetPhononImportance().
+///
+///	   Each phonon track carries the importance at which its weight was
+///	   last set.  When the current importance differs from that by more
+///	   than G4CMPConfigManager::GetImportanceRatio(), the track is split
+///	   into (on average) the ratio of importances, or is killed with
+///	   probability one minus that ratio.  Track weights are divided by
+///	   the ratio, so weighted sums (e.g., in G4CMPElectrodeHit) remain
+///	   unbiased.
+///
+///	   If no importance map is registered, the process does nothing.
+//
+// $Id$
+//
+// 20261017  New process for in-flight phonon variance reduction
+
+#ifndef G4CMPPhononWeightWindow_hh
+#define G4CMPPhononWeightWindow_hh 1
+
+#include "G4CMPVProcess.hh"
+
+class G4ParticleDefinition;
+class G4Step;
+class G4Track;
+class G4VParticleChange;
+
+
+class G4CMPPhononWeightWindow : public G4CMPVProcess {
+public:
+  G4CMPPhononWeightWindow(const G4String& name="phononWeightWindow")
+    : G4CMPVProcess(name, fPhononWeightWindow) {;}
+  virtual ~G4CMPPhononWeightWindow() {;}
+
+  virtual G4bool IsApplicable(const G4ParticleDefinition& pd);
+
+  virtual G4double 
+  PostStepGetPhysicalInteractionLength(const G4Track&, G4double,
+				       G4ForceCondition*);
+
+  virtual G4VParticleChange* PostStepDoIt(const G4Track&, const G4Step&);
+
+protected:
+  virtual G4double GetMeanFreePath(const G4Track&,G4double,G4ForceCondition*);
+
+  // Replace track with average of "ratio" copies, or keep with that chance
+  void SplitTrack(const G4Track& track, G4double ratio);
+  void RouletteTrack(const G4Track& track, G4double ratio);
+
+  // Copy of track at current point, with its own wavevector info
+  G4Track* CloneTrack(const G4Track& track, G4double weight) const;
+
+private:
+  G4CMPPhononWeightWindow(const G4CMPPhononWeightWindow&);	// Copying is forbidden
+  G4CMPPhononWeightWindow& operator=(const G4CMPPhononWeightWindow&);
+};
+
+#endif	/* G4CMPPhononWeightWindow_hh */
@@ -9,6 +9,7 @@
 // 20200331 C. Stanford G4CMP-195:  Add Trapping and Impact subtypes
 // 20200501 G4CMP-196: Need separate processes for A- and D- charge traps
 // 20200504 M. Kelsey -- Remove impact subtype here; set values explicitly
+// 20261017 Add subtype for phonon weight-window (splitting/roulette)
 
 #ifndef G4CMPProcessSubType_hh
 #define G4CMPProcessSubType_hh 1
@@ -31,7 +32,8 @@ enum G4CMPProcessSubType {
   fChargeRecombine = 310,
   fDTrapIonization = 311,
   fATrapIonization = 312,
-  fChargeTrapping = 313
+  fChargeTrapping = 313,
+  fPhononWeightWindow = 314
 };
 
 #endif	/* G4CMPProcessSubType_hh */
@@ -37,6 +37,7 @@
 // 20201124  Change argument name in MakeGlobalRecoil() to 'krecoil' (track)
 // 20201223  Add FindNearestValley() function to align electron momentum.
 // 20240303  Add local currentTouchable pointer for non-tracking situations.
+// 20261017  Add UseStepContext() to share per-step kinematics of current track
 
 #ifndef G4CMPProcessUtils_hh
 #define G4CMPProcessUtils_hh 1
@@ -256,6 +257,9 @@ private:
   const G4Track* currentTrack;		// For use by Start/EndTracking
   const G4VPhysicalVolume* currentVolume;
 
+  // Current track may use cached values from G4CMPStepContext
+  G4bool UseStepContext(const G4Track& track) const;
+
   // May be created by GetCurrentTouchable() for internal use with primaries
   void ClearTouchable() const;
   mutable const G4VTouchable* currentTouchable;
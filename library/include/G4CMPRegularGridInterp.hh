@@ -0,0 +1,107 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// $Id$
+//
+// G4CMPRegularGridInterp:  Potential and gradient from a tetrahedral mesh,
+// resampled once onto a uniform rectangular grid.  Points are located
+// by direct indexing, and evaluated by trilinear interpolation of the
+// eight surrounding grid nodes, without any search through tetrahedra.
+// The gradient is that of the interpolated potential within each cell, so
+// that sliver tetrahedra at the mesh surface don't distort nearby nodes.
+//
+// Grid cells which extend outside the mesh hull (e.g., at curved detector
+// surfaces) are evaluated with the original tetrahedral mesh instead, so
+// that field values near the boundary are not distorted.  Accuracy in the
+// interior is limited by the grid spacing.
+//
+// 20261017  Adapted from TriLinearInterp, for use with G4CMPMeshElectricField
+
+#ifndef G4CMPRegularGridInterp_h
+#define G4CMPRegularGridInterp_h
+
+#include "G4CMPVMeshInterpolator.hh"
+#include "G4ThreeVector.hh"
+#include <array>
+#include <memory>
+#include <vector>
+#include <stdint.h>
+
+class G4CMPTriLinearInterp;
+
+
+class G4CMPRegularGridInterp : public G4CMPVMeshInterpolator {
+public:
+  // Resample source mesh with given node spacing; if "resample" is false,
+  // user MUST call Resample() or LoadCache() before use
+  G4CMPRegularGridInterp(const G4CMPTriLinearInterp& source, G4double step,
+			 G4bool resample=true);
+
+  // Cloning function to allow making type-matched copies
+  // NOTE: Copies share the (read-only) grid tables with the original
+  virtual G4CMPVMeshInterpolator* Clone() const {
+    return new G4CMPRegularGridInterp(*this);
+  }
+
+  G4CMPRegularGridInterp(const G4CMPRegularGridInterp& rhs);
+  virtual ~G4CMPRegularGridInterp();
+
+  // Evaluate source mesh at grid nodes (done by constructor by default)
+  void Resample() { FillGradients(); }
+
+  // Replace values at source mesh points, and resample grid
+  void UseValues(const std::vector<G4double>& v);
+
+  // Evaluate grid at arbitrary location, optionally suppressing errors
+  G4double GetValue(const G4double pos[], G4bool quiet=false) const;
+  G4ThreeVector GetGrad(const G4double pos[], G4bool quiet=false) const;
+
+  // Grid lookups don't depend on ordering, so no sorting is done here
+  void GetValuesAndGrads(const std::vector<point3d>& pos,
+			 std::vector<G4double>& values,
+			 std::vector<G4ThreeVector>& grads,
+			 G4bool quiet=false) const;
+
+  G4double GetStep() const { return GridStep; }
+  const G4CMPTriLinearInterp* GetSource() const { return Source; }
+
+  // Grid nodes and values are written; tetrahedra come from source mesh
+  void SavePoints(const G4String& fname) const;
+  void SaveTetra(const G4String& fname) const;
+
+  // Binary cache of grid tables, to skip resampling in later jobs
+  // NOTE: sourceKey identifies the source mesh; LoadCache() rejects a file
+  //       with a different key or grid spacing
+  G4bool SaveCache(const G4String& fname, uint64_t sourceKey=0) const;
+  G4bool LoadCache(const G4String& fname, uint64_t sourceKey=0);
+
+protected:
+  void FillGradients();		// Evaluate potential at grid nodes
+
+private:
+  // Grid tables are never modified once built, so that one copy may be
+  // used by all worker threads
+  struct GridTables {
+    point3d Min;			// Position of first node
+    point3d Step;			// Node spacing along each axis
+    point3d InvStep;
+    std::array<G4int,3> Dim;		// Number of cells along each axis
+    std::vector<G4double> Nodes;	// Potential at each node
+    std::vector<char> CellGood;		// All eight nodes are inside hull
+  };
+
+  std::shared_ptr<GridTables> Grid;
+  G4CMPTriLinearInterp* Source;		// Used for cells touching the hull
+  G4double GridStep;			// Requested node spacing
+
+  // Interpolate V and gradient (in that order) at point, or return false
+  // if point is in a cell outside of, or crossing, the source mesh hull
+  G4bool Interpolate(const G4double pos[3], G4double result[4]) const;
+
+  // Not implemented
+  G4CMPRegularGridInterp& operator=(const G4CMPRegularGridInterp&);
+};
+
+#endif	/* G4CMPRegularGridInterp_h */
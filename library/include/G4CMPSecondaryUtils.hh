@@ -14,6 +14,7 @@
 // 20170815 M. Kelsey -- Move AdjustSecondaryPosition to GeometryUtils
 // 20170928 M. Kelsey -- Replace "polarization" with "mode"
 // 20220907 G4CMP-316 -- Pass track into CreateXYZ() functions.
+// 20261017 Add CreatePhonon() taking precomputed group velocity vector
 
 #ifndef G4CMPSecondaryUtils_hh
 #define G4CMPSecondaryUtils_hh 1
@@ -33,6 +34,12 @@ namespace G4CMP {
   G4Track* CreatePhonon(const G4Track& track, G4int mode,
 			const G4ThreeVector& waveVec, G4double energy,
 			G4double time, const G4ThreeVector& pos);
+
+  // Group velocity vgLocal (from MapKtoVg) is in track's local coordinates
+  G4Track* CreatePhonon(const G4Track& track, G4int mode,
+			const G4ThreeVector& waveVec,
+			const G4ThreeVector& vgLocal, G4double energy,
+			G4double time, const G4ThreeVector& pos);
   
   G4Track* CreateChargeCarrier(const G4Track& track, G4int charge,
 			       G4int valley, G4double Ekin, G4double time,
@@ -0,0 +1,95 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file library/include/G4CMPStepContext.hh
+/// \brief Definition of the G4CMPStepContext class.  Caches per-step
+///	   quantities (lattice, local position and kinematics, electric
+///	   field) for the current track, so that the several G4CMP
+///	   processes and rate models evaluated on each step share a single
+///	   computation.  Quantities are filled on first use, and discarded
+///	   when the track, its step number, or its kinematics change.
+///
+///	   Use via G4CMPStepContext::Get(track), which returns the context
+///	   for the current worker thread.
+//
+// $Id$
+//
+// 20261017  New class to share field and kinematics among drift processes
+// 20261017  Use G4ThreadLocalSingleton for per-thread instance
+
+#ifndef G4CMPStepContext_hh
+#define G4CMPStepContext_hh 1
+
+#include "globals.hh"
+#include "G4ThreadLocalSingleton.hh"
+#include "G4ThreeVector.hh"
+
+class G4LatticePhysical;
+class G4Track;
+class G4VTouchable;
+
+
+class G4CMPStepContext {
+public:
+  // Return thread-local context, refreshed if track or step has changed
+  static G4CMPStepContext& Get(const G4Track& track);
+  static G4CMPStepContext& Get(const G4Track* track) { return Get(*track); }
+
+  // Discard cached values; call after modifying track kinematics directly
+  static void Invalidate();
+
+  // Track for which values are being cached (may be null)
+  const G4Track* GetTrack() const { return track; }
+
+  // NOTE:  Accessors are non-const, because they fill cache on first use
+  const G4LatticePhysical* GetLattice();
+
+  const G4ThreeVector& GetField();		// _Global_ coordinates
+  const G4ThreeVector& GetLocalPosition();
+  const G4ThreeVector& GetLocalVelocity();
+  const G4ThreeVector& GetLocalMomentum();	// Charge carriers only
+  const G4ThreeVector& GetLocalWaveVector();
+  G4double GetKineticEnergy();
+  G4int GetValleyIndex();			// -1 for holes and phonons
+
+private:
+  friend class G4ThreadLocalSingleton<G4CMPStepContext>;
+
+  G4CMPStepContext();
+  ~G4CMPStepContext() {;}
+  static G4CMPStepContext& Instance();
+
+  G4bool IsCurrent(const G4Track& trk) const;	// Compare key to track
+  void Reset(const G4Track& trk);		// Load new key, clear cache
+
+  // Flags to indicate which values have been filled
+  enum { kLattice=1, kField=2, kPosition=4, kVelocity=8, kMomentum=16,
+	 kWaveVector=32, kEnergy=64, kValley=128 };
+
+  G4bool Has(G4int item) const { return (filled & item) != 0; }
+
+  // Key identifying track and step for which cache is valid
+  const G4Track* track;
+  G4int trackID;
+  G4int stepNumber;
+  const G4VTouchable* touchable;
+  G4ThreeVector position;		// Global position and kinematics
+  G4ThreeVector direction;
+  G4double trackEkin;
+
+  G4int filled;				// Bitmask of above flags
+
+  // Cached quantities
+  const G4LatticePhysical* lattice;
+  G4ThreeVector field;
+  G4ThreeVector localPos;
+  G4ThreeVector localVel;
+  G4ThreeVector localP;
+  G4ThreeVector localK;
+  G4double kinEnergy;
+  G4int valley;
+};
+
+#endif	/* G4CMPStepContext_hh */
@@ -0,0 +1,94 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file library/include/G4CMPTabulatedRate.hh
+/// \brief Definition of the G4CMPTabulatedRate class.  Wraps any rate
+///	   model which supports tabulation (see G4CMPVScatteringRate), and
+///	   returns the rate by linear interpolation in a table of the model
+///	   versus its kinematic variable.
+///
+///	   A table is filled for each lattice and channel on first use, on
+///	   a uniform grid from zero to the model's RateVariableScale().  If
+///	   a larger value is requested, the table range is doubled (up to
+///	   a limit, beyond which the model is called directly).
+///
+///	   Each table is checked against the model at the midpoint of every
+///	   bin.  If the largest deviation, relative to the largest rate in
+///	   the table, exceeds the tolerance, the number of bins is doubled.
+///	   If the table still fails with 16 times the initial bins, a warning
+///	   is issued and the model is used directly for that table.
+//
+// $Id$
+//
+// 20261017  New class, for use with G4CMPVProcess rate models
+
+#ifndef G4CMPTabulatedRate_hh
+#define G4CMPTabulatedRate_hh 1
+
+#include "G4CMPVScatteringRate.hh"
+#include <map>
+#include <utility>
+#include <vector>
+
+class G4LatticePhysical;
+
+
+class G4CMPTabulatedRate : public G4CMPVScatteringRate {
+public:
+  // NOTE:  Takes ownership of model for deletion
+  G4CMPTabulatedRate(G4CMPVScatteringRate* model, size_t nBins=1024,
+		     G4double tolerance=0.01);
+  virtual ~G4CMPTabulatedRate();
+
+  virtual G4double Rate(const G4Track& aTrack) const;
+
+  virtual G4double Threshold(G4double Eabove=0.) const {
+    return model->Threshold(Eabove);
+  }
+
+  // Keep wrapped model synchronized with current track
+  virtual void LoadDataForTrack(const G4Track* track);
+  virtual void ReleaseTrack();
+
+  const G4CMPVScatteringRate* GetModel() const { return model; }
+
+  // Interpolated rate for variable, in current lattice
+  G4double Interpolate(G4double x, G4int chan=0) const;
+
+  // Largest deviation from model found in check of current table
+  G4double GetMaxError(G4int chan=0) const;
+
+protected:
+  struct Table {
+    G4double xMax;			// Upper edge of uniform grid
+    G4double xLimit;			// Largest range allowed for table
+    G4double invStep;			// Bins per unit of variable
+    G4double maxError;			// Relative to largest rate
+    G4bool valid;			// False if accuracy check failed
+    std::vector<G4double> rate;		// Rate at each grid point
+    Table()
+      : xMax(0.), xLimit(0.), invStep(0.), maxError(0.), valid(false) {;}
+  };
+
+  // Get table for current lattice, filling or extending range as needed
+  const Table& GetTable(G4double x, G4int chan) const;
+  void FillTable(Table& table, G4double xMax, G4int chan) const;
+
+private:
+  G4CMPVScatteringRate* model;
+  size_t nBins;				// Initial bins in each table
+  G4double tolerance;			// Allowed deviation from model
+
+  typedef std::pair<const G4LatticePhysical*, G4int> TableKey;
+  mutable std::map<TableKey, Table> tables;
+  mutable TableKey lastKey;		// Most recently used table
+  mutable Table* lastTable;
+
+  // No copying allowed
+  G4CMPTabulatedRate(const G4CMPTabulatedRate&);
+  G4CMPTabulatedRate& operator=(const G4CMPTabulatedRate&);
+};
+
+#endif	/* G4CMPTabulatedRate_hh */
@@ -19,6 +19,20 @@
 //		Add "quiet" argument to MatInv to suppress warnings.
 // 20200908  Replace four-arg ctor and UseMesh() with copy constructor.
 // 20200914  Include gradient precalculation in BuildTInverse action.
+// 20261017  Add uniform-grid index of tetrahedra to seed FindTetrahedron().
+// 20261017  Add binary cache of mesh tables, SaveCache() and LoadCache().
+// 20261017  Move mesh tables to shared, read-only MeshTables block; copies
+//		share tables, only search state is per-instance.
+// 20261017  Add GetValuesAndGrads() with one tetrahedron search per point.
+// 20261017  Pack per-tetrahedron search data into TetraRecord; drop TExtend.
+//		Build with G4CMP_MESH_FLOAT for single-precision records.
+// 20261017  Add GetValueAndGrad() with hull test, and GetBoundingBox(),
+//		for resampling onto G4CMPRegularGridInterp.
+// 20261017  Drop Tetra0xx lists and FindNeighbor(); facets matched in bulk.
+// 20261017  Keep Origin in double precision; add barySafety scaled to the
+//		precision of MeshReal.
+// 20261017  ReadCache() reads tables from stream, not a mapped image.
+// 20261017  Keep Grad in double precision with Origin, as documented.
 
 #ifndef G4CMPTriLinearInterp_h 
 #define G4CMPTriLinearInterp_h 
@@ -28,6 +42,8 @@
 #include <vector>
 #include <map>
 #include <array>
+#include <memory>
+#include <stdint.h>
 
 // Convenient abbreviations, available to subclasses and client code
 using mat3x3 = std::array<std::array<G4double,3>,3>;
@@ -36,7 +52,8 @@ using mat4x3 = std::array<std::array<G4double,3>,4>;
 class G4CMPTriLinearInterp : public G4CMPVMeshInterpolator {
 public:
   // Uninitialized version; user MUST call UseMesh()
-  G4CMPTriLinearInterp() : G4CMPVMeshInterpolator("TRI") {;}
+  G4CMPTriLinearInterp()
+    : G4CMPVMeshInterpolator("TRI"), Mesh(std::make_shared<MeshTables>()) {;}
 
   // Mesh coordinates and values only; uses QHull to generate triangulation
   G4CMPTriLinearInterp(const std::vector<point3d>& xyz,
@@ -48,6 +65,7 @@ public:
 		       const std::vector<tetra3d>& tetra);
 
   // Cloning function to allow making type-matched copies
+  // NOTE: Copies share the (read-only) mesh tables with the original
   virtual G4CMPVMeshInterpolator* Clone() const {
     return new G4CMPTriLinearInterp(*this);
   }
@@ -60,51 +78,90 @@ public:
   void UseMesh(const std::vector<point3d>& xyz, const std::vector<G4double>& v,
 	       const std::vector<tetra3d>& tetra);
 
+  // Replace values at mesh points; copies tables first if they are shared
+  void UseValues(const std::vector<G4double>& v);
+
   // Evaluate mesh at arbitrary location, optionally suppressing errors
   G4double GetValue(const G4double pos[], G4bool quiet=false) const;
   G4ThreeVector GetGrad(const G4double pos[], G4bool quiet=false) const;
 
+  // Evaluate both potential and gradient with one search per point
+  void GetValuesAndGrads(const std::vector<point3d>& pos,
+			 std::vector<G4double>& values,
+			 std::vector<G4ThreeVector>& grads,
+			 G4bool quiet=false) const;
+
+  // Evaluate both at one point; returns false if point is outside hull
+  G4bool GetValueAndGrad(const G4double pos[], G4double& value,
+			 G4ThreeVector& grad) const;
+
+  // Corners of box enclosing all mesh points
+  void GetBoundingBox(point3d& xmin, point3d& xmax) const;
+
   void SavePoints(const G4String& fname) const;
   void SaveTetra(const G4String& fname) const;
 
+  // Binary cache of all mesh tables, to skip triangulation in later jobs
+  // NOTE: sourceKey identifies the mesh input; LoadCache() rejects a file
+  //       with a different key, or from an incompatible version or system
+  G4bool SaveCache(const G4String& fname, uint64_t sourceKey=0) const;
+  G4bool LoadCache(const G4String& fname, uint64_t sourceKey=0);
+
 protected:
   void FillGradients();		// Compute gradient (field) at each tetrahedron
 
 private:
-  std::vector<point3d> X;
-  std::vector<tetra3d> Tetrahedra;
-  std::vector<tetra3d> Neighbors;
-  std::vector<mat3x3> TInverse;		// Matrix for barycenter calculation
-  std::vector<mat4x3> TExtend;		// Matrix for gradient calculation
-  std::vector<G4bool> TInvGood;		// Flags for noninvertible matrix
+  // Mesh tables are never modified once built, so that one copy may be
+  // used by all worker threads; only TetraIdx is specific to an instance
+#ifdef G4CMP_MESH_FLOAT
+  using MeshReal = G4float;		// Halves size of search records
+#else
+  using MeshReal = G4double;
+#endif
+
+  // Tolerance for points on facets, scaled to precision of TInverse
+  static const G4double barySafety;
+
+  // Everything needed to search or evaluate one tetrahedron, in one place
+  struct TetraRecord {
+    std::array<std::array<MeshReal,3>,3> TInverse;	// For barycenter calc
+    point3d Origin;			// Coordinates of fourth vertex
+    point3d Grad;			// Gradient (field) across tetrahedron
+    tetra3d Neighbors;			// Tetrahedron opposite each vertex
+    G4int TInvGood;			// Flag for noninvertible matrix
+  };
+
+  struct MeshTables {
+    std::vector<point3d> X;
+    std::vector<G4double> V;		// Values at mesh points
+    std::vector<tetra3d> Tetrahedra;
+    std::vector<TetraRecord> Records;	// Search data for each tetrahedron
+
+    // Uniform grid over mesh bounding box, used to start tetrahedral searches
+    point3d GridMin;			// Low corner of bounding box
+    point3d GridInvStep;		// Inverse of cell size along each axis
+    std::array<G4int,3> GridDim;	// Number of cells along each axis
+    std::vector<G4int> GridTetra;	// Tetrahedron index near each cell
+  };
+
+  std::shared_ptr<MeshTables> Mesh;
 
   mutable std::map<G4int,G4int> qhull2x;	// Used by QHull for meshing
 
-  // Lists of tetrahedra with shared vertices, for generating neighbors table
-  std::vector<tetra3d> Tetra012;	// Duplicate tetrahedra lists
-  std::vector<tetra3d> Tetra013;	// Sorted on vertex triplets
-  std::vector<tetra3d> Tetra023;
-  std::vector<tetra3d> Tetra123;
-
   void BuildTetraMesh();	// Builds mesh from pre-initialized 'X' array
   void FillNeighbors();		// Generate Neighbors table from tetrahedra
   void FillTInverse();		// Compute inverse matrices for Cart2Bary()
+  void FillGridIndex();		// Assign nearby tetrahedron to each grid cell
 
-  // Function pointer for comparison operator to use search for facets
-  using TetraComp = G4bool(*)(const tetra3d&, const tetra3d&);
-
-  G4int FindNeighbor(const std::array<G4int,3>& facet, G4int skip) const;
-  G4int FindTetraID(const std::vector<tetra3d>& tetras,
-		    const tetra3d& wildTetra, G4int skip,
-		    TetraComp tLess) const;
   G4int FirstInteriorTetra();	// Lowest tetra index with all facets shared
+  G4int GridStartTetra(const G4double point[3]) const;	// -1 if unavailable
 
   void FindTetrahedron(const G4double point[3], G4double bary[4],
 		       G4bool quiet=false) const;
   G4int FindPointID(const std::vector<G4double>& point, const G4int id) const;
 
   G4bool Cart2Bary(const G4double point[3], G4double bary[4]) const;
-  G4bool BuildT4x3(size_t itet, mat4x3& ET) const;
+  G4bool BuildT4x3(size_t itet, mat4x3& ET) const;	// For gradients
 
   G4bool MatInv(const mat3x3& matrix, mat3x3& result, G4bool quiet=false) const;
   G4double BaryNorm(G4double bary[4]) const;
@@ -112,6 +169,9 @@ private:
 
   // Dump tetrahedron information (neighbors and vertices)
   void PrintTetra(std::ostream& os, G4int iTetra) const;
+
+  // Unpack tables from cache file of given length
+  G4bool ReadCache(std::istream& cache, size_t length, uint64_t sourceKey);
 };
 
 #endif	/* G4CMPTriLinearInterp */
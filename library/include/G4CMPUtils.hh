@@ -16,12 +16,16 @@
 // 20190906  Add function to get process associated with particle
 // 20220816  Move RandomIndex function from SecondaryProduction
 // 20220921  G4CMP-319 -- Add utilities for thermal (Maxwellian) distributions
+// 20261017  Add HashBytes() to build keys for binary cache files
+// 20261017  Add CacheFileHeader and WriteCacheFile() shared by cache writers
 
 #ifndef G4CMPUtils_hh
 #define G4CMPUtils_hh 1
 
 #include "G4ThreeVector.hh"
 #include "globals.hh"
+#include <cstdint>
+#include <initializer_list>
 
 class G4CMPElectrodeHit;
 class G4LatticePhysical;
@@ -97,6 +101,35 @@ namespace G4CMP {
 
   // Generate integer random value [0, imax), used to shuffle vectors
   size_t RandomIndex(size_t imax);
+
+  // FNV-1a hash of a block of memory, used to key binary cache files;
+  // pass a previous result as seed to hash several blocks together
+  uint64_t HashBytes(const void* data, size_t nbytes,
+		     uint64_t seed=14695981039346656037ULL);
+
+  // Leading fields of every binary cache file, followed by a header
+  // specific to the file type; magic is eight characters, not terminated
+  struct CacheFileHeader {
+    char     magic[8];
+    uint32_t version;		// Must be incremented with any layout change
+    uint32_t byteOrder;		// Detects files from other architectures
+    uint64_t key;		// Identifies inputs (file, scale, binning)
+  };
+
+  void FillCacheHeader(CacheFileHeader& head, const char* magic,
+		       uint32_t version, uint64_t key);
+  G4bool IsValidCacheHeader(const CacheFileHeader& head, const char* magic,
+			    uint32_t version, uint64_t key);
+
+  // Write blocks of memory, in order, to temporary file which is renamed
+  // to fname when complete, so that other jobs never see a partial file
+  struct CacheBlock {
+    const void* data;
+    size_t nbytes;
+  };
+
+  G4bool WriteCacheFile(const G4String& fname,
+			std::initializer_list<CacheBlock> blocks);
 }
 
 #endif	/* G4CMPUtils_hh */
@@ -13,6 +13,8 @@
 //
 // 20200908  Add operator<<() to print matrices (array of array)
 // 20200914  Drop cachedGrad, staleCache; subclasses will precompute field.
+// 20261017  Move V, Grad to subclasses, so TriLinear can share mesh tables.
+// 20261017  Add GetValues(), GetGrads() to evaluate many points at once.
 
 #ifndef G4CMPVMeshInterpolator_h 
 #define G4CMPVMeshInterpolator_h 
@@ -42,11 +44,11 @@ public:
   virtual G4CMPVMeshInterpolator* Clone() const = 0;
 
 public:
-  // Replace values at mesh points without rebuilding tables
-  void UseValues(const std::vector<G4double>& v);
-
   // Subclasses MUST implement these functions for their dimensionality
 
+  // Replace values at mesh points without rebuilding tables
+  virtual void UseValues(const std::vector<G4double>& v) = 0;
+
   // Replace existing mesh vectors and tetrahedra table
   // NOTE: Both 2D and 3D versions are given, subclasses should implement one
   void UseMesh(const std::vector<point3d>& /*xyz*/,
@@ -61,6 +63,20 @@ public:
   virtual G4double GetValue(const G4double pos[], G4bool quiet=false) const = 0;
   virtual G4ThreeVector GetGrad(const G4double pos[], G4bool quiet=false) const = 0;
 
+  // Evaluate mesh at list of locations; results are in same order as input
+  // NOTE: Points are visited in spatial order to keep mesh searches short;
+  //       2D subclasses ignore the third coordinate.
+  virtual void GetValues(const std::vector<point3d>& pos,
+			 std::vector<G4double>& values,
+			 G4bool quiet=false) const;
+  virtual void GetGrads(const std::vector<point3d>& pos,
+			std::vector<G4ThreeVector>& grads,
+			G4bool quiet=false) const;
+  virtual void GetValuesAndGrads(const std::vector<point3d>& pos,
+				 std::vector<G4double>& values,
+				 std::vector<G4ThreeVector>& grads,
+				 G4bool quiet=false) const;
+
   // Write out mesh coordinates and tetrahedra table to text files
   virtual void SavePoints(const G4String& fname) const = 0;
   virtual void SaveTetra(const G4String& fname) const = 0;
@@ -68,9 +84,14 @@ public:
 protected:		// Data members available to subclasses directly
   virtual void FillGradients() = 0;	// Subclasses MUST implement this
 
-  std::vector<G4double> V;		// Values at mesh points
-  std::vector<G4ThreeVector> Grad;	// Gradients across tetrahedra
-  // NOTE: Subclasses must define dimensional mesh coords and tetrahera
+  // Report error and return false if replacement values don't match mesh
+  G4bool CheckValues(const std::vector<G4double>& v, size_t npts) const;
+
+  // Fill order[] with indices of pos[] sorted along Morton (Z-order) curve
+  static void SpatialOrder(const std::vector<point3d>& pos,
+			   std::vector<size_t>& order);
+
+  // NOTE: Subclasses must define mesh coords, values, and tetrahedra
 
   mutable G4int TetraIdx;		// Last tetrahedral index used
   G4int TetraStart;			// Start of tetrahedral searches
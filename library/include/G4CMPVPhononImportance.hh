@@ -0,0 +1,56 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file library/include/G4CMPVPhononImportance.hh
+/// \brief Definition of the G4CMPVPhononImportance base class
+///
+/// Abstract base class to define an "importance map" for phonon tracks,
+/// used by G4CMPPhononWeightWindow to split phonons moving into regions
+/// of higher importance, and to play Russian roulette with phonons moving
+/// into regions of lower importance.  Only ratios of importance matter.
+///
+/// Subclasses must implement GetImportance().  Piecewise-constant "bands"
+/// of importance versus some track quantity may be configured with
+/// AddBand(), and looked up with BandImportance().
+///
+/// Register an instance with G4CMPConfigManager::SetPhononImportance().
+/// The same instance is shared by all worker threads, so GetImportance()
+/// must not modify the object.
+//
+// $Id$
+//
+// 20261017  New class, for use with G4CMPPhononWeightWindow
+
+#ifndef G4CMPVPhononImportance_hh
+#define G4CMPVPhononImportance_hh 1
+
+#include "G4Types.hh"
+#include <utility>
+#include <vector>
+
+class G4Track;
+
+
+class G4CMPVPhononImportance {
+public:
+  G4CMPVPhononImportance() {;}
+  virtual ~G4CMPVPhononImportance() {;}
+
+  // Return relative importance of phonon at current point; zero to kill
+  virtual G4double GetImportance(const G4Track& track) const = 0;
+
+  // Importance applies from lower edge up to next band's lower edge;
+  // quantities below the first band have unit importance
+  void AddBand(G4double lower, G4double importance);
+  void ClearBands() { bands.clear(); }
+
+protected:
+  G4double BandImportance(G4double value) const;
+
+private:
+  std::vector<std::pair<G4double,G4double> > bands;	// Sorted by edge
+};
+
+#endif	/* G4CMPVPhononImportance_hh */
@@ -14,6 +14,7 @@
 //
 // 20170815  Inherit from G4CMPProcessUtils here, instead of in subclasses
 // 20170919  Add "threshold finder" interface, for use with IV and Luke
+// 20261017  Add single-variable interface, for use with G4CMPTabulatedRate
 
 #ifndef G4CMPVScatteringRate_hh
 #define G4CMPVScatteringRate_hh 1
@@ -43,6 +44,21 @@ public:
   // Interface to identify energy thresholds (for IV, Luke subclasses)
   virtual G4double Threshold(G4double /*Eabove*/=0.) const { return 0.; }
 
+  // Interface for tabulation (see G4CMPTabulatedRate).  Subclasses where
+  // the rate, for a given lattice and "channel" (e.g., electron or hole),
+  // depends on a single kinematic variable may implement these, so that
+  // Rate(trk) == RateFromVariable(RateVariable(trk), RateChannel(trk)).
+  // RateVariable() should return a negative value if the rate is zero.
+  virtual G4bool CanTabulate() const { return false; }
+  virtual G4int RateChannel(const G4Track& /*aTrack*/) const { return 0; }
+  virtual G4double RateVariable(const G4Track& /*aTrack*/) const { return 0.; }
+  virtual G4double RateFromVariable(G4double /*x*/, G4int /*chan*/=0) const {
+    return 0.;
+  }
+
+  // Typical range [0,scale] of variable, for initial table in current lattice
+  virtual G4double RateVariableScale(G4int /*chan*/=0) const { return 0.; }
+
   // Flag if interaction should be forced (subclasses should set flag)
 
   G4bool IsForced() { return isForced; }
@@ -39,6 +39,9 @@
 // 20200608  Fix -Wshadow warnings from tempvec
 // 20210919  M. Kelsey -- Allow SetVerboseLevel() from const instances.
 // 20231017  E. Michaud -- Add 'AddValley(const G4ThreeVector&)' 
+// 20261017  Add batch MapKtoVg() for arrays of phonon wavevectors
+// 20261017  Save and reuse K-Vg map in binary cache, keyed to elasticity
+// 20261017  Add GetCrystal(), for symmetry reduction of kinematics table
 
 #ifndef G4LatticeLogical_h
 #define G4LatticeLogical_h
@@ -48,6 +51,7 @@
 #include "G4ThreeVector.hh"
 #include "G4RotationMatrix.hh"
 #include "G4PhononPolarization.hh"
+#include <cstdint>
 #include <iosfwd>
 #include <vector>
 
@@ -82,6 +86,13 @@ public:
   // Dump structure in format compatible with reading back
   void Dump(std::ostream& os) const;
 
+  // Hash of inputs to phonon kinematics (elasticity, density), for caches
+  uint64_t GetKinematicsKey() const;
+
+  // Cache file name in G4CMPConfigManager::GetKinCacheDir() for given key,
+  // or empty string if caching is disabled
+  G4String GetKinCacheName(uint64_t key, const G4String& suffix) const;
+
   // Get group velocity magnitude, direction for input polarization and wavevector
   // NOTE:  Wavevector must be in lattice symmetry frame (X == symmetry axis)
   virtual G4ThreeVector MapKtoVg(G4int mode, const G4ThreeVector& k) const;
@@ -94,6 +105,12 @@ public:
     return MapKtoVg(mode,k).unit();
   }
 
+  // Batch version of MapKtoVg() for n phonons, with wavevector and group
+  // velocity passed as separate component arrays (length n)
+  virtual void MapKtoVg(size_t n, const G4int* mode, const G4double* kx,
+			const G4double* ky, const G4double* kz,
+			G4double* vx, G4double* vy, G4double* vz) const;
+
   // Convert between electron momentum and valley velocity or HV wavevector
   // NOTE:  Input vector must be in lattice symmetry frame (X == symmetry axis)
   G4ThreeVector MapPtoV_el(G4int ivalley, const G4ThreeVector& p_e) const;
@@ -113,6 +130,7 @@ public:
   // Configure crystal symmetry group and lattice spacing/angles
   void SetCrystal(G4CMPCrystalGroup::Bravais group, G4double a, G4double b,
 		  G4double c, G4double alpha, G4double beta, G4double gamma);
+  const G4CMPCrystalGroup& GetCrystal() const { return fCrystal; }
 
   // Get specified basis vector (returns null if invalid index)
   const G4ThreeVector& GetBasis(G4int i) const {
@@ -273,6 +291,8 @@ private:
   void CheckBasis();	// Initialize or complete (via cross) basis vectors
   void FillElasticity();	// Unpack reduced Cij into full Cijlk
   void FillMaps();	// Populate lookup tables using kinematics calculator
+  G4bool LoadMaps(const G4String& fname, uint64_t key);	// Binary cache
+  G4bool SaveMaps(const G4String& fname, uint64_t key) const;
   void FillMassInfo();	// Called from SetMassTensor() to compute derived forms
 
   // Get theta, phi bins and offsets for interpolation
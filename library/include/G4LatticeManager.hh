@@ -12,14 +12,19 @@
 // 20131115  Drop lattice counters, not used anywhere
 // 20140412  Use const volumes and materials for registration
 // 20141008  Change to global singleton; must be shared across worker threads
+// 20261017  Lock-free lookups through flat index, rebuilt on registration
 
 #ifndef G4LatticeManager_h
 #define G4LatticeManager_h 1
 
 
 #include "G4ThreeVector.hh"
+#include <atomic>
 #include <map>
+#include <memory>
 #include <set>
+#include <utility>
+#include <vector>
 
 class G4LatticeLogical;
 class G4LatticePhysical;
@@ -29,7 +34,7 @@ class G4VPhysicalVolume;
 
 class G4LatticeManager {
 private:
-  static G4LatticeManager* fLM;		// Singleton
+  static std::atomic<G4LatticeManager*> fLM;	// Singleton
 
 public:
   static G4LatticeManager* GetLatticeManager(); 
@@ -83,6 +88,26 @@ protected:
   LatticePhyReg fPLattices;	// Registry of unique lattice pointers
   LatticeVolMap fPLatticeList; 
 
+  // Read-only copy of lookup tables for use during tracking.  Lattices are
+  // registered during geometry construction, so the index is rebuilt and
+  // published at each registration and never modified afterward; lookups
+  // need neither the mutex nor a map search.
+  struct LatticeIndex {
+    G4LatticePhysical* defaultLattice = nullptr;
+
+    // Indexed by G4VPhysicalVolume::GetInstanceID(), G4Material::GetIndex()
+    std::vector<std::pair<const G4VPhysicalVolume*,G4LatticePhysical*> > byVolume;
+    std::vector<std::pair<const G4Material*,G4LatticeLogical*> > byMaterial;
+  };
+
+  void PublishIndex();		// Must be called with mutex held
+
+  // Lookup in published index without diagnostic output
+  G4LatticePhysical* FindLattice(const G4VPhysicalVolume*) const;
+
+  std::atomic<const LatticeIndex*> fIndex;
+  std::vector<std::unique_ptr<LatticeIndex> > fIndexHistory;	// Owned
+
 private:
   G4LatticeManager();
   virtual ~G4LatticeManager();
@@ -36,6 +36,7 @@
 // 20210919  M. Kelsey -- Allow SetVerboseLevel() from const instances.
 // 20220921  G4CMP-319 -- Add utilities for thermal (Maxwellian) distributions
 //		Also, add long missing accessors for Miller orientation
+// 20261017  Add MapKtoVg(), single and batch, for full group velocity
 
 #ifndef G4LatticePhysical_h
 #define G4LatticePhysical_h 1
@@ -44,6 +45,7 @@
 #include "G4RotationMatrix.hh"
 #include "G4ThreeVector.hh"
 #include <iosfwd>
+#include <vector>
 
 #define G4CMP_HAS_TEMPERATURE	/* G4CMP-319 -- New feature for user code */
 
@@ -81,6 +83,14 @@ public:
   G4double      MapKtoV(G4int mode, const G4ThreeVector& k) const;
   G4ThreeVector MapKtoVDir(G4int mode, const G4ThreeVector& k) const;
 
+  // Full group velocity (magnitude and direction) from a single lookup
+  G4ThreeVector MapKtoVg(G4int mode, const G4ThreeVector& k) const;
+
+  // Group velocities for many phonons in one pass; output vector is resized
+  void MapKtoVg(const std::vector<G4int>& mode,
+		const std::vector<G4ThreeVector>& k,
+		std::vector<G4ThreeVector>& vg) const;
+
   // Convert between electron momentum and valley velocity or HV wavevector
   // NOTE:  p or v_el vector must be in local (G4VSolid) coordinate system
   // NOTE:  K_HV vector must be in valley internal coordinate system
@@ -16,6 +16,7 @@
 //		Replace four-arg ctor and UseMesh() with copy constructor.
 // 20200914  Include TExtend precalculation in FillTInverse action.
 // 20201002  Report tetrahedra errors during FillTInverse() initialization.
+// 20261017  Implement UseValues() here, moved from base class.
 
 #include "G4CMPBiLinearInterp.hh"
 #include "G4CMPConfigManager.hh"
@@ -108,6 +109,19 @@ void G4CMPBiLinearInterp::UseMesh(const vector<point3d>& xyz,
 }
 
 
+// Replace values at mesh points without rebuilding tables
+
+void G4CMPBiLinearInterp::UseValues(const vector<G4double>& v) {
+  if (!CheckValues(v, V.size())) return;
+
+  V = v;
+  FillGradients();
+
+#ifdef G4CMPTLI_DEBUG
+  SavePoints(savePrefix+"_points.dat");
+#endif
+}
+
 
 // Compress external 3D tables to 2D version (for client convenience)
 
@@ -41,6 +41,14 @@
 // 20230622  G4CMP-325:  For G4CMP-343 above, default "keep all" flag to TRUE.
 // 20230831  G4CMP-362:  Add short names for IMPACT and Sarkis ionization models
 // 20240506  G4CMP-371:  Add flag to keep or discard below-minimum track energy.
+// 20261017  Add flag to enable grid index for mesh field lookups.
+// 20261017  Add flag to save and reuse binary mesh field tables.
+// 20261017  Add parameter to resample mesh fields onto a regular grid.
+// 20261017  Add directory for cached phonon kinematics tables.
+// 20261017  Add flag to use precomputed film response in KaplanQP.
+// 20261017  Add phonon importance map and ratio for weight-window process.
+// 20261017  Add flag to tabulate scattering rate models.
+// 20261017  Mesh cache setting may name a directory for cache files.
 
 #include "G4CMPConfigManager.hh"
 #include "G4CMPConfigMessenger.hh"
@@ -48,6 +56,7 @@
 #include "G4CMPLindhardNIEL.hh"
 #include "G4CMPImpactTunlNIEL.hh"
 #include "G4CMPSarkisNIEL.hh"
+#include "G4CMPVPhononImportance.hh"
 #include "G4VNIELPartition.hh"
 #include "G4RunManager.hh"
 #include "G4SystemOfUnits.hh"
@@ -86,6 +95,8 @@ G4CMPConfigManager::G4CMPConfigManager()
     maxLukePhonons(getenv("G4MP_MAX_LUKE")?atoi(getenv("G4MP_MAX_LUKE")):-1),
     LatticeDir(getenv("G4LATTICEDATA")?getenv("G4LATTICEDATA"):"./CrystalMaps"),
     IVRateModel(getenv("G4CMP_IV_RATE_MODEL")?getenv("G4CMP_IV_RATE_MODEL"):"Quadratic"),
+    kinCacheDir(getenv("G4CMP_KIN_CACHE")?getenv("G4CMP_KIN_CACHE"):""),
+    meshCacheDir(""),
     eTrapMFP(getenv("G4CMP_ETRAPPING_MFP")?strtod(getenv("G4CMP_ETRAPPING_MFP"),0)*mm:DBL_MAX),
     hTrapMFP(getenv("G4CMP_HTRAPPING_MFP")?strtod(getenv("G4CMP_HTRAPPING_MFP"),0)*mm:DBL_MAX),
     eDTrapIonMFP(getenv("G4CMP_EDTRAPION_MFP")?strtod(getenv("G4CMP_EDTRAPION_MFP"),0)*mm:DBL_MAX),
@@ -105,13 +116,21 @@ G4CMPConfigManager::G4CMPConfigManager()
     useKVsolver(getenv("G4CMP_USE_KVSOLVER")?atoi(getenv("G4CMP_USE_KVSOLVER")):0),
     fanoEnabled(getenv("G4CMP_FANO_ENABLED")?atoi(getenv("G4CMP_FANO_ENABLED")):1),
     kaplanKeepPh(getenv("G4CMP_KAPLAN_KEEP")?atoi(getenv("G4CMP_KAPLAN_KEEP")):true),
+    kaplanFast(getenv("G4CMP_KAPLAN_FAST")?atoi(getenv("G4CMP_KAPLAN_FAST")):false),
+    rateTables(getenv("G4CMP_RATE_TABLES")?atoi(getenv("G4CMP_RATE_TABLES")):false),
     chargeCloud(getenv("G4CMP_CHARGE_CLOUD")?atoi(getenv("G4CMP_CHARGE_CLOUD")):0),
     recordMinE(getenv("G4CMP_RECORD_EMIN")?atoi(getenv("G4CMP_RECORD_EMIN")):true),
-    nielPartition(0), messenger(new G4CMPConfigMessenger(this)) {
+    meshIndex(getenv("G4CMP_MESH_INDEX")?atoi(getenv("G4CMP_MESH_INDEX")):true),
+    meshCache(false),
+    meshGridStep(getenv("G4CMP_MESH_GRID")?strtod(getenv("G4CMP_MESH_GRID"),0)*mm:0.),
+    importanceRatio(getenv("G4CMP_IMPORTANCE_RATIO")?strtod(getenv("G4CMP_IMPORTANCE_RATIO"),0):2.),
+    nielPartition(0), phononImportance(0), messenger(new G4CMPConfigMessenger(this)) {
   fPhysicsModelID = G4PhysicsModelCatalog::Register("G4CMP process");
 
   setVersion();
 
+  if (getenv("G4CMP_MESH_CACHE")) setMeshCache(getenv("G4CMP_MESH_CACHE"));
+
   if (getenv("G4CMP_NIEL_FUNCTION")) 
     setNIEL(getenv("G4CMP_NIEL_FUNCTION"));
   else 
@@ -129,7 +148,9 @@ G4CMPConfigManager::G4CMPConfigManager(const G4CMPConfigManager& master)
     ehBounces(master.ehBounces), pBounces(master.pBounces),
     maxLukePhonons(master.maxLukePhonons),
     version(master.version), LatticeDir(master.LatticeDir), 
-    IVRateModel(master.IVRateModel), eTrapMFP(master.eTrapMFP),
+    IVRateModel(master.IVRateModel), kinCacheDir(master.kinCacheDir),
+    meshCacheDir(master.meshCacheDir),
+    eTrapMFP(master.eTrapMFP),
     hTrapMFP(master.hTrapMFP), eDTrapIonMFP(master.eDTrapIonMFP),
     eATrapIonMFP(master.eATrapIonMFP), hDTrapIonMFP(master.hDTrapIonMFP),
     hATrapIonMFP(master.hATrapIonMFP),
@@ -139,8 +160,15 @@ G4CMPConfigManager::G4CMPConfigManager(const G4CMPConfigManager& master)
     lukeSample(master.lukeSample), combineSteps(master.combineSteps),
     EminPhonons(master.EminPhonons), EminCharges(master.EminCharges),
     useKVsolver(master.useKVsolver), fanoEnabled(master.fanoEnabled),
-    kaplanKeepPh(master.kaplanKeepPh), chargeCloud(master.chargeCloud),
-    recordMinE(master.recordMinE), nielPartition(master.nielPartition),
+    kaplanKeepPh(master.kaplanKeepPh), kaplanFast(master.kaplanFast),
+    rateTables(master.rateTables),
+    chargeCloud(master.chargeCloud),
+    recordMinE(master.recordMinE), meshIndex(master.meshIndex),
+    meshCache(master.meshCache),
+    meshGridStep(master.meshGridStep),
+    importanceRatio(master.importanceRatio),
+    nielPartition(master.nielPartition),
+    phononImportance(master.phononImportance),
     messenger(new G4CMPConfigMessenger(this)) {;}
 
 
@@ -172,6 +200,31 @@ void G4CMPConfigManager::setNIEL(G4String name) {
   if (name(0,3) == "sar") setNIEL(new G4CMPSarkisNIEL);
 }
 
+// Mesh cache is enabled beside input file, disabled, or put in directory
+
+void G4CMPConfigManager::setMeshCache(const G4String& value) {
+  G4String flag = value;
+  flag.toLower();
+
+  G4bool numeric = (!flag.empty() &&
+		    flag.find_first_not_of("0123456789") == G4String::npos);
+
+  if (numeric) {
+    meshCache = (atoi(flag.c_str()) != 0);	// As from $G4CMP_MESH_CACHE
+    meshCacheDir = "";
+  } else if (flag.empty() || flag == "true" || flag == "t" ||
+	     flag == "yes" || flag == "y") {
+    meshCache = true;
+    meshCacheDir = "";
+  } else if (flag == "false" || flag == "f" || flag == "no" || flag == "n") {
+    meshCache = false;
+    meshCacheDir = "";
+  } else {
+    meshCache = true;
+    meshCacheDir = value;
+  }
+}
+
 void G4CMPConfigManager::setNIEL(G4VNIELPartition* niel) {
   delete nielPartition;
   nielPartition = niel;
@@ -208,10 +261,21 @@ void G4CMPConfigManager::printConfig(std::ostream& os) const {
      << "\n/g4cmp/useKVsolver " << useKVsolver << "\t\t\t\t# G4CMP_USE_KVSOLVER"
      << "\n/g4cmp/enableFanoStatistics " << fanoEnabled << "\t\t\t# G4CMP_FANO_ENABLED"
      << "\n/g4cmp/kaplanKeepPhonons " << kaplanKeepPh << "\t\t\t# G4CMP_KAPLAN_KEEP "
+     << "\n/g4cmp/kaplanFastMode " << kaplanFast << "\t\t\t# G4CMP_KAPLAN_FAST"
+     << "\n/g4cmp/useRateTables " << rateTables << "\t\t\t# G4CMP_RATE_TABLES"
      << "\n/g4cmp/createChargeCloud " << chargeCloud << "\t\t\t# G4CMP_CHARGE_CLOUD"
      << "\n/g4cmp/recordMinETracks " << recordMinE << "\t\t\t# G4CMP_RECORD_EMIN"
+     << "\n/g4cmp/useMeshIndex " << meshIndex << "\t\t\t# G4CMP_MESH_INDEX"
+     << "\n/g4cmp/useMeshCache "
+     << (meshCacheDir.empty() ? (meshCache ? "1" : "0") : meshCacheDir)
+     << "\t\t\t# G4CMP_MESH_CACHE"
+     << "\n/g4cmp/meshGridStep " << meshGridStep/mm << " mm\t\t# G4CMP_MESH_GRID"
+     << "\n/g4cmp/phononKinCache " << kinCacheDir << "\t\t\t# G4CMP_KIN_CACHE"
+     << "\n/g4cmp/phononImportanceRatio " << importanceRatio << "\t\t# G4CMP_IMPORTANCE_RATIO"
      << "\n/g4cmp/NIELPartition "
      << (nielPartition ? typeid(*nielPartition).name() : "---")
      << "\t# G4CMP_NIEL_FUNCTION "
+     << "\n# phonon importance map "
+     << (phononImportance ? typeid(*phononImportance).name() : "---")
      << std::endl;
 }
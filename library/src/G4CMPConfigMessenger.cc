@@ -41,6 +41,14 @@
 // 20221214  G4CMP-350:  Bug fix for new temperature setting units.
 // 20230831  G4CMP-362:  Add short names for IMPACT and Sarkis ionization models
 // 20240506  G4CMP-371:  Add flag to keep or discard below-minimum track energy.
+// 20261017  Add flag to enable grid index for mesh field lookups.
+// 20261017  Add flag to save and reuse binary mesh field tables.
+// 20261017  Add parameter to resample mesh fields onto a regular grid.
+// 20261017  Add directory for cached phonon kinematics tables.
+// 20261017  Add flag to use precomputed film response in KaplanQP.
+// 20261017  Add importance ratio for phonon weight window.
+// 20261017  Add flag to tabulate scattering rate models.
+// 20261017  Mesh cache command takes flag or directory name.
 
 #include "G4CMPConfigMessenger.hh"
 #include "G4CMPConfigManager.hh"
@@ -64,7 +72,9 @@ G4CMPConfigMessenger::G4CMPConfigMessenger(G4CMPConfigManager* mgr)
     hDTrapIonMFPCmd(0), hATrapIonMFPCmd(0), tempCmd(0), minstepCmd(0),
     makePhononCmd(0), makeChargeCmd(0), lukePhononCmd(0), dirCmd(0),
     ivRateModelCmd(0), nielPartitionCmd(0), kvmapCmd(0), fanoStatsCmd(0),
-  kaplanKeepCmd(0), ehCloudCmd(0), recordMinECmd(0) {
+  kaplanKeepCmd(0), ehCloudCmd(0), recordMinECmd(0), meshIndexCmd(0),
+  meshCacheCmd(0), meshGridCmd(0), kinCacheCmd(0), kaplanFastCmd(0),
+  importanceCmd(0), rateTablesCmd(0) {
   verboseCmd = CreateCommand<G4UIcmdWithAnInteger>("verbose",
 					   "Enable diagnostic messages");
 
@@ -192,6 +202,51 @@ G4CMPConfigMessenger::G4CMPConfigMessenger(G4CMPConfigManager* mgr)
        "Preserve all intermediate phonons in G4CMPKaplanQP (no killing)");
   kaplanKeepCmd->SetParameterName("enable",true,false);
   kaplanKeepCmd->SetDefaultValue(true);
+
+  kaplanFastCmd = CreateCommand<G4UIcmdWithABool>("kaplanFastMode",
+       "Use precomputed film response tables in G4CMPKaplanQP");
+  kaplanFastCmd->SetParameterName("enable",true,false);
+  kaplanFastCmd->SetDefaultValue(true);
+
+  importanceCmd = CreateCommand<G4UIcmdWithADouble>("phononImportanceRatio",
+       "Change in phonon importance needed to split or roulette tracks");
+  importanceCmd->SetGuidance("Used with the importance map registered via");
+  importanceCmd->SetGuidance("G4CMPConfigManager::SetPhononImportance().");
+  importanceCmd->SetParameterName("ratio",false);
+  importanceCmd->SetRange("ratio>1");
+
+  rateTablesCmd = CreateCommand<G4UIcmdWithABool>("useRateTables",
+       "Interpolate scattering rates from tables of rate models");
+  rateTablesCmd->SetGuidance("Must be set before /run/initialize.");
+  rateTablesCmd->SetParameterName("enable",true,false);
+  rateTablesCmd->SetDefaultValue(true);
+
+  meshIndexCmd = CreateCommand<G4UIcmdWithABool>("useMeshIndex",
+	"Use grid index to start mesh field tetrahedron searches");
+  meshIndexCmd->SetParameterName("enable",true,false);
+  meshIndexCmd->SetDefaultValue(true);
+
+  meshCacheCmd = CreateCommand<G4UIcmdWithAString>("useMeshCache",
+	"Save and reuse binary tables for mesh field files");
+  meshCacheCmd->SetGuidance("Tables are written to the mesh input file name with .cache");
+  meshCacheCmd->SetGuidance("appended, and reused while the input file is unchanged.");
+  meshCacheCmd->SetGuidance("A value other than true/false is a directory for the tables.");
+  meshCacheCmd->SetParameterName("value",true,false);
+  meshCacheCmd->SetDefaultValue("true");
+
+  meshGridCmd = CreateCommand<G4UIcmdWithADoubleAndUnit>("meshGridStep",
+	"Resample mesh field onto regular grid with this spacing");
+  meshGridCmd->SetGuidance("Field is then evaluated by trilinear lookup, without a");
+  meshGridCmd->SetGuidance("tetrahedral search.  Zero uses the tetrahedral mesh directly.");
+  meshGridCmd->SetUnitCategory("Length");
+
+  kinCacheCmd = CreateCommand<G4UIcmdWithAString>("phononKinCache",
+	"Directory to save and reuse phonon kinematics tables");
+  kinCacheCmd->SetGuidance("Tables are keyed to lattice elasticity and density,");
+  kinCacheCmd->SetGuidance("and rebuilt if these change.  Empty string disables.");
+  kinCacheCmd->SetParameterName("dir",true,false);
+  kinCacheCmd->SetDefaultValue("");
+  kinCacheCmd->AvailableForStates(G4State_PreInit);
 }
 
 
@@ -223,9 +278,16 @@ G4CMPConfigMessenger::~G4CMPConfigMessenger() {
   delete kvmapCmd; kvmapCmd=0;
   delete fanoStatsCmd; fanoStatsCmd=0;
   delete kaplanKeepCmd; kaplanKeepCmd=0;
+  delete kaplanFastCmd; kaplanFastCmd=0;
+  delete importanceCmd; importanceCmd=0;
+  delete rateTablesCmd; rateTablesCmd=0;
   delete ehCloudCmd; ehCloudCmd=0;
   delete ivRateModelCmd; ivRateModelCmd=0;
   delete nielPartitionCmd; nielPartitionCmd=0;
+  delete meshGridCmd; meshGridCmd=0;
+  delete kinCacheCmd; kinCacheCmd=0;
+  delete meshCacheCmd; meshCacheCmd=0;
+  delete meshIndexCmd; meshIndexCmd=0;
 }
 
 
@@ -286,9 +348,16 @@ void G4CMPConfigMessenger::SetNewValue(G4UIcommand* cmd, G4String value) {
   if (cmd == kvmapCmd) theManager->UseKVSolver(StoB(value));
   if (cmd == fanoStatsCmd) theManager->EnableFanoStatistics(StoB(value));
   if (cmd == kaplanKeepCmd) theManager->KeepKaplanPhonons(StoB(value));
+  if (cmd == kaplanFastCmd) theManager->UseKaplanFastMode(StoB(value));
+  if (cmd == importanceCmd) theManager->SetImportanceRatio(StoD(value));
+  if (cmd == rateTablesCmd) theManager->UseRateTables(StoB(value));
   if (cmd == ivRateModelCmd) theManager->SetIVRateModel(value);
   if (cmd == nielPartitionCmd) theManager->SetNIELPartition(value);
   if (cmd == ehCloudCmd) theManager->CreateChargeCloud(StoB(value));
+  if (cmd == meshIndexCmd) theManager->UseMeshIndex(StoB(value));
+  if (cmd == meshCacheCmd) theManager->SetMeshCache(value);
+  if (cmd == meshGridCmd) theManager->SetMeshGridStep(meshGridCmd->GetNewDoubleValue(value));
+  if (cmd == kinCacheCmd) theManager->SetKinCacheDir(value);
 
   if (cmd == versionCmd)
     G4cout << "G4CMP version: " << theManager->Version() << G4endl;
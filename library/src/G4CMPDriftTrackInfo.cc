@@ -12,12 +12,13 @@
 // $Id$
 //
 // 20161111 Initial commit - R. Agnese
+// 20261017 Use thread-local G4Allocator, with large pages, for track info
 
 #include "G4CMPDriftTrackInfo.hh"
 #include "G4LatticePhysical.hh"
 #include "G4ParticleDefinition.hh"
 
-//G4Allocator<G4CMPDriftTrackInfo> G4CMPDriftTrackInfoAllocator;
+G4ThreadLocal G4Allocator<G4CMPDriftTrackInfo>* G4CMPDriftTrackInfoAllocator = 0;
 
 G4CMPDriftTrackInfo::G4CMPDriftTrackInfo(const G4LatticePhysical* lat,
                                          G4int valIdx) :
@@ -0,0 +1,174 @@
+//  G4CMPEigenSolver3x3.cc
+//
+//  20261017  New class, for use with G4CMPPhononKinematics
+
+#include "G4CMPEigenSolver3x3.hh"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+
+// Use closed form if eigenvalues are well separated, otherwise Jacobi
+
+void G4CMPEigenSolver3x3::setup(const double m[3][3]) {
+  double a[3][3] = { { m[0][0], m[0][1], m[0][2] },
+		     { m[0][1], m[1][1], m[1][2] },
+		     { m[0][2], m[1][2], m[2][2] } };
+
+  if (!analytic(a)) jacobi(a);
+  sort();
+}
+
+// Roots of characteristic polynomial by trigonometric solution, and
+// eigenvectors as cross products of rows of (A - lambda I).  See J. Kopp,
+// Int. J. Mod. Phys. C 19, 523 (2008), arXiv:physics/0610206.
+
+G4bool G4CMPEigenSolver3x3::analytic(const double a[3][3]) {
+  const double de = a[0][1]*a[1][2];
+  const double dd = a[0][1]*a[0][1];
+  const double ee = a[1][2]*a[1][2];
+  const double ff = a[0][2]*a[0][2];
+  const double m  = a[0][0] + a[1][1] + a[2][2];
+  const double c1 = (a[0][0]*a[1][1] + a[0][0]*a[2][2] + a[1][1]*a[2][2])
+    - (dd + ee + ff);
+  const double c0 = a[2][2]*dd + a[0][0]*ee + a[1][1]*ff
+    - a[0][0]*a[1][1]*a[2][2] - 2.*a[0][2]*de;
+
+  const double p = m*m - 3.*c1;
+  const double q = m*(p - 1.5*c1) - 13.5*c0;
+  const double sqrt_p = std::sqrt(std::fabs(p));
+
+  double phi = 27.*(0.25*c1*c1*(p - c1) + c0*(q + 6.75*c0));
+  phi = std::atan2(std::sqrt(std::fabs(phi)), q) / 3.;
+
+  const double c = sqrt_p*std::cos(phi);
+  const double s = sqrt_p*std::sin(phi) / std::sqrt(3.);
+
+  d[1] = (m - c) / 3.;
+  d[2] = d[1] + s;
+  d[0] = d[1] + c;
+  d[1] -= s;
+
+  // Cross products lose precision as eigenvalues approach each other
+  const double scale = std::max(std::fabs(d[0]),
+				std::max(std::fabs(d[1]), std::fabs(d[2])));
+  const double gap = std::min(std::fabs(d[0]-d[1]),
+			      std::min(std::fabs(d[0]-d[2]),
+				       std::fabs(d[1]-d[2])));
+  if (!(gap > 1e-3*scale)) return false;
+
+  for (int k=0; k<3; k++) {
+    const double r[3][3] = { { a[0][0]-d[k], a[0][1], a[0][2] },
+			     { a[0][1], a[1][1]-d[k], a[1][2] },
+			     { a[0][2], a[1][2], a[2][2]-d[k] } };
+
+    // Largest of the three cross products is the most accurate
+    double best[3] = { 0., 0., 0. }, bestNorm = 0.;
+    for (int i=0; i<2; i++) {
+      for (int j=i+1; j<3; j++) {
+	const double v[3] = { r[i][1]*r[j][2] - r[i][2]*r[j][1],
+			      r[i][2]*r[j][0] - r[i][0]*r[j][2],
+			      r[i][0]*r[j][1] - r[i][1]*r[j][0] };
+	const double norm = v[0]*v[0] + v[1]*v[1] + v[2]*v[2];
+	if (norm > bestNorm) {
+	  bestNorm = norm;
+	  best[0] = v[0]; best[1] = v[1]; best[2] = v[2];
+	}
+      }
+    }
+
+    if (!(bestNorm > 0.)) return false;
+
+    const double invNorm = 1./std::sqrt(bestNorm);
+    for (int i=0; i<3; i++) z[i][k] = best[i]*invNorm;
+  }
+
+  // Rayleigh quotient refines eigenvalue; residual bounds the error
+  for (int k=0; k<3; k++) {
+    double av[3];
+    for (int i=0; i<3; i++)
+      av[i] = a[i][0]*z[0][k] + a[i][1]*z[1][k] + a[i][2]*z[2][k];
+
+    d[k] = av[0]*z[0][k] + av[1]*z[1][k] + av[2]*z[2][k];
+
+    double resid = 0.;
+    for (int i=0; i<3; i++) resid += (av[i]-d[k]*z[i][k])*(av[i]-d[k]*z[i][k]);
+    if (!(resid <= 1e-24*scale*scale)) return false;
+  }
+
+  // Trigonometric roots may hide a degeneracy, check refined values
+  const double newGap = std::min(std::fabs(d[0]-d[1]),
+				 std::min(std::fabs(d[0]-d[2]),
+					  std::fabs(d[1]-d[2])));
+  return (newGap > 1e-3*scale);
+}
+
+// Sweep over the three off-diagonal elements until all are negligible
+// compared to the diagonal; converges quadratically, typically within
+// three or four sweeps.
+
+void G4CMPEigenSolver3x3::jacobi(double a[3][3]) {
+  for (int i=0; i<3; i++)
+    for (int j=0; j<3; j++) z[i][j] = (i==j) ? 1. : 0.;
+
+  for (int sweep=0; sweep<50; sweep++) {
+    if (a[0][1] == 0. && a[0][2] == 0. && a[1][2] == 0.) break;
+
+    rotate(a, 0, 1);
+    rotate(a, 0, 2);
+    rotate(a, 1, 2);
+  }
+
+  for (int i=0; i<3; i++) d[i] = a[i][i];
+}
+
+// Zero element a[p][q] (p<q), following Numerical Recipes jacobi()
+
+void G4CMPEigenSolver3x3::rotate(double a[3][3], int p, int q) {
+  const double apq = a[p][q];
+  if (apq == 0.) return;
+
+  // Element below precision of diagonal is dropped without rotation
+  const double small = 100.*std::fabs(apq);
+  if (std::fabs(a[p][p]) + small == std::fabs(a[p][p]) &&
+      std::fabs(a[q][q]) + small == std::fabs(a[q][q])) {
+    a[p][q] = a[q][p] = 0.;
+    return;
+  }
+
+  const double theta = 0.5*(a[q][q]-a[p][p])/apq;
+  double t = 1./(std::fabs(theta) + std::sqrt(theta*theta+1.));
+  if (theta < 0.) t = -t;
+
+  const double c = 1./std::sqrt(t*t+1.);
+  const double s = t*c;
+  const double tau = s/(1.+c);
+
+  a[p][p] -= t*apq;
+  a[q][q] += t*apq;
+  a[p][q] = a[q][p] = 0.;
+
+  const int r = 3-p-q;			// The remaining index
+  const double g = a[r][p], h = a[r][q];
+  a[r][p] = a[p][r] = g - s*(h+g*tau);
+  a[r][q] = a[q][r] = h + s*(g-h*tau);
+
+  for (int i=0; i<3; i++) {
+    const double zp = z[i][p], zq = z[i][q];
+    z[i][p] = zp - s*(zq+zp*tau);
+    z[i][q] = zq + s*(zp-zq*tau);
+  }
+}
+
+// Order eigenvalues (and vectors) from largest to smallest
+
+void G4CMPEigenSolver3x3::sort() {
+  for (int i=0; i<2; i++) {
+    int k = i;
+    for (int j=i+1; j<3; j++) if (d[j] > d[k]) k = j;
+    if (k != i) {
+      std::swap(d[i], d[k]);
+      for (int j=0; j<3; j++) std::swap(z[j][i], z[j][k]);
+    }
+  }
+}
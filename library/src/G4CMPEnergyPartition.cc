@@ -62,6 +62,10 @@
 // 20240105  Add UpdateSummary() function to set position and track info
 // 20240129  In ComputePhononSampling(), generate at least 10k as many phonons
 // 20240417  In ComputePhononSampling(), use same energy scale as for charges.
+// 20261017  In GetSecondaries(), compute phonon group velocities as a batch.
+// 20261017  Drop shrink_to_fit() in DoPartition(), so particle buffer is
+//		reused without reallocation from one energy deposit to the next.
+// 20261017  Fill primaries into event from reusable buffer.
 
 #include "G4CMPEnergyPartition.hh"
 #include "G4CMPChargeCloud.hh"
@@ -75,6 +79,7 @@
 #include "G4CMPPartitionSummary.hh"
 #include "G4CMPSecondaryUtils.hh"
 #include "G4CMPStepAccumulator.hh"
+#include "G4CMPTrackUtils.hh"
 #include "G4CMPUtils.hh"
 #include "G4VNIELPartition.hh"
 #include "G4DynamicParticle.hh"
@@ -353,8 +358,6 @@ void G4CMPEnergyPartition::DoPartition(G4double eIon, G4double eNIEL) {
   GenerateCharges(eIon);
   GeneratePhonons(eNIEL + chargeEnergyLeft);
 
-  particles.shrink_to_fit();	// Reduce size to match generated particles
-
   // Shuffle particles so they can be distributed along trajectories
   std::random_shuffle(particles.begin(), particles.end(), G4CMP::RandomIndex);
 
@@ -679,8 +682,8 @@ GetPrimaries(G4Event* event, const G4ThreeVector& pos, G4double time,
   // Store position information in summary block
   UpdateSummary(pos, time);
 
-  std::vector<G4PrimaryParticle*> primaries;	// Can we make this mutable?
-  GetPrimaries(primaries);
+  std::vector<G4PrimaryParticle*>& primaries = primaryBuffer;
+  GetPrimaries(primaries);		// Reuses buffer between calls
 
   G4double chargeEtot = 0.;		// Cumulative buffers for diagnostics
   G4double phononEtot = 0.;
@@ -759,8 +762,8 @@ GetPrimaries(G4Event* event, const std::vector<G4ThreeVector>& pos,
   size_t tracksPerPos = GetNumberOfTracks() / npos;
   size_t extraTracks = GetNumberOfTracks() - (tracksPerPos * npos);
 
-  std::vector<G4PrimaryParticle*> primaries;	// Can we make this mutable?
-  GetPrimaries(primaries);
+  std::vector<G4PrimaryParticle*>& primaries = primaryBuffer;
+  GetPrimaries(primaries);		// Reuses buffer between calls
 
   size_t iprim = 0;
   for (size_t i=0; i<npos; i++) {
@@ -828,14 +831,38 @@ GetSecondaries(std::vector<G4Track*>& secondaries, G4double trkWeight) const {
 
   if (verboseLevel>1) G4cout << " processing " << particles.size() << G4endl;
 
+  // Look up group velocities for all phonons in a single batch
+  const G4Track& track = *GetCurrentTrack();
+  G4LatticePhysical* lat = G4CMP::GetLattice(track);
+
+  std::vector<G4int> phononMode;
+  std::vector<G4ThreeVector> phononK, phononVg;
+  if (lat) {
+    for (const Data& p: particles) {
+      if (!G4CMP::IsPhonon(p.pd)) continue;
+      phononMode.push_back(G4PhononPolarization::Get(p.pd));
+      phononK.push_back(p.dir);
+    }
+    lat->MapKtoVg(phononMode, phononK, phononVg);
+  }
+
   G4Track* theSec = 0;
   G4int ichg = 0;			// Index to deal with charge cloud
+  G4int iphon = 0;			// Index into phonon velocity batch
 
   for (size_t i=0; i<particles.size(); i++) {
     const Data& p = particles[i];	// For convenience below
 
+    if (lat && G4CMP::IsPhonon(p.pd)) {	// Use batched group velocity
+      theSec = G4CMP::CreatePhonon(track, phononMode[iphon], p.dir,
+				   phononVg[iphon], p.ekin,
+				   track.GetGlobalTime(), track.GetPosition());
+      iphon++;
+    } else {
+      theSec = G4CMP::CreateSecondary(track, p.pd, p.dir, p.ekin);
+    }
+
     // Set weights so that generated particles map back to expected true number
-    theSec = G4CMP::CreateSecondary(*GetCurrentTrack(), p.pd, p.dir, p.ekin);
     theSec->SetWeight(trkWeight*p.wt);
     secondaries.push_back(theSec);
 
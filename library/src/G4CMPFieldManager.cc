@@ -21,6 +21,10 @@
 // 20200804  Attach local geometry shape to field
 // 20210901  Add local verbosity flag for reporting diagnostics, pass through
 //		to G4CMPLocalEMField.
+// 20261017  Skip reconfiguration if volume, lattice and valley are the same
+//		as previous track; take transforms from TransformStore cache.
+// 20261017  TransformStore ID includes copy numbers, so replicas of the
+//		same volume get their own transforms.
 
 #include "G4CMPFieldManager.hh"
 #include "G4CMPConfigManager.hh"
@@ -29,6 +33,7 @@
 #include "G4CMPEqEMField.hh"
 #include "G4CMPLocalElectroMagField.hh"
 #include "G4CMPDriftTrackInfo.hh"
+#include "G4CMPGlobalLocalTransformStore.hh"
 #include "G4CMPTrackUtils.hh"
 #include "G4ChordFinder.hh"
 #include "G4ClassicalRK4.hh"
@@ -56,7 +61,8 @@ G4CMPFieldManager::G4CMPFieldManager(G4ElectroMagneticField *detectorField,
   : G4FieldManager(new G4CMPLocalElectroMagField(detectorField)),
     verboseLevel(vb==0?G4CMPConfigManager::GetVerboseLevel():vb),
     myDetectorField(0), stepperVars(8), stepperLength(1e-9*mm),
-    latticeNulls(0), maxLatticeNulls(3) {
+    latticeNulls(0), maxLatticeNulls(3), lastVolume(0), lastLattice(0),
+    lastTouchID(0), lastValley(-2) {
   if (verboseLevel)
     G4cout << "G4CMPFieldManager wrapped global field in LocalEMField." << G4endl;
 
@@ -73,7 +79,8 @@ G4CMPFieldManager::G4CMPFieldManager(G4CMPLocalElectroMagField *detectorField,
   : G4FieldManager(detectorField),
     verboseLevel(vb==0?G4CMPConfigManager::GetVerboseLevel():vb),
     myDetectorField(detectorField), stepperVars(8), stepperLength(1e-9*mm),
-    latticeNulls(0), maxLatticeNulls(3) {
+    latticeNulls(0), maxLatticeNulls(3), lastVolume(0), lastLattice(0),
+    lastTouchID(0), lastValley(-2) {
   if (verboseLevel)
     G4cout << "G4CMPFieldManager provided with wrapped LocalEMField." << G4endl;
 
@@ -114,33 +121,45 @@ void G4CMPFieldManager::ConfigureForTrack(const G4Track* aTrack) {
   }
 
   // Ensure that field is properly wrapped for global/local coordinates
-  if (!dynamic_cast<const G4CMPLocalElectroMagField*>(GetDetectorField())) {
-    if (verboseLevel) {
-      G4cout << " Registered field not local.  Wrapping in G4CMPLocalEMField."
-	     << G4endl;
+  // NOTE: Pointer test avoids dynamic_cast for every track
+  if (GetDetectorField() != myDetectorField) {
+    G4Field* userField = const_cast<G4Field*>(GetDetectorField());
+    lastTouchID = 0;			// New field needs configuration
+
+    myDetectorField = dynamic_cast<G4CMPLocalElectroMagField*>(userField);
+    if (!myDetectorField) {
+      if (verboseLevel) {
+	G4cout << " Registered field not local.  Wrapping in G4CMPLocalEMField."
+	       << G4endl;
+      }
+
+      const G4ElectroMagneticField* baseField =
+	dynamic_cast<const G4ElectroMagneticField*>(userField);
+      if (!baseField) {
+	G4ExceptionDescription msg;
+	msg << "Field attached to volume " << aTrack->GetVolume()->GetName()
+	    << " not G4ElectroMagneticField.";
+
+	G4Exception("G4CMPFieldManager::ConfigureForTrack", "FieldMan003",
+		    FatalException, msg);
+	return;
+      }
+
+      myDetectorField = new G4CMPLocalElectroMagField(baseField);
+      myDetectorField->SetVerboseLevel(verboseLevel);
+
+      ChangeDetectorField(myDetectorField);
     }
+  }
 
-    const G4ElectroMagneticField* baseField =
-      dynamic_cast<const G4ElectroMagneticField*>(GetDetectorField());
-    if (!baseField) {
-      G4ExceptionDescription msg;
-      msg << "Field attached to volume " << aTrack->GetVolume()->GetName()
-	  << " not G4ElectroMagneticField.";
-
-      G4Exception("G4CMPFieldManager::ConfigureForTrack", "FieldMan003",
-		  FatalException, msg);
-      return;
-    }
-
-    myDetectorField = new G4CMPLocalElectroMagField(baseField);
-    myDetectorField->SetVerboseLevel(verboseLevel);
-
-    ChangeDetectorField(myDetectorField);
+  // Configure equation of motion with physical lattice; lookup is only
+  // needed when track is in a different volume from the previous one
+  if (aTrack->GetVolume() != lastVolume) {
+    lastVolume = aTrack->GetVolume();
+    lastLattice = G4LatticeManager::GetLatticeManager()->GetLattice(lastVolume);
   }
 
-  // Configure equation of motion with physical lattice
-  const G4LatticePhysical* lat =
-    G4LatticeManager::GetLatticeManager()->GetLattice(aTrack->GetVolume());
+  const G4LatticePhysical* lat = lastLattice;
 
   // If track is outside valid volume, count attemps to look for reflections
   if (lat) latticeNulls = 0;
@@ -157,38 +176,46 @@ void G4CMPFieldManager::ConfigureForTrack(const G4Track* aTrack) {
     }
 
     theEqMotion->SetNoValley();
+    lastValley = -2;
     return;
   }
 
   // Hack around boundary issues; don't store or change vol if null lattice!
-  G4bool newLat = lat ? theEqMotion->ChangeLattice(lat) : false;
+  G4bool newLat = theEqMotion->ChangeLattice(lat);
 
-  // Extract local/global transform from track only if volume has changed
-  // This avoids creating and copying transforms on every step
-  if (newLat) {
-    const G4RotationMatrix* rot = aTrack->GetTouchable()->GetRotation();
-    const G4ThreeVector& trans  = aTrack->GetTouchable()->GetTranslation();
-    G4AffineTransform localToGlobal(rot, trans);
+  // Replace local/global transform only if touchable has changed; the same
+  // lattice may be shared by several placements or copies of the volume,
+  // so the identifier includes the copy number at each level
+  const G4VTouchable* touch = aTrack->GetTouchable();
+  uintptr_t touchID = G4CMPGlobalLocalTransformStore::ID(touch);
+
+  if (newLat || touchID != lastTouchID) {
+    lastTouchID = touchID;
+    const G4AffineTransform& localToGlobal =
+      G4CMPGlobalLocalTransformStore::ToGlobal(touch);
 
     if (verboseLevel > 1) {
+      const G4RotationMatrix& rot = localToGlobal.NetRotation();
       G4cout << " volume " << aTrack->GetVolume()->GetName() << " has"
-	     << " trans " << trans << " rot " << rot->delta()/deg
-	     << " deg about " << rot->axis() << G4endl;
+	     << " trans " << localToGlobal.NetTranslation() << " rot "
+	     << rot.delta()/deg << " deg about " << rot.axis() << G4endl;
     }
 
-    myDetectorField->SetGeometry(aTrack->GetTouchable()->GetVolume()->
-				 GetLogicalVolume()->GetSolid());
+    myDetectorField->SetGeometry(touch->GetVolume()->GetLogicalVolume()->
+				 GetSolid());
     myDetectorField->SetTransforms(localToGlobal);
     theEqMotion->SetTransforms(localToGlobal);
   }
 
   G4int iv = -1;
-  if (lat && (aTrack->GetDefinition() == G4CMPDriftElectron::Definition() ||
-	      aTrack->GetDefinition() == G4CMPDriftHole::Definition())) {
+  if (aTrack->GetDefinition() == G4CMPDriftElectron::Definition() ||
+      aTrack->GetDefinition() == G4CMPDriftHole::Definition()) {
     iv = G4CMP::GetTrackInfo<G4CMPDriftTrackInfo>(*aTrack)->ValleyIndex();
+  }
+
+  if (newLat || iv != lastValley) {
+    lastValley = iv;
     SetChargeValleyForTrack(lat, iv);
-  } else {
-    theEqMotion->SetNoValley();
   }
 }
 
@@ -18,6 +18,8 @@
 // 20200519  Convert to thread-local singleton (for use by worker threads)
 // 20240306  Construct transform from touchable instead of relying on History
 // 20240418  BUG FIX:  Transforms are inverted!  gToL was really lToG.
+// 20261017  Add ID() accessor to touchable hash.
+// 20261017  Include replica (copy) numbers in touchable hash
 
 #include "G4CMPGlobalLocalTransformStore.hh"
 #include "G4NavigationHistory.hh"
@@ -63,7 +65,8 @@ G4CMPGlobalLocalTransformStore::GetOrBuildTransforms(const G4VTouchable* touch)
   return Instance().cache[thash];
 }
 
-// Convert touchable volume chain to unique identifier
+// Convert touchable volume chain, with copy numbers, to unique identifier;
+// replicated or parametrised volumes share one physical volume pointer
 uintptr_t 
 G4CMPGlobalLocalTransformStore::Hash(const G4VTouchable* touch) const {
   if (!touch) {
@@ -79,6 +82,10 @@ G4CMPGlobalLocalTransformStore::Hash(const G4VTouchable* touch) const {
     uintptr_t pv = (uintptr_t)(void*)(touch->GetVolume(d));
     h *= prime + 2*(pv%prime);
     h %= prime;
+
+    uintptr_t copy = (uintptr_t)(touch->GetReplicaNumber(d));
+    h *= prime + 2*(copy%prime);
+    h %= prime;
   }
 
   return h/2;
@@ -0,0 +1,223 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file library/src/G4CMPHitBlock.cc
+/// \brief Implementation of the G4CMPHitBlock container.  Columnar hit
+///	   storage and binary I/O for G4CMPHitWriter.
+//
+// $Id$
+//
+// 20261017  New class, for use with G4CMPHitWriter
+
+#include "G4CMPHitBlock.hh"
+#include "G4CMPElectrodeHit.hh"
+#include "G4SystemOfUnits.hh"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace {
+  const char magic[8] = { 'G','4','C','M','P','H','I','T' };
+  const uint32_t version = 1;
+  const uint32_t byteOrder = 0x01020304;
+
+  // Transfer entire column in a single call
+  template <class T>
+  void WriteColumn(std::ostream& os, const std::vector<T>& col) {
+    if (!col.empty())
+      os.write(reinterpret_cast<const char*>(col.data()), col.size()*sizeof(T));
+  }
+
+  template <class T>
+  void ReadColumn(std::istream& is, std::vector<T>& col, size_t n) {
+    col.resize(n);
+    if (n > 0) is.read(reinterpret_cast<char*>(col.data()), n*sizeof(T));
+  }
+
+  template <class T> void WriteValue(std::ostream& os, T value) {
+    os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  template <class T> G4bool ReadValue(std::istream& is, T& value) {
+    return !!is.read(reinterpret_cast<char*>(&value), sizeof(T));
+  }
+}
+
+
+// Manage column allocations
+
+void G4CMPHitBlock::Reserve(size_t capacity) {
+  runID.reserve(capacity);
+  eventID.reserve(capacity);
+  trackID.reserve(capacity);
+  particle.reserve(capacity);
+  startE.reserve(capacity);
+  startX.reserve(capacity);
+  startY.reserve(capacity);
+  startZ.reserve(capacity);
+  startTime.reserve(capacity);
+  EDep.reserve(capacity);
+  weight.reserve(capacity);
+  finalX.reserve(capacity);
+  finalY.reserve(capacity);
+  finalZ.reserve(capacity);
+  finalTime.reserve(capacity);
+}
+
+void G4CMPHitBlock::Clear() {
+  runID.clear();
+  eventID.clear();
+  trackID.clear();
+  particle.clear();
+  startE.clear();
+  startX.clear();
+  startY.clear();
+  startZ.clear();
+  startTime.clear();
+  EDep.clear();
+  weight.clear();
+  finalX.clear();
+  finalY.clear();
+  finalZ.clear();
+  finalTime.clear();
+  names.clear();
+}
+
+
+// Copy hit contents into columns, converting to output units
+
+void G4CMPHitBlock::Add(G4int run, G4int event, const G4CMPElectrodeHit& hit) {
+  const G4ThreeVector start = hit.GetStartPosition();
+  const G4ThreeVector final = hit.GetFinalPosition();
+
+  runID.push_back(run);
+  eventID.push_back(event);
+  trackID.push_back(hit.GetTrackID());
+  particle.push_back(NameIndex(hit.GetParticleName()));
+  startE.push_back(hit.GetStartEnergy()/eV);
+  startX.push_back(start.x()/m);
+  startY.push_back(start.y()/m);
+  startZ.push_back(start.z()/m);
+  startTime.push_back(hit.GetStartTime()/ns);
+  EDep.push_back(hit.GetEnergyDeposit()/eV);
+  weight.push_back(hit.GetWeight());
+  finalX.push_back(final.x()/m);
+  finalY.push_back(final.y()/m);
+  finalZ.push_back(final.z()/m);
+  finalTime.push_back(hit.GetFinalTime()/ns);
+}
+
+// Blocks hold only a few particle types, so linear search is fastest
+
+uint16_t G4CMPHitBlock::NameIndex(const G4String& name) {
+  size_t i = std::find(names.begin(), names.end(), name) - names.begin();
+  if (i == names.size()) names.push_back(name);
+
+  return static_cast<uint16_t>(i);
+}
+
+
+// Binary I/O, see header for layout
+
+G4bool G4CMPHitBlock::WriteHeader(std::ostream& os) {
+  os.write(magic, sizeof(magic));
+  WriteValue(os, version);
+  WriteValue(os, byteOrder);
+
+  return os.good();
+}
+
+G4bool G4CMPHitBlock::ReadHeader(std::istream& is) {
+  char fileMagic[sizeof(magic)];
+  uint32_t fileVersion=0, fileOrder=0;
+
+  if (!is.read(fileMagic, sizeof(fileMagic)) ||
+      !ReadValue(is, fileVersion) || !ReadValue(is, fileOrder)) return false;
+
+  return (std::memcmp(fileMagic, magic, sizeof(magic)) == 0 &&
+	  fileVersion == version && fileOrder == byteOrder);
+}
+
+G4bool G4CMPHitBlock::Write(std::ostream& os) const {
+  WriteValue(os, static_cast<uint32_t>(Size()));
+  WriteValue(os, static_cast<uint32_t>(names.size()));
+  for (const G4String& name: names) {
+    WriteValue(os, static_cast<uint32_t>(name.size()));
+    os.write(name.data(), name.size());
+  }
+
+  WriteColumn(os, runID);
+  WriteColumn(os, eventID);
+  WriteColumn(os, trackID);
+  WriteColumn(os, particle);
+  WriteColumn(os, startE);
+  WriteColumn(os, startX);
+  WriteColumn(os, startY);
+  WriteColumn(os, startZ);
+  WriteColumn(os, startTime);
+  WriteColumn(os, EDep);
+  WriteColumn(os, weight);
+  WriteColumn(os, finalX);
+  WriteColumn(os, finalY);
+  WriteColumn(os, finalZ);
+  WriteColumn(os, finalTime);
+
+  return os.good();
+}
+
+G4bool G4CMPHitBlock::Read(std::istream& is) {
+  Clear();
+
+  uint32_t nHits=0, nNames=0;
+  if (!ReadValue(is, nHits) || !ReadValue(is, nNames)) return false;
+
+  names.resize(nNames);
+  for (G4String& name: names) {
+    uint32_t len = 0;
+    if (!ReadValue(is, len)) return false;
+    std::string buf(len, '\0');
+    if (len > 0 && !is.read(&buf[0], len)) return false;
+    name = buf;
+  }
+
+  ReadColumn(is, runID, nHits);
+  ReadColumn(is, eventID, nHits);
+  ReadColumn(is, trackID, nHits);
+  ReadColumn(is, particle, nHits);
+  ReadColumn(is, startE, nHits);
+  ReadColumn(is, startX, nHits);
+  ReadColumn(is, startY, nHits);
+  ReadColumn(is, startZ, nHits);
+  ReadColumn(is, startTime, nHits);
+  ReadColumn(is, EDep, nHits);
+  ReadColumn(is, weight, nHits);
+  ReadColumn(is, finalX, nHits);
+  ReadColumn(is, finalY, nHits);
+  ReadColumn(is, finalZ, nHits);
+  ReadColumn(is, finalTime, nHits);
+
+  return is.good();
+}
+
+
+// Write hits as CSV lines, in same format as example applications
+
+void G4CMPHitBlock::PrintHeader(std::ostream& os) {
+  os << "Run ID,Event ID,Track ID,Particle Name,Start Energy [eV],"
+     << "Start X [m],Start Y [m],Start Z [m],Start Time [ns],"
+     << "Energy Deposited [eV],Track Weight,End X [m],End Y [m],End Z [m],"
+     << "Final Time [ns]\n";
+}
+
+void G4CMPHitBlock::Print(std::ostream& os) const {
+  for (size_t i=0; i<Size(); i++) {
+    os << runID[i] << ',' << eventID[i] << ',' << trackID[i] << ','
+       << GetParticleName(i) << ',' << startE[i] << ','
+       << startX[i] << ',' << startY[i] << ',' << startZ[i] << ','
+       << startTime[i] << ',' << EDep[i] << ',' << weight[i] << ','
+       << finalX[i] << ',' << finalY[i] << ',' << finalZ[i] << ','
+       << finalTime[i] << '\n';
+  }
+}
@@ -17,6 +17,10 @@
 // 20240418  For source positions, apply surface clearance just to start
 //	       and end of step, not each point individually.  Don't spread
 //	       out source positions for steps < 100*tolerance.
+// 20261017  Replace map of accumulators with flat open-addressed table,
+//		cleared (not deallocated) between events.  Add ProcessSteps()
+//		to handle a batch of steps from a primary generator.
+// 20261017  Flag occupied table slots separately; any track ID is valid.
 
 #include "G4CMPHitMerging.hh"
 #include "G4CMPConfigManager.hh"
@@ -42,6 +46,7 @@
 #include "Randomize.hh"
 #include <algorithm>
 #include <vector>
+#include <stdint.h>
 
 
 // Constructor and destructor
@@ -49,13 +54,12 @@
 G4CMPHitMerging::G4CMPHitMerging()
   : G4CMPProcessUtils(), verboseLevel(G4CMPConfigManager::GetVerboseLevel()),
     combiningStepLength(G4CMPConfigManager::GetComboStepLength()),
-    accumulator(0), currentEventID(-1),
+    accumulator(0), readyTime(0.), currentEventID(-1),
     partitioner(new G4CMPEnergyPartition) {
   partitioner->FillSummary(true);	// Collect partition summary data
 }
 
 G4CMPHitMerging::~G4CMPHitMerging() {
-  trackAccum.clear();
   delete partitioner;
 }
 
@@ -110,7 +114,7 @@ void G4CMPHitMerging::ProcessEvent(const G4Event* currentEvent) {
   G4int thisEvent = currentEvent->GetEventID();
   if (thisEvent != currentEventID) {
     if (verboseLevel>1) G4cout << " New event: clearing accumulators" << G4endl;
-    trackAccum.clear();
+    ClearAccumulators();
     currentEventID = thisEvent;
   }
 
@@ -147,7 +151,7 @@ G4bool G4CMPHitMerging::ProcessStep(const G4CMPStepInfo& stepData) {
   if (verboseLevel) G4cout << "G4CMPHitMerging::ProcessStep" << G4endl;
 
   // Direct step accumulator to work with current track and event
-  accumulator = &trackAccum[stepData.trackID];	// Creates new if needed
+  accumulator = GetAccumulator(stepData.trackID);	// Creates new if needed
   accumulator->ProcessEvent(currentEventID);
 
   // Set up energy partitioning to work with current track and volume
@@ -178,6 +182,7 @@ G4bool G4CMPHitMerging::ProcessStep(const G4CMPStepInfo& stepData) {
   readyForOutput = ReadyForOutput(stepData);
   if (readyForOutput) {
     PrepareOutput();
+    readyTime = accumulator->time;
     accumulator->Clear();
   }
 
@@ -188,6 +193,31 @@ G4bool G4CMPHitMerging::ProcessStep(const G4CMPStepInfo& stepData) {
 }
 
 
+// Process steps in order, transferring any new primaries to event
+
+G4bool G4CMPHitMerging::ProcessSteps(const std::vector<G4CMPStepInfo>& steps,
+				     G4Event* primaryEvent) {
+  if (!primaryEvent) return false;
+
+  if (verboseLevel) {
+    G4cout << "G4CMPHitMerging::ProcessSteps " << steps.size() << " steps"
+	   << G4endl;
+  }
+
+  ProcessEvent(primaryEvent);
+
+  G4bool filled = false;
+  for (const G4CMPStepInfo& stepData: steps) {
+    if (ProcessStep(stepData)) {
+      FillOutput(primaryEvent, readyTime);
+      filled = true;
+    }
+  }
+
+  return filled;
+}
+
+
 // Decide if current step should be added to the accumulator
 
 G4bool G4CMPHitMerging::DoAddStep(const G4CMPStepInfo& stepData) const {
@@ -334,7 +364,7 @@ void G4CMPHitMerging::FillOutput(G4Event* primaryEvent, G4double time) {
 // Check for any non-empty accumulators, and generate primaries from them
 
 void G4CMPHitMerging::FinishOutput(G4Event* primaryEvent) {
-  if (trackAccum.empty()) return;		// Nothing to be done
+  if (accumUsed.empty()) return;		// Nothing to be done
   if (!primaryEvent) return;
 
   if (primaryEvent->GetEventID() != currentEventID) {
@@ -352,17 +382,22 @@ void G4CMPHitMerging::FinishOutput(G4Event* primaryEvent) {
 	   << G4endl;
   }
 
-  // Loop over all registered accumulators and flush them to output
-  for (const auto& trkAcc: trackAccum) {
-    FlushAccumulator(trkAcc.first, primaryEvent);
+  // Loop over all registered accumulators, in order of track ID
+  std::sort(accumUsed.begin(), accumUsed.end(),
+	    [this](size_t a, size_t b) {
+	      return accumTrackID[a] < accumTrackID[b];
+	    });
+
+  for (size_t slot: accumUsed) {
+    FlushAccumulator(accumTrackID[slot], primaryEvent);
   }
 }
 
 // Process specified accumulator into new primaries for event
 
 void G4CMPHitMerging::FlushAccumulator(G4int trkID, G4Event* primaryEvent) {
-  accumulator = &trackAccum[trkID];
-  if (accumulator->nsteps == 0) return;		// Nothing to be done
+  accumulator = FindAccumulator(trkID);
+  if (!accumulator || accumulator->nsteps == 0) return;	// Nothing to do
   
   if (verboseLevel>1) {
     G4cout << "G4CMPHitMerging::FlushAccumulator track " << trkID << " with"
@@ -376,6 +411,87 @@ void G4CMPHitMerging::FlushAccumulator(G4int trkID, G4Event* primaryEvent) {
   accumulator->Clear();
 }
 
+
+// Look up accumulator for track in table, adding new entry if needed
+
+G4CMPStepAccumulator* G4CMPHitMerging::GetAccumulator(G4int trkID) {
+  // Keep table at most half full, so probe sequences stay short
+  if (2*(accumUsed.size()+1) > accumSlots.size())
+    ResizeAccumulators(std::max<size_t>(64, 2*accumSlots.size()));
+
+  size_t slot = FindSlot(trkID);
+  if (!accumFilled[slot]) {
+    accumFilled[slot] = true;
+    accumTrackID[slot] = trkID;
+    accumUsed.push_back(slot);
+  }
+
+  return &accumSlots[slot];
+}
+
+G4CMPStepAccumulator* G4CMPHitMerging::FindAccumulator(G4int trkID) {
+  if (accumSlots.empty()) return 0;
+
+  size_t slot = FindSlot(trkID);
+  return ((accumFilled[slot] && accumTrackID[slot] == trkID)
+	  ? &accumSlots[slot] : 0);
+}
+
+// Return slot holding track ID, or empty slot where it should go
+
+size_t G4CMPHitMerging::FindSlot(G4int trkID) const {
+  const size_t mask = accumSlots.size()-1;
+
+  // Track IDs are sequential; scramble bits to spread nearby IDs out
+  size_t slot = (static_cast<uint32_t>(trkID)*2654435761u) & mask;
+  while (accumFilled[slot] && accumTrackID[slot] != trkID)
+    slot = (slot+1) & mask;
+
+  return slot;
+}
+
+// Reset occupied slots for new event, keeping table allocation
+
+void G4CMPHitMerging::ClearAccumulators() {
+  for (size_t slot: accumUsed) {
+    accumFilled[slot] = false;
+    accumSlots[slot].Clear();
+  }
+
+  accumUsed.clear();
+  accumulator = 0;
+}
+
+// Expand table to new size (power of two), moving occupied slots
+
+void G4CMPHitMerging::ResizeAccumulators(size_t size) {
+  if (verboseLevel>1)
+    G4cout << " Resizing accumulator table to " << size << " slots" << G4endl;
+
+  std::vector<G4int> oldTrackID(size, -1);
+  std::vector<G4bool> oldFilled(size, false);
+  std::vector<G4CMPStepAccumulator> oldSlots(size);
+  accumTrackID.swap(oldTrackID);
+  accumFilled.swap(oldFilled);
+  accumSlots.swap(oldSlots);
+
+  std::vector<size_t> oldUsed;
+  oldUsed.swap(accumUsed);
+  accumUsed.reserve(size/2);
+
+  // Re-insert in original order, so FinishOutput() sequence is kept
+  for (size_t oldSlot: oldUsed) {
+    size_t slot = FindSlot(oldTrackID[oldSlot]);
+    accumFilled[slot] = true;
+    accumTrackID[slot] = oldTrackID[oldSlot];
+    accumSlots[slot] = oldSlots[oldSlot];
+    accumUsed.push_back(slot);
+  }
+
+  accumulator = 0;			// Previous pointer no longer valid
+}
+
+
 // Generate intermediate points along step trajectory (straight line!)
 // NOTE:  For MSC type deposition, these points ought to be a random walk
 
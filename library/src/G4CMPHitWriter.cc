@@ -0,0 +1,241 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file library/src/G4CMPHitWriter.cc
+/// \brief Implementation of the G4CMPHitWriter class.  Buffered binary
+///	   hit output, written from a background thread.
+//
+// $Id$
+//
+// 20261017  New class, for use with electrode sensitive detectors
+// 20261017  Check header of existing file before appending to it.
+
+#include "G4CMPHitWriter.hh"
+#include "G4CMPElectrodeHit.hh"
+#include "G4CMPHitBlock.hh"
+#include "G4AutoLock.hh"
+#include "G4Exception.hh"
+#include "G4ExceptionSeverity.hh"
+#include "G4ios.hh"
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <thread>
+
+
+// Output file and writing thread, shared by all writers for same file
+
+class G4CMPHitWriter::Output {
+public:
+  // Get output for file, opening it on first use; null if file can't open
+  static Output* Attach(const G4String& fileName);
+  static void Detach(Output* output);	// Closes file after last writer
+
+  // Queue full block for writing, return empty block for reuse
+  G4CMPHitBlock* Submit(G4CMPHitBlock* block);
+
+private:
+  Output(const G4String& fileName);
+  ~Output();
+
+  void Run();				// Body of writing thread
+
+  G4String fileName;
+  std::ofstream file;
+  G4int nWriters;			// Writers attached to this output
+
+  std::thread writer;
+  std::mutex queueMutex;
+  std::condition_variable queueReady;	// Signals writer thread
+  std::condition_variable queueSpace;	// Signals waiting workers
+  std::deque<G4CMPHitBlock*> queue;	// Full blocks waiting for writer
+  std::vector<G4CMPHitBlock*> spares;	// Written blocks for reuse
+  G4bool done;
+
+  static const size_t maxQueued = 8;	// Limit on memory held in queue
+
+  // Registry is cleared at exit, so unreleased outputs are still written
+  struct Registry : public std::map<G4String, Output*> { ~Registry(); };
+  static Registry registry;
+};
+
+G4CMPHitWriter::Output::Registry G4CMPHitWriter::Output::registry;
+
+namespace {
+  G4Mutex registryMutex = G4MUTEX_INITIALIZER;	// For thread protection
+}
+
+G4CMPHitWriter::Output::Registry::~Registry() {
+  for (auto& entry: *this) delete entry.second;
+  clear();
+}
+
+
+// Open file for appending, writing file header if file is new; existing
+// file must have been written in the same format
+
+G4CMPHitWriter::Output::Output(const G4String& name)
+  : fileName(name), nWriters(0), done(false) {
+  std::ifstream existing(fileName, std::ios::binary);
+  if (existing.good() && existing.peek() != EOF &&
+      !G4CMPHitBlock::ReadHeader(existing)) {
+    G4ExceptionDescription msg;
+    msg << "Output file " << fileName << " exists, but is not a G4CMP binary"
+	<< " hit file of this version and byte order.\n"
+	<< "Hits will not be appended; remove it or choose another name.";
+    G4Exception("G4CMPHitWriter::Output", "HitWriter002", FatalException,
+		msg);
+    return;				// File left closed; Attach() fails
+  }
+  existing.close();
+
+  file.open(fileName, std::ios::binary|std::ios::app);
+  if (!file.good()) return;
+
+  file.seekp(0, std::ios::end);
+  if (file.tellp() == std::streampos(0)) G4CMPHitBlock::WriteHeader(file);
+
+  writer = std::thread(&Output::Run, this);
+}
+
+G4CMPHitWriter::Output::~Output() {
+  if (writer.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(queueMutex);
+      done = true;
+    }
+    queueReady.notify_one();
+    writer.join();
+  }
+
+  for (G4CMPHitBlock* block: spares) delete block;
+
+  if (!file.is_open()) return;		// Never opened, nothing written
+
+  file.close();
+  if (!file.good()) {
+    G4cerr << "Error closing output file, " << fileName << ".\n"
+	   << "Expect bad things like loss of data." << G4endl;
+  }
+}
+
+G4CMPHitWriter::Output* G4CMPHitWriter::Output::Attach(const G4String& name) {
+  G4AutoLock l(&registryMutex);
+
+  Output*& output = registry[name];
+  if (!output) {
+    output = new Output(name);
+    if (!output->file.is_open() || !output->file.good()) {
+      delete output;
+      registry.erase(name);
+      return 0;
+    }
+  }
+
+  output->nWriters++;
+  return output;
+}
+
+void G4CMPHitWriter::Output::Detach(Output* output) {
+  if (!output) return;
+
+  G4AutoLock l(&registryMutex);
+  if (--output->nWriters > 0) return;
+
+  registry.erase(output->fileName);
+  delete output;			// Waits for queued blocks to be written
+}
+
+
+// Hand off block to writer thread, waiting if it has fallen behind
+
+G4CMPHitBlock* G4CMPHitWriter::Output::Submit(G4CMPHitBlock* block) {
+  std::unique_lock<std::mutex> lock(queueMutex);
+  queueSpace.wait(lock, [this]() { return queue.size() < maxQueued; });
+
+  queue.push_back(block);
+
+  G4CMPHitBlock* spare = 0;
+  if (!spares.empty()) {
+    spare = spares.back();
+    spares.pop_back();
+  }
+
+  lock.unlock();
+  queueReady.notify_one();
+
+  return spare ? spare : new G4CMPHitBlock;
+}
+
+// Write blocks as they arrive; file output is done outside of lock
+
+void G4CMPHitWriter::Output::Run() {
+  std::unique_lock<std::mutex> lock(queueMutex);
+  while (true) {
+    queueReady.wait(lock, [this]() { return done || !queue.empty(); });
+    if (queue.empty()) break;		// Only when done
+
+    G4CMPHitBlock* block = queue.front();
+    queue.pop_front();
+    queueSpace.notify_one();
+
+    lock.unlock();
+    if (!block->Write(file)) {
+      G4cerr << "G4CMPHitWriter: error writing " << block->Size()
+	     << " hits to " << fileName << G4endl;
+    }
+    block->Clear();
+    lock.lock();
+
+    spares.push_back(block);
+  }
+
+  file.flush();
+}
+
+
+// Constructor and destructor
+
+G4CMPHitWriter::G4CMPHitWriter(const G4String& name, size_t size)
+  : fileName(name), blockSize(size>0 ? size : 1),
+    output(Output::Attach(name)), block(new G4CMPHitBlock(blockSize)) {
+  if (!output) {
+    G4ExceptionDescription msg;
+    msg << "Error opening output file " << fileName;
+    G4Exception("G4CMPHitWriter::G4CMPHitWriter", "HitWriter001",
+		FatalException, msg);
+  }
+}
+
+G4CMPHitWriter::~G4CMPHitWriter() {
+  Flush();
+  Output::Detach(output);
+  delete block;
+}
+
+
+// Copy hits into current block, passing full blocks to output thread
+
+void G4CMPHitWriter::Add(G4int runID, G4int eventID,
+			 const G4CMPElectrodeHit* hit) {
+  if (!output || !hit) return;
+
+  block->Add(runID, eventID, *hit);
+  if (block->Size() >= blockSize) Flush();
+}
+
+void G4CMPHitWriter::Add(G4int runID, G4int eventID,
+			 const std::vector<G4CMPElectrodeHit*>& hits) {
+  for (const G4CMPElectrodeHit* hit: hits) Add(runID, eventID, hit);
+}
+
+void G4CMPHitWriter::Flush() {
+  if (!output || block->Empty()) return;
+
+  block = output->Submit(block);
+  block->Reserve(blockSize);
+}
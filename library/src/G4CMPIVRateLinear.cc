@@ -11,6 +11,7 @@
 //
 // 20181001  Use systematic names for IV rate parameters
 // 20210908  Use global track position to query field; configure field.
+// 20261017  Split Rate() into field lookup and rate computation.
 
 #include "G4CMPIVRateLinear.hh"
 #include "G4Field.hh"
@@ -28,13 +29,19 @@
 // Scattering rate is computed from electric field
 
 G4double G4CMPIVRateLinear::Rate(const G4Track& aTrack) const {
+  // If there is no field, there is no IV scattering... but then there
+  // is no e-h transport either...
+  G4double field = RateVariable(aTrack);
+  return (field >= 0. ? RateFromVariable(field) : 0.);
+}
+
+// Get electric field magnitude in HV space, or -1 if no field in volume
+
+G4double G4CMPIVRateLinear::RateVariable(const G4Track& aTrack) const {
   // Get electric field associated with current volume, if any
   G4FieldManager* fMan =
     aTrack.GetVolume()->GetLogicalVolume()->GetFieldManager();
-  
-  // If there is no field, there is no IV scattering... but then there
-  // is no e-h transport either...
-  if (!fMan || !fMan->DoesFieldExist()) return 0.;
+  if (!fMan || !fMan->DoesFieldExist()) return -1.;
 
   G4double posVec[4] = { 4*0. };
   GetGlobalPosition(aTrack, posVec);
@@ -65,11 +72,21 @@ G4double G4CMPIVRateLinear::Rate(const G4Track& aTrack) const {
 	   << fieldVector.mag() << ") V/cm" << G4endl;
   }
 
+  return fieldVector.mag();
+}
+
+G4double G4CMPIVRateLinear::RateFromVariable(G4double field,
+					     G4int /*chan*/) const {
   // Compute mean free path -- NOTE FIELD UNITS ARE V/cm HERE
   G4double rate = theLattice->GetIVLinRate0() +
-    theLattice->GetIVLinRate1() * pow(fieldVector.mag(),
-				      theLattice->GetIVLinExponent());
+    theLattice->GetIVLinRate1() * pow(field, theLattice->GetIVLinExponent());
 
   if (verboseLevel > 1) G4cout << "IV rate = " << rate/hertz << " Hz" << G4endl;
   return rate;
 }
+
+// Typical detector fields are a few V/cm; tables are extended as needed
+
+G4double G4CMPIVRateLinear::RateVariableScale(G4int /*chan*/) const {
+  return 100.;				// V/cm, without units (see above)
+}
@@ -12,6 +12,7 @@
 // 20170815  Drop call to LoadDataForTrack(); now handled in process.
 // 20181001  Use systematic names for IV rate parameters
 // 20210908  Use global track position to query field; configure field.
+// 20261017  Split Rate() into field lookup and rate computation.
 
 #include "G4CMPIVRateQuadratic.hh"
 #include "G4Field.hh"
@@ -29,13 +30,19 @@
 // Scattering rate is computed from electric field
 
 G4double G4CMPIVRateQuadratic::Rate(const G4Track& aTrack) const {
+  // If there is no field, there is no IV scattering... but then there
+  // is no e-h transport either...
+  G4double field = RateVariable(aTrack);
+  return (field >= 0. ? RateFromVariable(field) : 0.);
+}
+
+// Get electric field magnitude in HV space, or -1 if no field in volume
+
+G4double G4CMPIVRateQuadratic::RateVariable(const G4Track& aTrack) const {
   // Get electric field associated with current volume, if any
   G4FieldManager* fMan =
     aTrack.GetVolume()->GetLogicalVolume()->GetFieldManager();
-  
-  // If there is no field, there is no IV scattering... but then there
-  // is no e-h transport either...
-  if (!fMan || !fMan->DoesFieldExist()) return 0.;
+  if (!fMan || !fMan->DoesFieldExist()) return -1.;
 
   G4double posVec[4] = { 4*0. };
   GetGlobalPosition(aTrack, posVec);
@@ -67,11 +74,22 @@ G4double G4CMPIVRateQuadratic::Rate(const G4Track& aTrack) const {
 	   << fieldVector.mag()*0.01 << ") V/cm" << G4endl;
   }
 
-  // Compute mean free path; field vector units are V/m below
+  return fieldVector.mag();
+}
+
+G4double G4CMPIVRateQuadratic::RateFromVariable(G4double field,
+						G4int /*chan*/) const {
+  // Compute mean free path; field units are V/m below
   G4double E_0 = theLattice->GetIVQuadField() / (volt/m);
   G4double rate = theLattice->GetIVQuadRate() *
-    pow((E_0*E_0 + fieldVector.mag2()), theLattice->GetIVQuadExponent()/2.0);
+    pow((E_0*E_0 + field*field), theLattice->GetIVQuadExponent()/2.0);
 
   if (verboseLevel > 1) G4cout << "IV rate = " << rate/hertz << " Hz" << G4endl;
   return rate;
 }
+
+// Typical detector fields are a few V/cm; tables are extended as needed
+
+G4double G4CMPIVRateQuadratic::RateVariableScale(G4int /*chan*/) const {
+  return 1e4;				// V/m, without units (see above)
+}
@@ -12,6 +12,7 @@
 // 20170830  Follow Jacoboni, with unified D0/D1 expression and units; drop
 //		acoustic rate, as it is _intra_valley.
 // 20170919  Add interface for threshold identification
+// 20261017  Split Rate() into energy lookup and computation, for tables.
 
 #include "G4CMPInterValleyRate.hh"
 #include "G4LatticePhysical.hh"
@@ -21,6 +22,7 @@
 #include "G4SystemOfUnits.hh"
 #include "G4Track.hh"
 #include "G4VPhysicalVolume.hh"
+#include <algorithm>
 #include <math.h>
 
 
@@ -48,9 +50,17 @@ void G4CMPInterValleyRate::LoadDataForTrack(const G4Track* track) {
 
 G4double G4CMPInterValleyRate::Rate(const G4Track& aTrack) const {
   const_cast<G4CMPInterValleyRate*>(this)->LoadDataForTrack(&aTrack);
+  return RateFromVariable(RateVariable(aTrack));
+}
+
+G4double G4CMPInterValleyRate::RateVariable(const G4Track& aTrack) const {
+  return GetKineticEnergy(aTrack);
+}
 
+G4double G4CMPInterValleyRate::RateFromVariable(G4double energy,
+						G4int /*chan*/) const {
   // Initialize numerical buffers
-  eTrk = GetKineticEnergy(aTrack);
+  eTrk = energy;
   if (verboseLevel>1)
     G4cout << "G4CMPInterValleyRate eTrk " << eTrk/eV << " eV" << G4endl;
 
@@ -115,6 +125,17 @@ G4double G4CMPInterValleyRate::scatterRate() const {
 }
 
 
+// Tables should extend well past the highest intervalley threshold
+
+G4double G4CMPInterValleyRate::RateVariableScale(G4int /*chan*/) const {
+  G4double Emax = 0.;
+  for (G4int i=0; i<theLattice->GetNIVDeform(); i++)
+    Emax = std::max(Emax, theLattice->GetIVEnergy(i));
+
+  return (Emax > 0. ? 4.*Emax : 0.1*eV);
+}
+
+
 // Identify next energy threshold (if any) above specified input
 
 G4double G4CMPInterValleyRate::Threshold(G4double Eabove) const {
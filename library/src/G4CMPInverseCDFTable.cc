@@ -0,0 +1,116 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file library/src/G4CMPInverseCDFTable.cc
+/// \brief Implementation of the G4CMPInverseCDFTable class.  Tabulates
+///	   inverse cumulative distributions for constant-time sampling.
+//
+// $Id$
+//
+// 20261017  New class, for use with G4CMPKaplanQP energy distributions
+
+#include "G4CMPInverseCDFTable.hh"
+#include "Randomize.hh"
+#include <algorithm>
+#include <cmath>
+
+
+// Constructors
+
+G4CMPInverseCDFTable::G4CMPInverseCDFTable()
+  : vMin(0.), vMax(0.), vStep(0.), nRows(0), nBins(0), nGuide(0) {;}
+
+G4CMPInverseCDFTable::G4CMPInverseCDFTable(G4double vmin, G4double vmax,
+					   size_t rows, const PDF& pdf,
+					   size_t bins, size_t guides)
+  : G4CMPInverseCDFTable() {
+  Build(vmin, vmax, rows, pdf, bins, guides);
+}
+
+void G4CMPInverseCDFTable::Clear() {
+  vMin = vMax = vStep = 0.;
+  nRows = nBins = nGuide = 0;
+  cdfTable.clear();
+  guideTable.clear();
+}
+
+
+// Integrate each row with midpoint rule, so PDF is never evaluated at the
+// endpoints (where it may be singular), then fill guide table
+
+void G4CMPInverseCDFTable::Build(G4double vmin, G4double vmax, size_t rows,
+				 const PDF& pdf, size_t bins, size_t guides) {
+  Clear();
+  if (rows < 1 || bins < 1 || guides < 1 || vmax < vmin) {
+    G4Exception("G4CMPInverseCDFTable::Build", "InvCDF001", JustWarning,
+		"Invalid table dimensions; table will not be used.");
+    return;
+  }
+
+  vMin = vmin;
+  vMax = vmax;
+  nRows = rows;
+  vStep = (nRows>1 ? (vMax-vMin)/(nRows-1) : 0.);
+  nBins = bins;
+  nGuide = guides;
+  cdfTable.resize(nRows*(nBins+1));
+  guideTable.resize(nRows*nGuide);
+
+  const G4double ds = 1./nBins;
+
+  for (size_t i=0; i<nRows; i++) {
+    G4double v = vMin + i*vStep;
+    G4double* cdf = &cdfTable[i*(nBins+1)];
+
+    cdf[0] = 0.;
+    for (size_t k=0; k<nBins; k++) {
+      G4double p = pdf(v, (k+0.5)*ds);
+      cdf[k+1] = cdf[k] + ((std::isfinite(p) && p>0.) ? p : 0.);
+    }
+
+    const G4double total = cdf[nBins];
+    for (size_t k=1; k<=nBins; k++) {	// Empty row is uniform in s
+      cdf[k] = (total > 0.) ? cdf[k]/total : G4double(k)/nBins;
+    }
+    cdf[nBins] = 1.;			// Avoid roundoff at the end
+
+    // Guide points to last bin starting at or below each probability step
+    G4int* guide = &guideTable[i*nGuide];
+    size_t k = 0;
+    for (size_t j=0; j<nGuide; j++) {
+      G4double prob = G4double(j)/nGuide;
+      while (k < nBins-1 && cdf[k+1] <= prob) k++;
+      guide[j] = k;
+    }
+  }
+}
+
+
+// Draw from one of the two rows around v, weighted by distance
+
+G4double G4CMPInverseCDFTable::Sample(G4double v) const {
+  if (!IsReady()) return G4UniformRand();
+
+  size_t row = 0;
+  if (nRows > 1) {
+    G4double fv = std::min(std::max((v-vMin)/vStep, 0.), G4double(nRows-1));
+    row = size_t(fv);
+    if (row < nRows-1 && G4UniformRand() < fv-row) row++;
+  }
+
+  return InverseCDF(row, G4UniformRand());
+}
+
+G4double G4CMPInverseCDFTable::InverseCDF(size_t row, G4double prob) const {
+  const G4double* cdf = &cdfTable[row*(nBins+1)];
+
+  size_t k = guideTable[row*nGuide + std::min(size_t(prob*nGuide), nGuide-1)];
+  while (k < nBins-1 && cdf[k+1] < prob) k++;
+
+  G4double dcdf = cdf[k+1]-cdf[k];
+  G4double frac = (dcdf > 0.) ? (prob-cdf[k])/dcdf : 0.;
+
+  return (k + std::min(std::max(frac, 0.), 1.)) / nBins;
+}
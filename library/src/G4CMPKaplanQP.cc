@@ -65,18 +65,53 @@
 // 20240502  G4CMP-378: Correct expression for phonon-QP scattering energy.
 // 20240502  G4CMP-379: Add fallback use of temperature from ConfigManager.
 //		Add Fermi-Dirac occupation statistics for QP energy spectrum.
+// 20261017  Sample QP and phonon energies from inverse-CDF tables (in units
+//		of gap energy), built on first use.  Rejection sampling is
+//		kept for energies outside the tables.
+// 20261017  Add fast mode (G4CMPConfigManager::UseKaplanFastMode()), which
+//		samples tabulated cascade results for each set of film
+//		parameters, instead of running the cascade for every phonon.
+// 20261017  Film response tables are built once, under a mutex, and shared
+//		by all threads; number of tables is limited, and size is
+//		reported.  DoCascade() takes a quiet flag for tabulation.
+// 20261017  Build film response tables outside the mutex, with a separate
+//		engine seeded from the film parameters, so contents do not
+//		depend on thread.  Add PrepareFilmResponse() to build tables
+//		at initialization.
+// 20261017  Phonon energy table used only from its first row; energies
+//		below it fall back to rejection sampling.
 
 #include "globals.hh"
 #include "G4CMPKaplanQP.hh"
 #include "G4CMPConfigManager.hh"
+#include "G4CMPInverseCDFTable.hh"
 #include "G4CMPUtils.hh"
+#include "G4AutoLock.hh"
 #include "G4MaterialPropertiesTable.hh"
 #include "G4PhysicalConstants.hh"
 #include "G4SystemOfUnits.hh"
 #include "Randomize.hh"
+#include "CLHEP/Random/MixMaxRng.h"
+#include <cmath>
 #include <numeric>
 
 
+// Parameters for energy distributions and their sampling tables
+
+namespace {
+  const G4double BUFF = 1000.;		// Keep away from endpoint singularities
+  const G4double tableMaxE = 1000.;	// Largest E/gap in sampling tables
+  const size_t tableRows = 128;		// Log spacing of above-threshold E
+
+  const size_t responseRows = 128;	// Log spacing of E/gap-1
+  const size_t responseCascades = 1000;	// Cascade results at each energy
+  const size_t maxResponses = 16;	// Film parameter sets tabulated
+
+  // Film response tables shared by all threads, never modified once built
+  G4Mutex responseMutex = G4MUTEX_INITIALIZER;
+}
+
+
 // Global function for Kaplan quasiparticle downconversion.  Retained here
 // temporarily for migration to factory class
 
@@ -97,7 +132,7 @@ G4double G4CMP::KaplanPhononQP(G4double energy,
 // Class constructor and destructor
 
 G4CMPKaplanQP::G4CMPKaplanQP(G4MaterialPropertiesTable* prop, G4int vb)
-  : verboseLevel(vb), keepAllPhonons(true),
+  : verboseLevel(vb), keepAllPhonons(true), quietCascade(false),
     filmProperties(0), filmThickness(0.), gapEnergy(0.),
     lowQPLimit(3.), highQPLimit(0.), directAbsorption(0.), absorberGap(0.),
     absorberEff(1.), absorberEffSlope(0.), phononLifetime(0.), 
@@ -228,6 +263,31 @@ AbsorbPhonon(G4double energy, std::vector<G4double>& reflectedEnergies) const {
   // quasiparticles, new phonons, and absorbed energy
   G4double EDep = 0.;
 
+  const FilmResponse* response = nullptr;
+  if (G4CMPConfigManager::UseKaplanFastMode() && InFilmResponse(energy))
+    response = GetFilmResponse();
+
+  if (response) {
+    EDep = SampleFilmResponse(*response, energy, reflectedEnergies);
+  } else {
+    EDep = DoCascade(energy, reflectedEnergies);
+  }
+
+  ReportAbsorption(energy, EDep, reflectedEnergies);
+
+  return EDep;
+}
+
+
+// Phonon goes into superconductor and gets partitioned into
+// quasiparticles, new phonons, and absorbed energy
+
+G4double G4CMPKaplanQP::
+DoCascade(G4double energy, std::vector<G4double>& reflectedEnergies,
+	  G4bool quiet) const {
+  G4double EDep = 0.;
+  quietCascade = quiet;		// Applies to all Calc*() functions below
+
   // Divide incident phonon according to maximum QP energy (or no split)
   G4int nQPpairs =
     (highQPLimit>0. ? std::ceil(energy/(2.*highQPLimit*gapEnergy)) : 1);
@@ -237,7 +297,7 @@ AbsorbPhonon(G4double energy, std::vector<G4double>& reflectedEnergies) const {
   phononEnergyList.clear();
   phononEnergyList.resize(nQPpairs, energy/nQPpairs);
 
-  if (verboseLevel>1 && nQPpairs>1)
+  if (CascadeVerbose()>1 && nQPpairs>1)
     G4cout << " divided into " << nQPpairs << " QP pairs" << G4endl;
 
   while (!qpEnergyList.empty() || !phononEnergyList.empty()) {
@@ -259,11 +319,160 @@ AbsorbPhonon(G4double energy, std::vector<G4double>& reflectedEnergies) const {
     }
   }
 
-  ReportAbsorption(energy, EDep, reflectedEnergies);
-
+  quietCascade = false;
   return EDep;
 }
 
+
+// Fast mode:  Tabulate cascade results for current film parameters, with
+// incident energies from 2*gap to tableMaxE*gap, log-spaced in (E/gap-1) to
+// resolve the thresholds near 2*gap.  Results are scaled to the actual
+// incident energy, using one of the two adjacent rows.
+
+G4bool G4CMPKaplanQP::InFilmResponse(G4double energy) const {
+  return (gapEnergy > 0. && energy >= 2.*gapEnergy &&
+	  energy <= tableMaxE*gapEnergy);
+}
+
+const G4CMPKaplanQP::FilmResponse* G4CMPKaplanQP::GetFilmResponse() const {
+  // All parameters which affect the cascade identify the table
+  const G4double params[] = {
+    filmThickness, gapEnergy, lowQPLimit, highQPLimit, directAbsorption,
+    absorberGap, absorberEff, absorberEffSlope, phononLifetime,
+    phononLifetimeSlope, vSound, temperature, G4double(keepAllPhonons)
+  };
+  uint64_t key = G4CMP::HashBytes(params, sizeof(params));
+
+  // Tables already used by this instance are found without locking
+  auto known = filmResponses.find(key);
+  if (known != filmResponses.end()) return known->second;
+
+  // Map entries are never erased, so references remain valid after unlock
+  static std::map<uint64_t, FilmResponse> sharedResponses;
+
+  {
+    G4AutoLock l(&responseMutex);	// Only held for lookup and insertion
+    auto shared = sharedResponses.find(key);
+    if (shared != sharedResponses.end()) {
+      filmResponses[key] = &shared->second;
+      return &shared->second;
+    }
+
+    if (sharedResponses.size() >= maxResponses) {
+      if (verboseLevel) {
+	G4cout << "G4CMPKaplanQP already has " << maxResponses
+	       << " film response tables; running full cascades" << G4endl;
+      }
+      filmResponses[key] = nullptr;	// Don't ask again for these parameters
+      return nullptr;
+    }
+  }
+
+  // Table is the same whichever thread builds it, so others need not wait
+  FilmResponse response;
+  FillFilmResponse(response, key);
+
+  G4AutoLock l(&responseMutex);
+  auto shared = sharedResponses.emplace(key, std::move(response)).first;
+  filmResponses[key] = &shared->second;
+  return &shared->second;
+}
+
+// Run cascades with a separate engine, seeded from the film parameters, so
+// that table contents do not depend on which thread (or event) builds them,
+// and the caller's random number sequence is not disturbed
+
+void G4CMPKaplanQP::FillFilmResponse(FilmResponse& response,
+				     uint64_t key) const {
+  if (verboseLevel) {
+    G4cout << "G4CMPKaplanQP building film response table with "
+	   << responseRows << " x " << responseCascades << " cascades"
+	   << G4endl;
+  }
+
+  CLHEP::MixMaxRng tableEngine(static_cast<long>(key >> 1));
+  CLHEP::HepRandomEngine* callerEngine = G4Random::getTheEngine();
+  G4Random::setTheEngine(&tableEngine);
+
+  const G4double dv = std::log(tableMaxE-1.) / (responseRows-1);
+
+  response.eDep.reserve(responseRows*responseCascades);
+  response.reflStart.reserve(responseRows*responseCascades+1);
+  response.reflStart.push_back(0);
+
+  std::vector<G4double> reflected;
+  for (size_t i=0; i<responseRows; i++) {
+    G4double E = gapEnergy*(1.+std::exp(i*dv));
+
+    for (size_t j=0; j<responseCascades; j++) {
+      reflected.clear();
+      response.eDep.push_back(DoCascade(E, reflected, true)/E);
+
+      for (const G4double& ER: reflected) response.reflected.push_back(ER/E);
+      response.reflStart.push_back(response.reflected.size());
+    }
+  }
+
+  G4Random::setTheEngine(callerEngine);
+
+  response.reflected.shrink_to_fit();
+
+  if (verboseLevel) {
+    size_t nbytes = (response.eDep.capacity()*sizeof(G4double) +
+		     response.reflStart.capacity()*sizeof(size_t) +
+		     response.reflected.capacity()*sizeof(G4double));
+    G4cout << "G4CMPKaplanQP film response table uses " << nbytes/1024
+	   << " kB" << G4endl;
+  }
+}
+
+// Build table in advance (e.g., at detector construction, on master) for
+// film described by properties table; does nothing unless fast mode is set
+
+void G4CMPKaplanQP::PrepareFilmResponse(G4MaterialPropertiesTable* prop,
+					G4int vb) {
+  if (!prop || !G4CMPConfigManager::UseKaplanFastMode()) return;
+
+  if (!(prop->ConstPropertyExists("gapEnergy") &&
+        prop->ConstPropertyExists("phononLifetime") &&
+        prop->ConstPropertyExists("phononLifetimeSlope") &&
+        prop->ConstPropertyExists("vSound") &&
+        prop->ConstPropertyExists("filmThickness"))) return;
+
+  G4CMPKaplanQP kaplanQP(prop, vb);
+  kaplanQP.keepAllPhonons = G4CMPConfigManager::KeepKaplanPhonons();
+  if (kaplanQP.ParamsReady()) kaplanQP.GetFilmResponse();
+}
+
+G4double 
+G4CMPKaplanQP::SampleFilmResponse(const FilmResponse& response,
+				  G4double energy,
+				  std::vector<G4double>& reflectedEnergies) const {
+  const G4double dv = std::log(tableMaxE-1.) / (responseRows-1);
+
+  G4double fv = std::log(energy/gapEnergy-1.) / dv;
+  fv = std::min(std::max(fv, 0.), G4double(responseRows-1));
+  size_t row = size_t(fv);
+  if (row < responseRows-1 && G4UniformRand() < fv-row) row++;
+
+  size_t icas = std::min(size_t(G4UniformRand()*responseCascades),
+			 responseCascades-1);
+  icas += row*responseCascades;
+
+  for (size_t i=response.reflStart[icas]; i<response.reflStart[icas+1]; i++) {
+    reflectedEnergies.push_back(response.reflected[i]*energy);
+  }
+
+  if (verboseLevel>1) {
+    G4cout << " film response row " << row << " deposits "
+	   << response.eDep[icas]*energy << " reflects "
+	   << response.reflStart[icas+1]-response.reflStart[icas]
+	   << " phonons" << G4endl;
+  }
+
+  return response.eDep[icas]*energy;
+}
+
 void G4CMPKaplanQP::
 ReportAbsorption(G4double energy, G4double EDep,
 		 const std::vector<G4double>& reflectedEnergies) const {
@@ -298,7 +507,7 @@ ReportAbsorption(G4double energy, G4double EDep,
 
 G4double G4CMPKaplanQP::CalcEscapeProbability(G4double energy,
 					      G4double thicknessFrac) const {
-  if (verboseLevel>1) {
+  if (CascadeVerbose()>1) {
     G4cout << "G4CMPKaplanQP::CalcEscapeProbability E " << energy
 	   << " thickFrac " << thicknessFrac << G4endl;
   }
@@ -310,7 +519,7 @@ G4double G4CMPKaplanQP::CalcEscapeProbability(G4double energy,
                  (1. + phononLifetimeSlope * (energy/gapEnergy - 2.));
   G4double path = thicknessFrac * filmThickness;
 
-  if (verboseLevel>2) {
+  if (CascadeVerbose()>2) {
     G4cout << " mfp " << mfp << " path " << path << " returning "
 	   << std::exp(-2.*thicknessFrac*filmThickness/mfp) << G4endl;
   }
@@ -325,7 +534,7 @@ G4double G4CMPKaplanQP::CalcEscapeProbability(G4double energy,
 G4double 
 G4CMPKaplanQP::CalcQPEnergies(std::vector<G4double>& phonEnergies,
 			      std::vector<G4double>& qpEnergies) const {
-  if (verboseLevel>1) {
+  if (CascadeVerbose()>1) {
     G4cout << "G4CMPKaplanQP::CalcQPEnergies QPcut " << lowQPLimit*gapEnergy
 	   << G4endl;
   }
@@ -336,13 +545,13 @@ G4CMPKaplanQP::CalcQPEnergies(std::vector<G4double>& phonEnergies,
 
   for (const G4double& E: phonEnergies) {
     if (IsSubgap(E)) {
-      if (verboseLevel>2) G4cout << " Skipping phononE " << E << G4endl;
+      if (CascadeVerbose()>2) G4cout << " Skipping phononE " << E << G4endl;
       newPhonEnergies.push_back(E);
       continue;
     }
 
     G4double qpE = QPEnergyRand(E);
-    if (verboseLevel>2) {
+    if (CascadeVerbose()>2) {
       G4cout << " phononE " << E << " qpE1 " << qpE << " qpE2 " << E-qpE
 	     << G4endl;
     }
@@ -351,7 +560,7 @@ G4CMPKaplanQP::CalcQPEnergies(std::vector<G4double>& phonEnergies,
     EDep += CalcQPAbsorption(E-qpE, newPhonEnergies, qpEnergies);
   }	// for (E: ...)
 
-  if (verboseLevel>1)
+  if (CascadeVerbose()>1)
     G4cout << " replacing phonEnergies, returning EDep " << EDep << G4endl;
 
   phonEnergies.swap(newPhonEnergies);
@@ -365,7 +574,7 @@ G4CMPKaplanQP::CalcQPEnergies(std::vector<G4double>& phonEnergies,
 G4double 
 G4CMPKaplanQP::CalcPhononEnergies(std::vector<G4double>& phonEnergies,
 				  std::vector<G4double>& qpEnergies) const {
-  if (verboseLevel>1) {
+  if (CascadeVerbose()>1) {
     G4cout << "G4CMPKaplanQP::CalcPhononEnergies 2*gap " << 2.*gapEnergy
 	   << " QPcut " << lowQPLimit*gapEnergy << G4endl;
   }
@@ -374,24 +583,24 @@ G4CMPKaplanQP::CalcPhononEnergies(std::vector<G4double>& phonEnergies,
   G4double EDep = 0.;
   newQPEnergies.clear();
   for (const G4double& E: qpEnergies) {
-    if (verboseLevel>2) G4cout << " qpE " << E;		// Report before change
+    if (CascadeVerbose()>2) G4cout << " qpE " << E;		// Report before change
 
     G4double phonE = PhononEnergyRand(E);
     G4double qpE = E - phonE;
-    if (verboseLevel>2)
+    if (CascadeVerbose()>2)
       G4cout << " phononE " << phonE << " qpE " << qpE << G4endl;
 
     if (IsSubgap(phonE)) {
       EDep += CalcDirectAbsorption(phonE, phonEnergies);
     } else {
-      if (verboseLevel>2) G4cout << " Store phonE in phonEnergies" << G4endl;
+      if (CascadeVerbose()>2) G4cout << " Store phonE in phonEnergies" << G4endl;
       phonEnergies.push_back(phonE);
     }
 
     EDep += CalcQPAbsorption(qpE, phonEnergies, newQPEnergies);
   }	// for (E: ...)
 
-  if (verboseLevel>1)
+  if (CascadeVerbose()>1)
     G4cout << " replacing qpEnergies, returning EDep " << EDep << G4endl;
 
   qpEnergies.swap(newQPEnergies);
@@ -404,13 +613,13 @@ G4CMPKaplanQP::CalcPhononEnergies(std::vector<G4double>& phonEnergies,
 void G4CMPKaplanQP::
 CalcReflectedPhononEnergies(std::vector<G4double>& phonEnergies,
                             std::vector<G4double>& reflectedEnergies) const {
-  if (verboseLevel>1)
+  if (CascadeVerbose()>1)
     G4cout << "G4CMPKaplanQP::CalcReflectedPhononEnergies " << G4endl;
 
   // There is a 50% chance that a phonon is headed away from (toward) substrate
   newPhonEnergies.clear();
   for (const G4double& E: phonEnergies) {
-    if (verboseLevel>2) G4cout << " phononE " << E << G4endl;
+    if (CascadeVerbose()>2) G4cout << " phononE " << E << G4endl;
 
     // Test for thermalization; thermal phonons are dropped from consideration
     if (G4CMP::IsThermalized(temperature, E)) continue;
@@ -423,7 +632,7 @@ CalcReflectedPhononEnergies(std::vector<G4double>& phonEnergies,
 		       / cos(G4UniformRand()*1.47) );	// up to cos(th) = 0.1
 
     if (G4UniformRand() < CalcEscapeProbability(E, frac)) {
-      if (verboseLevel>2) G4cout << " phononE got reflected" << G4endl;
+      if (CascadeVerbose()>2) G4cout << " phononE got reflected" << G4endl;
       reflectedEnergies.push_back(E);
     } else if (keepAllPhonons || !IsSubgap(E)) {
       newPhonEnergies.push_back(E);
@@ -437,24 +646,24 @@ CalcReflectedPhononEnergies(std::vector<G4double>& phonEnergies,
 // Compute probability of absorbing phonon below Cooper-pair breaking
 
 G4bool G4CMPKaplanQP::DoDirectAbsorption(G4double energy) const {
-  if (verboseLevel>1) {
+  if (CascadeVerbose()>1) {
     G4cout << "G4CMPKaplanQP::DoDirectAbsorption E " << energy
 	   << " directAbs " << directAbsorption << G4endl;
   }
 
   if (energy < 2.*absorberGap) {	// Below absorber should just be killed
-    if (verboseLevel>2)
+    if (CascadeVerbose()>2)
       G4cout << " Kill phonon " << energy << " below absorber gap" << G4endl;
     return false;
   }
   
   if (G4UniformRand() < directAbsorption) {
-    if (verboseLevel>2)
+    if (CascadeVerbose()>2)
       G4cout << " Deposit phonon " << energy << " as heat" << G4endl;
     return true;
   }
   
-  if (verboseLevel>2)
+  if (CascadeVerbose()>2)
     G4cout << " Record phonon " << energy << " for processing" << G4endl;
   return false;
 }
@@ -481,10 +690,10 @@ G4CMPKaplanQP::CalcQPAbsorption(G4double qpE,
   if (G4UniformRand() > CalcQPEfficiency(qpE)) return 0.;
 
   if (qpE >= lowQPLimit*gapEnergy) {
-    if (verboseLevel>2) G4cout << " Storing qpE in qpEnergies" << G4endl;
+    if (CascadeVerbose()>2) G4cout << " Storing qpE in qpEnergies" << G4endl;
     qpEnergies.push_back(qpE);
   } else if (qpE > gapEnergy) {
-    if (verboseLevel>2) G4cout << " Reducing qpE to gapEnergy" << G4endl;
+    if (CascadeVerbose()>2) G4cout << " Reducing qpE to gapEnergy" << G4endl;
     EDep += CalcDirectAbsorption(qpE-gapEnergy, phonEnergies);
     EDep += gapEnergy;
   } else {
@@ -501,7 +710,7 @@ G4double G4CMPKaplanQP::CalcQPEfficiency(G4double qpE) const {
   G4double eff = absorberEff + absorberEffSlope * qpE/gapEnergy;
   eff = std::max(0., std::min(eff, 1.));
 
-  if (verboseLevel>2) {
+  if (CascadeVerbose()>2) {
     G4cout << " CalcQPEfficiency qpE " << qpE << " eff " << eff << G4endl;
   }
 
@@ -512,8 +721,9 @@ G4double G4CMPKaplanQP::CalcQPEfficiency(G4double qpE) const {
 // Compute quasiparticle energy distribution from broken Cooper pair.
 
 G4double G4CMPKaplanQP::QPEnergyRand(G4double Energy) const {
-  // PDF is not integrable, so we can't do an inverse transform sampling.
-  // Instead, we'll do a rejection method.
+  // PDF is not integrable, so we can't do an analytic inverse transform.
+  // It is tabulated numerically (see GetQPEnergyTable()); outside of the
+  // table, we'll do a rejection method.
   //
   // PDF(E') = (E'*(Energy - E') + gapEnergy*gapEnergy)
   //           /
@@ -523,9 +733,15 @@ G4double G4CMPKaplanQP::QPEnergyRand(G4double Energy) const {
   // E' = gapEnergy and E' = Energy - gapEnergy
 
   // Add buffer so first/last bins don't give zero denominator in pdfSum
-  const G4double BUFF = 1000.;
   G4double xmin = gapEnergy + (Energy-2.*gapEnergy)/BUFF;
   G4double xmax = gapEnergy + (Energy-2.*gapEnergy)*(BUFF-1.)/BUFF;
+
+  const G4CMPInverseCDFTable* table = GetQPEnergyTable(Energy);
+  if (table) {
+    G4double sinS = std::sin(halfpi*table->Sample(std::log(Energy/gapEnergy-2.)));
+    return xmin + (xmax-xmin)*sinS*sinS;
+  }
+
   G4double ymax = QPEnergyPDF(Energy, xmin);
 
   G4double xtest=0., ytest=ymax;
@@ -555,17 +771,24 @@ G4double G4CMPKaplanQP::ThermalPDF(G4double E) const {
 //        phonon's own energy is Ephonon = Energy - E', below
 
 G4double G4CMPKaplanQP::PhononEnergyRand(G4double Energy) const {
-  // PDF is not integrable, so we can't do an inverse transform sampling.
-  // Instead, we'll do a rejection method.
+  // PDF is not integrable, so we can't do an analytic inverse transform.
+  // It is tabulated numerically (see GetPhononEnergyTable()); outside of
+  // the table, we'll do a rejection method.
   //
   // PDF(E') = ((Energy-E')*(Energy-E') * (E'-gapEnergy*gapEnergy/Energy))
   //           /
   //           sqrt((E'*E' - gapEnergy*gapEnergy);
 
   // Add buffer so first bin doesn't give zero denominator in pdfSum
-  const G4double BUFF = 1000.;
   G4double xmin = gapEnergy + gapEnergy/BUFF;
   G4double xmax = Energy;
+
+  const G4CMPInverseCDFTable* table = GetPhononEnergyTable(Energy);
+  if (table) {
+    G4double s = table->Sample(std::log(Energy/gapEnergy-1.));
+    return Energy - (xmin + (xmax-xmin)*s*s);
+  }
+
   G4double ymax = PhononEnergyPDF(Energy, xmin);
 
   G4double xtest=0., ytest=ymax;
@@ -581,3 +804,72 @@ G4double G4CMPKaplanQP::PhononEnergyPDF(G4double E, G4double x) const {
   const G4double gapsq = gapEnergy*gapEnergy;
   return ( (E-x)*(E-x) * (x-gapsq/E) / sqrt(x*x - gapsq) );
 }
+
+
+// Tabulate QP energy distribution vs. log(E/gap-2), for current kT/gap;
+// shape converges as E approaches 2*gap, so lowest row is used below it.
+// Sampling variable maps to QP energy as xmin + (xmax-xmin)*sin^2(pi*s/2),
+// which spreads the steep rise at each end of the U over many bins.
+
+const G4CMPInverseCDFTable*
+G4CMPKaplanQP::GetQPEnergyTable(G4double Energy) const {
+  if (gapEnergy <= 0.) return 0;
+
+  G4double eps = Energy/gapEnergy;
+  if (eps <= 2. || eps > tableMaxE) return 0;
+
+  G4double kTgap = (temperature > 0.) ? k_Boltzmann*temperature/gapEnergy : 0.;
+
+  G4CMPInverseCDFTable& table = qpEnergyTables[kTgap];
+  if (!table.IsReady()) {
+    if (verboseLevel) {
+      G4cout << "G4CMPKaplanQP building QP energy table for kT/gap "
+	     << kTgap << G4endl;
+    }
+
+    const G4double gap = gapEnergy;
+    auto pdf = [this, gap](G4double v, G4double s) {
+      G4double E = gap*(2.+std::exp(v));
+      G4double xmin = gap + (E-2.*gap)/BUFF;
+      G4double xmax = gap + (E-2.*gap)*(BUFF-1.)/BUFF;
+      G4double sinS = std::sin(halfpi*s);
+      return QPEnergyPDF(E, xmin+(xmax-xmin)*sinS*sinS) * std::sin(pi*s);
+    };
+
+    table.Build(std::log(1./BUFF), std::log(tableMaxE-2.), tableRows, pdf);
+  }
+
+  return &table;
+}
+
+// Tabulate phonon energy distribution vs. log(E/gap-1); shape is independent
+// of both gap and temperature, so only one table is needed.
+// Sampling variable maps to QP energy as xmin + (E-xmin)*s^2, to spread
+// the steep rise near the gap over many bins.
+// Range collapses at E/gap = 1+1/BUFF, so table starts at 1+2/BUFF; below
+// that, no table is returned and PhononEnergyRand() uses rejection.
+
+const G4CMPInverseCDFTable*
+G4CMPKaplanQP::GetPhononEnergyTable(G4double Energy) const {
+  if (gapEnergy <= 0.) return 0;
+
+  G4double eps = Energy/gapEnergy;
+  if (eps < 1.+2./BUFF || eps > tableMaxE) return 0;
+
+  if (!phononEnergyTable.IsReady()) {
+    if (verboseLevel) G4cout << "G4CMPKaplanQP building phonon energy table"
+			     << G4endl;
+
+    const G4double gap = gapEnergy;
+    auto pdf = [this, gap](G4double v, G4double s) {
+      G4double E = gap*(1.+std::exp(v));
+      G4double xmin = gap + gap/BUFF;
+      return PhononEnergyPDF(E, xmin+(E-xmin)*s*s) * s;
+    };
+
+    phononEnergyTable.Build(std::log(2./BUFF), std::log(tableMaxE-1.),
+			    tableRows, pdf);
+  }
+
+  return &phononEnergyTable;
+}
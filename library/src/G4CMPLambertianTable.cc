@@ -0,0 +1,196 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file library/src/G4CMPLambertianTable.cc
+/// \brief Implementation of the G4CMPLambertianTable class.  Tabulates
+///	   admissible diffuse reflection directions for direct sampling.
+//
+// $Id$
+//
+// 20261017  New class, for use with G4CMPPhononBoundaryProcess
+// 20261017  Refine cells next to inward cells with 4x4 trial directions
+
+#include "G4CMPLambertianTable.hh"
+#include "G4LatticePhysical.hh"
+#include "G4PhysicalConstants.hh"
+#include "Randomize.hh"
+#include <algorithm>
+#include <cmath>
+
+
+// Constructors
+
+G4CMPLambertianTable::G4CMPLambertianTable()
+  : nS(0), nPhi(0), acceptance(0.) {;}
+
+G4CMPLambertianTable::
+G4CMPLambertianTable(const G4LatticePhysical* lattice, G4int mode,
+		     const G4ThreeVector& surfNorm, size_t ns, size_t nphi)
+  : G4CMPLambertianTable() {
+  Build(lattice, mode, surfNorm, ns, nphi);
+}
+
+void G4CMPLambertianTable::Clear() {
+  normal = axis1 = axis2 = G4ThreeVector();
+  nS = nPhi = 0;
+  acceptance = 0.;
+  cellCDF.clear();
+}
+
+
+// Evaluate trial directions with one batch lookup per pass
+
+void G4CMPLambertianTable::Build(const G4LatticePhysical* lattice, G4int mode,
+				 const G4ThreeVector& surfNorm,
+				 size_t ns, size_t nphi) {
+  Clear();
+  if (!lattice || ns < 1 || nphi < 1 || surfNorm.mag2() <= 0.) {
+    G4Exception("G4CMPLambertianTable::Build", "Lambert001", JustWarning,
+		"Invalid table configuration; table will not be used.");
+    return;
+  }
+
+  normal = surfNorm.unit();
+  axis1 = normal.orthogonal().unit();
+  axis2 = normal.cross(axis1);
+  nS = ns;
+  nPhi = nphi;
+
+  const size_t nCell = nS*nPhi;
+
+  // Neighbouring cells, wrapping around in phi
+  auto neighbors = [this](size_t ic, std::vector<size_t>& cells) {
+    cells.clear();
+    size_t i = ic/nPhi, j = ic%nPhi;
+    for (G4int di=-1; di<=1; di++) {
+      if ((di<0 && i==0) || (di>0 && i==nS-1)) continue;
+      for (G4int dj=-1; dj<=1; dj++) {
+	size_t nb = (i+di)*nPhi + (j+nPhi+dj)%nPhi;
+	if (nb != ic) cells.push_back(nb);
+      }
+    }
+  };
+
+  // Coarse pass over all cells gives acceptance and starting points
+  std::vector<size_t> pass(nCell);
+  for (size_t ic=0; ic<nCell; ic++) pass[ic] = ic;
+
+  std::vector<G4bool> inward(nCell, false);
+  G4int nIn = TestCells(lattice, mode, pass, 2, inward);
+  acceptance = G4double(nIn) / (4*nCell);
+
+  // Refine cells next to inward ones, working outward from each new one
+  std::vector<G4bool> refined(nCell, false);
+  std::vector<size_t> frontier, nearby;
+  for (size_t ic=0; ic<nCell; ic++) if (inward[ic]) frontier.push_back(ic);
+
+  while (!frontier.empty()) {
+    pass.clear();
+    for (size_t ic: frontier) {
+      neighbors(ic, nearby);
+      for (size_t nb: nearby) {
+	if (inward[nb] || refined[nb]) continue;
+	refined[nb] = true;
+	pass.push_back(nb);
+      }
+    }
+
+    TestCells(lattice, mode, pass, 4, inward);
+
+    frontier.clear();
+    for (size_t ic: pass) if (inward[ic]) frontier.push_back(ic);
+  }
+
+  // Cells next to an inward cell may hold part of the admissible region
+  cellCDF.resize(nCell);
+  G4double total = 0.;
+  for (size_t ic=0; ic<nCell; ic++) {
+    G4bool use = inward[ic];
+    if (!use) {
+      neighbors(ic, nearby);
+      for (size_t nb: nearby) use |= inward[nb];
+    }
+    if (use) total += 1.;
+    cellCDF[ic] = total;
+  }
+
+  if (total == 0.) {			// No admissible directions found
+    cellCDF.clear();
+    return;
+  }
+
+  for (size_t ic=0; ic<nCell; ic++) cellCDF[ic] /= total;
+  cellCDF.back() = 1.;			// Avoid roundoff at the end
+}
+
+G4int G4CMPLambertianTable::TestCells(const G4LatticePhysical* lattice,
+				      G4int mode,
+				      const std::vector<size_t>& cells,
+				      size_t nTrial,
+				      std::vector<G4bool>& inward) const {
+  if (cells.empty()) return 0;
+
+  const size_t nPer = nTrial*nTrial;
+  const G4double ds = 1./nS, dphi = twopi/nPhi, step = 1./nTrial;
+
+  std::vector<G4ThreeVector> trialK, trialVg;
+  trialK.reserve(nPer*cells.size());
+  for (size_t ic: cells) {
+    size_t i = ic/nPhi, j = ic%nPhi;
+    for (size_t t=0; t<nPer; t++) {	// Centers of nTrial x nTrial parts
+      trialK.push_back(Direction((i+(t/nTrial+0.5)*step)*ds,
+				 (j+(t%nTrial+0.5)*step)*dphi));
+    }
+  }
+
+  std::vector<G4int> trialMode(trialK.size(), mode);
+  lattice->MapKtoVg(trialMode, trialK, trialVg);
+
+  G4int nIn = 0;
+  for (size_t k=0; k<cells.size(); k++) {
+    for (size_t t=0; t<nPer; t++) {
+      if (trialVg[nPer*k+t].dot(normal) < 0.) {
+	inward[cells[k]] = true;
+	nIn++;
+      }
+    }
+  }
+
+  return nIn;
+}
+
+
+// Choose cell from cumulative weights, then uniform point within cell
+
+G4ThreeVector G4CMPLambertianTable::Sample() const {
+  if (!IsReady()) return G4ThreeVector();
+
+  size_t ic = std::upper_bound(cellCDF.begin(), cellCDF.end(),
+			       G4UniformRand()) - cellCDF.begin();
+  ic = std::min(ic, cellCDF.size()-1);
+
+  return Direction((ic/nPhi + G4UniformRand()) / nS,
+		   (ic%nPhi + G4UniformRand()) * twopi/nPhi);
+}
+
+G4ThreeVector G4CMPLambertianTable::Sample(const G4ThreeVector& surfNorm) const {
+  G4ThreeVector kdir = Sample();
+
+  // Table may have been built for nearby normal; rotate to match
+  G4ThreeVector axis = normal.cross(surfNorm);
+  if (axis.mag2() > 0.) kdir.rotate(axis, normal.angle(surfNorm));
+
+  return kdir;
+}
+
+
+// Lambertian (cosine-weighted) distribution is uniform in s = sin^2(theta)
+
+G4ThreeVector G4CMPLambertianTable::Direction(G4double s, G4double phi) const {
+  G4double sinth = std::sqrt(std::min(std::max(s, 0.), 1.));
+  G4double costh = std::sqrt(1.-sinth*sinth);
+
+  return -costh*normal + sinth*(std::cos(phi)*axis1 + std::sin(phi)*axis2);
+}
@@ -11,6 +11,7 @@
 // 20170815  Drop call to LoadDataForTrack(); now handled in process.
 // 20170913  Check for electric field; compute "rate" to get up to Vsound
 // 20170917  Add interface for threshold identification
+// 20261017  Split Rate() into wavevector lookup and rate computation.
 
 #include "G4CMPLukeEmissionRate.hh"
 #include "G4CMPGeometryUtils.hh"
@@ -26,32 +27,67 @@
 // Scattering rate is computed from electric field
 
 G4double G4CMPLukeEmissionRate::Rate(const G4Track& aTrack) const {
+  G4double kmag = RateVariable(aTrack);
+  return (kmag >= 0. ? RateFromVariable(kmag, RateChannel(aTrack)) : 0.);
+}
+
+G4int G4CMPLukeEmissionRate::RateChannel(const G4Track& aTrack) const {
+  return (G4CMP::IsHole(aTrack) ? 1 : 0);
+}
+
+// Get magnitude of wavevector (HV frame for electrons), or -1 if invalid
+
+G4double G4CMPLukeEmissionRate::RateVariable(const G4Track& aTrack) const {
   // Sanity check -- IsApplicable() should protect against this
   if (!G4CMP::IsChargeCarrier(aTrack)) {
     G4Exception("G4CMPLukeEmissionRate::Rate", "Luke001", EventMustBeAborted, 
 		("Invalid particle "+aTrack.GetDefinition()->GetParticleName()).c_str());
-    return 0.;
+    return -1.;
   }
 
-  G4double kmag = 0.; G4double l0 = 0.; G4double mass = 0.;
+  G4double kmag = 0.;
   if (G4CMP::IsElectron(aTrack)) {
     kmag = theLattice->MapV_elToK_HV(GetValleyIndex(aTrack),
 				     GetLocalVelocityVector(aTrack)).mag();
-    l0 = theLattice->GetElectronScatter();
-    mass = theLattice->GetElectronMass();	// Scalar mass
   } else if (G4CMP::IsHole(aTrack)) {
     kmag = GetLocalWaveVector(aTrack).mag();
-    l0 = theLattice->GetHoleScatter();
-    mass = theLattice->GetHoleMass();
   }
 
   if (verboseLevel > 1) 
     G4cout << "LukeEmissionRate kmag = " << kmag*m << " /m" << G4endl;
 
-  G4double kSound = theLattice->GetSoundSpeed() * mass / hbar_Planck;
+  return kmag;
+}
+
+G4double G4CMPLukeEmissionRate::RateFromVariable(G4double kmag,
+						 G4int chan) const {
+  G4double kSound = SoundWavevector(chan);
 
   // Time step corresponding to Mach number (avg. time between radiations)
-  return (kmag > kSound) ? 1./ChargeCarrierTimeStep(kmag/kSound, l0) : 0.;
+  return ((kmag > kSound) ? 1./ChargeCarrierTimeStep(kmag/kSound,
+						     ScatterLength(chan))
+	  : 0.);
+}
+
+// Tables should extend well past onset of emission
+
+G4double G4CMPLukeEmissionRate::RateVariableScale(G4int chan) const {
+  return 10.*SoundWavevector(chan);
+}
+
+
+// Carrier parameters used in rate calculation
+
+G4double G4CMPLukeEmissionRate::ScatterLength(G4int chan) const {
+  return (chan == 1 ? theLattice->GetHoleScatter()
+	  : theLattice->GetElectronScatter());
+}
+
+G4double G4CMPLukeEmissionRate::SoundWavevector(G4int chan) const {
+  G4double mass = (chan == 1 ? theLattice->GetHoleMass()
+		   : theLattice->GetElectronMass());	// Scalar mass
+
+  return theLattice->GetSoundSpeed() * mass / hbar_Planck;
 }
 
 
@@ -22,14 +22,32 @@
 // 20190919  BUG FIX:  2D project functions need 'break' in switch statements.
 // 20200519  Move local "static" buffers to class for thread safety.
 // 20210323  For 2D radial fields, need to manually protect rho < 0.
+// 20261017  Load 3D mesh tables from binary cache file, if enabled.
+// 20261017  Reuse (share) mesh tables already built from same input file.
+// 20261017  Add GetFieldValues(), GetPotentials() batch evaluation.
+// 20261017  Resample 3D mesh onto regular grid if $G4CMP_MESH_GRID is set.
+// 20261017  Use G4CMP::HashBytes() for cache key.
+// 20261017  Pass "quiet" through from batch functions; potentials warn by
+//		default, as GetPotential() does.
+// 20261017  Cache key hashes input file contents; cache files may be kept
+//		in a directory given by /g4cmp/useMeshCache.
 
 #include "G4CMPMeshElectricField.hh"
 #include "G4CMPBiLinearInterp.hh"
 #include "G4CMPConfigManager.hh"
+#include "G4CMPRegularGridInterp.hh"
 #include "G4CMPTriLinearInterp.hh"
+#include "G4CMPUtils.hh"
+#include "G4AutoLock.hh"
 #include "G4PhysicalConstants.hh"
 #include "G4SystemOfUnits.hh"
 #include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <sys/stat.h>
+#include <tuple>
 
 using std::array;
 using std::vector;
@@ -128,6 +146,22 @@ BuildInterp(const std::vector<std::array<G4double,2> >& xy,
 }
 
 
+// Meshes built from files are kept for reuse by other threads or fields;
+// clones share the mesh tables, so only one copy is held in memory
+
+namespace {
+  G4Mutex meshFileMutex = G4MUTEX_INITIALIZER;
+
+  // Keyed on file name, voltage scale and resampling grid step
+  std::map<std::tuple<G4String,G4double,G4double>,
+	   std::pair<uint64_t, std::unique_ptr<G4CMPVMeshInterpolator> > >
+  meshFileRegistry;
+
+  uint64_t CacheKey(const G4String& EPotFileName, G4double VScale);
+  G4String CacheName(const G4String& EPotFileName, uint64_t key,
+		     const char* suffix);
+}
+
 // Construct mesh from 3D input file
 
 void G4CMPMeshElectricField::BuildInterp(const G4String& EPotFileName,
@@ -140,6 +174,54 @@ void G4CMPMeshElectricField::BuildInterp(const G4String& EPotFileName,
     G4cout << G4endl;
   }
 
+  // Only one thread reads a given file; the others will copy its result
+  G4AutoLock lock(&meshFileMutex);
+
+  G4double gridStep = G4CMPConfigManager::GetMeshGridStep();
+
+  uint64_t key = CacheKey(EPotFileName, VScale);
+  auto& known =
+    meshFileRegistry[std::make_tuple(EPotFileName, VScale, gridStep)];
+  if (known.second && known.first == key) {
+    if (Interp) delete Interp;
+    Interp = known.second->Clone();		// Shares existing mesh tables
+    return;
+  }
+
+  if (!LoadCache(EPotFileName, VScale)) ReadEPotFile(EPotFileName, VScale);
+  if (Interp && gridStep > 0.) BuildGrid(EPotFileName, VScale, gridStep);
+
+  if (Interp && key != 0) {		// Zero key if file can't be checked
+    known.first = key;
+    known.second.reset(Interp->Clone());
+  }
+}
+
+// Replace tetrahedral mesh with regular grid resampled from it
+
+void G4CMPMeshElectricField::BuildGrid(const G4String& EPotFileName,
+				       G4double VScale, G4double step) {
+  G4CMPRegularGridInterp* grid =
+    new G4CMPRegularGridInterp(*static_cast<G4CMPTriLinearInterp*>(Interp),
+			       step, false);
+
+  // Grid cache is tied to same input file as mesh tables
+  uint64_t key = CacheKey(EPotFileName, VScale);
+  G4bool useCache = G4CMPConfigManager::UseMeshCache() && key != 0;
+  G4String gridName = CacheName(EPotFileName, key, ".grid.cache");
+
+  if (!useCache || !grid->LoadCache(gridName, key)) {
+    grid->Resample();
+    if (useCache) grid->SaveCache(gridName, key);
+  }
+
+  delete Interp;
+  Interp = grid;
+}
+
+void G4CMPMeshElectricField::ReadEPotFile(const G4String& EPotFileName,
+					  G4double VScale) {
+
   vector<array<G4double,4> > tempX;
   array<G4double,4> temp = {{ 0, 0, 0, 0 }};
   G4double x,y,z,v;
@@ -186,6 +268,90 @@ void G4CMPMeshElectricField::BuildInterp(const G4String& EPotFileName,
  
   if (Interp) delete Interp;
   Interp = new G4CMPTriLinearInterp(X, V);
+
+  SaveCache(EPotFileName, VScale);
+}
+
+
+// Binary mesh tables are stored alongside input file, or in directory
+// given by /g4cmp/useMeshCache, keyed to the contents of the input file
+
+namespace {
+  G4String CacheName(const G4String& EPotFileName, uint64_t key,
+		     const char* suffix) {
+    const G4String& dir = G4CMPConfigManager::GetMeshCacheDir();
+    if (dir.empty()) return EPotFileName + suffix;
+
+    // Key distinguishes inputs with the same name from different places
+    size_t slash = EPotFileName.rfind('/');
+    size_t start = (slash == std::string::npos) ? 0 : slash+1;
+
+    std::ostringstream fname;
+    fname << dir << "/" << EPotFileName.substr(start) << "_"
+	  << std::hex << std::setw(16) << std::setfill('0') << key << suffix;
+    return fname.str();
+  }
+
+  // Hash of file contents, remembered while size and timestamp match
+  // NOTE: Only called with meshFileMutex held (from BuildInterp())
+  uint64_t ContentHash(const G4String& EPotFileName) {
+    struct stat info;
+    if (stat(EPotFileName.c_str(), &info) != 0) return 0;
+
+    static std::map<G4String, std::tuple<off_t,time_t,uint64_t> > known;
+    auto& entry = known[EPotFileName];
+    if (std::get<2>(entry) != 0 && std::get<0>(entry) == info.st_size &&
+	std::get<1>(entry) == info.st_mtime) return std::get<2>(entry);
+
+    std::ifstream input(EPotFileName, std::ios::binary);
+    if (!input.good()) return 0;
+
+    uint64_t hash = G4CMP::HashBytes(nullptr, 0);
+    std::vector<char> buffer(1<<20);
+    while (input.read(buffer.data(), buffer.size()) || input.gcount() > 0) {
+      hash = G4CMP::HashBytes(buffer.data(), input.gcount(), hash);
+    }
+
+    entry = std::make_tuple(info.st_size, info.st_mtime, hash);
+    return hash;
+  }
+
+  // Returns zero if input file is missing
+  uint64_t CacheKey(const G4String& EPotFileName, G4double VScale) {
+    uint64_t content = ContentHash(EPotFileName);
+    if (content == 0) return 0;
+
+    return G4CMP::HashBytes(&VScale, sizeof(VScale), content);
+  }
+}
+
+G4bool G4CMPMeshElectricField::LoadCache(const G4String& EPotFileName,
+					 G4double VScale) {
+  if (!G4CMPConfigManager::UseMeshCache()) return false;
+
+  uint64_t key = CacheKey(EPotFileName, VScale);
+  if (key == 0) return false;
+
+  G4CMPTriLinearInterp* tli = new G4CMPTriLinearInterp;
+  if (!tli->LoadCache(CacheName(EPotFileName, key, ".cache"), key)) {
+    delete tli;
+    return false;
+  }
+
+  if (Interp) delete Interp;
+  Interp = tli;
+  return true;
+}
+
+void G4CMPMeshElectricField::SaveCache(const G4String& EPotFileName,
+				       G4double VScale) const {
+  if (!G4CMPConfigManager::UseMeshCache()) return;
+
+  uint64_t key = CacheKey(EPotFileName, VScale);
+  if (key == 0) return;
+
+  static_cast<const G4CMPTriLinearInterp*>(Interp)->
+    SaveCache(CacheName(EPotFileName, key, ".cache"), key);
 }
 
 
@@ -220,6 +386,66 @@ G4double G4CMPMeshElectricField::GetPotential(const G4double Point[3]) const {
 }
 
 
+// Evaluate many points in one pass through the interpolator
+
+void G4CMPMeshElectricField::
+GetFieldValues(const vector<G4ThreeVector>& points,
+	       vector<G4ThreeVector>& efield, G4bool quiet) const {
+  FillMeshPoints(points);
+  Interp->GetGrads(meshPts_, efield, quiet);
+  Grad2Field(points, efield);
+}
+
+void G4CMPMeshElectricField::
+GetPotentials(const vector<G4ThreeVector>& points,
+	      vector<G4double>& potential, G4bool quiet) const {
+  FillMeshPoints(points);
+  Interp->GetValues(meshPts_, potential, quiet);
+}
+
+void G4CMPMeshElectricField::
+GetFieldValues(const vector<G4ThreeVector>& points,
+	       vector<G4ThreeVector>& efield,
+	       vector<G4double>& potential, G4bool quiet) const {
+  FillMeshPoints(points);
+  Interp->GetValuesAndGrads(meshPts_, potential, efield, quiet);
+  Grad2Field(points, efield);
+}
+
+void G4CMPMeshElectricField::
+Grad2Field(const vector<G4ThreeVector>& points,
+	   vector<G4ThreeVector>& efield) const {
+  G4double Point[3];
+  for (size_t i=0; i<points.size(); i++) {
+    if (xCoord != kUndefined) {		// Two dimensions
+      Point[0] = points[i].x(); Point[1] = points[i].y();
+      Point[2] = points[i].z();
+      Expand2Dat(Point, efield[i]);
+    }
+
+    efield[i] *= -1.;
+  }
+}
+
+void G4CMPMeshElectricField::
+FillMeshPoints(const vector<G4ThreeVector>& points) const {
+  meshPts_.resize(points.size());
+
+  G4double Point[3];
+  for (size_t i=0; i<points.size(); i++) {
+    Point[0] = points[i].x(); Point[1] = points[i].y();
+    Point[2] = points[i].z();
+
+    if (xCoord == kUndefined) {		// Three dimensions
+      meshPts_[i] = {{ Point[0], Point[1], Point[2] }};
+    } else {				// Two dimensions
+      meshPts_[i][2] = 0.;
+      Project2D(Point, meshPts_[i].data());
+    }
+  }
+}
+
+
 // Convert between 3D and 2D coordinates for projected meshes
 
 namespace {
@@ -28,11 +28,17 @@
 // 20220712  M. Kelsey -- Pass process pointer to G4CMPAnharmonicDecay
 // 20220905  G4CMP-310 -- Add increments of kPerp to avoid bad reflections.
 // 20220910  G4CMP-299 -- Use fabs(k) in absorption test.
+// 20261017  Use single MapKtoVg() lookup for reflected phonon velocity
+// 20261017  Draw diffuse reflections from G4CMPLambertianTable, built on
+//		first use for each lattice, mode and surface normal; reuse
+//		group velocity lookups in specular correction and final test.
+// 20261017  Document table draws as approximate, with retry fallback
 
 #include "G4CMPPhononBoundaryProcess.hh"
 #include "G4CMPAnharmonicDecay.hh"
 #include "G4CMPConfigManager.hh"
 #include "G4CMPGeometryUtils.hh"
+#include "G4CMPLambertianTable.hh"
 #include "G4CMPPhononTrackInfo.hh"
 #include "G4CMPSurfaceProperty.hh"
 #include "G4CMPTrackUtils.hh"
@@ -50,6 +56,14 @@
 #include "G4VParticleChange.hh"
 #include "G4VSolid.hh"
 #include "Randomize.hh"
+#include <cmath>
+
+
+// Tables are built for normals rounded to this fraction of a unit vector
+namespace {
+  const G4double normalGrid = 64.;
+  const size_t maxLambertTables = 512;	// Limit memory for curved surfaces
+}
 
 
 // Constructor and destructor
@@ -207,8 +221,9 @@ DoReflection(const G4Track& aTrack, const G4Step& aStep,
     refltype = "diffuse";
   }
 
-  G4ThreeVector vdir = theLattice->MapKtoVDir(mode, reflectedKDir);
-  G4double v = theLattice->MapKtoV(mode, reflectedKDir);
+  G4ThreeVector vgroup = theLattice->MapKtoVg(mode, reflectedKDir);
+  G4ThreeVector vdir = vgroup.unit();
+  G4double v = vgroup.mag();
 
   if (verboseLevel>2) {
     G4cout << "\n New wavevector direction " << reflectedKDir
@@ -216,7 +231,7 @@ DoReflection(const G4Track& aTrack, const G4Step& aStep,
   }
 
   // If reflection failed, report problem and kill the track
-  if (!G4CMP::PhononVelocityIsInward(theLattice,mode,reflectedKDir,surfNorm)) {
+  if (vdir.dot(surfNorm) >= 0.) {
     G4Exception((GetProcessName()+"::DoReflection").c_str(), "Boundary010",
 		JustWarning, ("Phonon "+refltype+" reflection failed").c_str());
     DoSimpleKill(aTrack, aStep, aParticleChange);
@@ -263,21 +278,18 @@ GetReflectedVector(const G4ThreeVector& waveVector,
 	   << " (mag " << kPerp << ")" << G4endl;
   }
   
-  if (G4CMP::PhononVelocityIsInward(theLattice,mode,reflectedKDir,surfNorm))
-    return reflectedKDir;
-
-  // Reflection didn't work as expected, need to correct   
-
   // Watch how momentum direction changes with each kPerp step
   G4ThreeVector olddir, newdir;
   
-  olddir = theLattice->MapKtoVDir(mode, reflectedKDir);
+  newdir = theLattice->MapKtoVDir(mode, reflectedKDir);
+  if (newdir.dot(surfNorm) < 0.) return reflectedKDir;
+
+  // Reflection didn't work as expected, need to correct   
   G4double kstep = 0.1*kPerp;
   G4int nstep = 0, nflip = 0;
-  while (fabs(kstep) > 1e-6 && fabs(nstep*kstep)<1. && 
-	 !G4CMP::PhononVelocityIsInward(theLattice,mode,reflectedKDir,surfNorm)) {
-    newdir = theLattice->MapKtoVDir(mode, reflectedKDir);
-    if (newdir*surfNorm > olddir*surfNorm && nflip<5) {
+  while (fabs(kstep) > 1e-6 && fabs(nstep*kstep)<1. &&
+	 newdir.dot(surfNorm) >= 0.) {
+    if (nstep>0 && newdir*surfNorm > olddir*surfNorm && nflip<5) {
       if (verboseLevel>2) {
 	G4cout << " Reflected wv pushing momentum outward:"
 	       << " newdir*surfNorm = " << newdir*surfNorm
@@ -290,6 +302,7 @@ GetReflectedVector(const G4ThreeVector& waveVector,
     
     (reflectedKDir -= kstep*surfNorm).setMag(1.);
     olddir = newdir;
+    newdir = theLattice->MapKtoVDir(mode, reflectedKDir);
     nstep++;
   } 
   
@@ -307,6 +320,21 @@ GetReflectedVector(const G4ThreeVector& waveVector,
 G4ThreeVector G4CMPPhononBoundaryProcess::
 GetLambertianVector(const G4ThreeVector& surfNorm, G4int mode) const {
   G4ThreeVector reflectedKDir;
+
+  // Cells on edge of admissible region give some outward directions;
+  // table only covers admissible region near its trial directions
+  const G4CMPLambertianTable* table = GetLambertianTable(surfNorm, mode);
+  if (table) {
+    const G4int maxDraws = 10;
+    for (G4int i=0; i<maxDraws; i++) {
+      reflectedKDir = table->Sample(surfNorm);
+      if (G4CMP::PhononVelocityIsInward(theLattice, mode,
+					reflectedKDir, surfNorm))
+	return reflectedKDir;
+    }
+  }
+
+  // Fall back to plain Lambertian draws over the full hemisphere
   const G4int maxTries = 1000;
   G4int nTries = 0;
   do {
@@ -317,3 +345,39 @@ GetLambertianVector(const G4ThreeVector& surfNorm, G4int mode) const {
 
   return reflectedKDir;
 }
+
+
+// Find or build diffuse reflection table for current lattice
+
+const G4CMPLambertianTable* G4CMPPhononBoundaryProcess::
+GetLambertianTable(const G4ThreeVector& surfNorm, G4int mode) const {
+  if (!theLattice) return 0;
+
+  LambertKey key(theLattice, mode,
+		 G4int(std::lround(surfNorm.x()*normalGrid)),
+		 G4int(std::lround(surfNorm.y()*normalGrid)),
+		 G4int(std::lround(surfNorm.z()*normalGrid)));
+
+  auto found = lambertTables.find(key);
+  if (found != lambertTables.end())
+    return (found->second.IsReady() ? &found->second : 0);
+
+  if (lambertTables.size() >= maxLambertTables) return 0;
+
+  G4ThreeVector gridNorm(std::get<2>(key), std::get<3>(key), std::get<4>(key));
+  if (gridNorm.mag2() <= 0.) gridNorm = surfNorm;
+
+  if (verboseLevel>1) {
+    G4cout << GetProcessName() << " building Lambertian table for mode "
+	   << mode << " normal " << gridNorm.unit() << G4endl;
+  }
+
+  G4CMPLambertianTable& table = lambertTables[key];
+  table.Build(theLattice, mode, gridNorm);
+
+  if (verboseLevel>2) {
+    G4cout << " inward fraction " << table.GetAcceptance() << G4endl;
+  }
+
+  return (table.IsReady() ? &table : 0);
+}
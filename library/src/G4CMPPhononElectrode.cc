@@ -35,6 +35,7 @@
 // 
 // 20221006  M. Kelsey -- Adapted from SuperCDMS simulation version
 // 20221006  G4CMP-330 -- Add lattice temperature to properties table
+// 20261017  Build KaplanQP fast mode table when surface table is assigned
 
 #include "G4CMPPhononElectrode.hh"
 #include "G4CMPGeometryUtils.hh"
@@ -63,6 +64,15 @@ G4CMPPhononElectrode::~G4CMPPhononElectrode() {
   delete kaplanQP; kaplanQP=0;
 }
 
+// Surface table is assigned during detector construction; tabulating the
+// film response here keeps the cascades out of the event loop
+
+void G4CMPPhononElectrode::
+UseSurfaceTable(G4MaterialPropertiesTable* surfProp) {
+  G4CMPVElectrodePattern::UseSurfaceTable(surfProp);
+  G4CMPKaplanQP::PrepareFilmResponse(theSurfaceTable, verboseLevel);
+}
+
 // Assumes that user has configured a border surface only at sensor pads
 
 G4bool G4CMPPhononElectrode::IsNearElectrode(const G4Step& /*step*/) const {
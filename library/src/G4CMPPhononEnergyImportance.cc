@@ -0,0 +1,20 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file library/src/G4CMPPhononEnergyImportance.cc
+/// \brief Implementation of the G4CMPPhononEnergyImportance class
+//
+// $Id$
+//
+// 20261017  New class, for use with G4CMPPhononWeightWindow
+
+#include "G4CMPPhononEnergyImportance.hh"
+#include "G4Track.hh"
+
+
+G4double
+G4CMPPhononEnergyImportance::GetImportance(const G4Track& track) const {
+  return BandImportance(track.GetKineticEnergy());
+}
@@ -5,20 +5,31 @@
 //  20160628  Tabulating on nx and ny is just wrong; use theta, phi
 //  20170525  Drop unnecessary empty destructor ("rule of five" semantics)
 //  20170527  Abort job if output file fails
+//  20261017  Add interpGroupVelocities() for batch lookup of many phonons
+//  20261017  Load lookup data from binary cache if available
+//  20261017  Interpolate from interleaved records with direct bin indexing,
+//		instead of bisection in separate G4CMPGridInterp per quantity
+//  20261017  Reduce table to irreducible wedge of lattice symmetry group
+//  20261017  Release lookup data once records are built; write() and the
+//		binary cache use records
+//  20261017  Cache uses header and WriteCacheFile() from G4CMPUtils
 
 #include "G4CMPPhononKinTable.hh"
-#include "G4CMPMatrix.hh"
 #include "G4CMPPhononKinematics.hh"
+#include "G4CMPUtils.hh"
+#include "G4LatticeLogical.hh"
 #include "G4PhononPolarization.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4ThreeVector.hh"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <string>
 
 using namespace std;
-using G4CMP::matrix;
 
 // ++++++++++++++++++++++ G4CMPPhononKinTable METHODS +++++++++++++++++++++++++
 
@@ -29,28 +40,33 @@ const G4double G4CMPPhononKinTable::ERRONEOUS_INPUT = 1.0e99;
 G4CMPPhononKinTable::
 G4CMPPhononKinTable(G4CMPPhononKinematics* map,
 		    G4double thmin, G4double thmax, G4int nth,
-		    G4double phmin, G4double phmax, G4int nph)
+		    G4double phmin, G4double phmax, G4int nph, G4bool sym)
   : thetaMin(thmin), thetaMax(thmax),
     thetaStep((nth>0)?(thmax-thmin)/nth:1.), thetaCount(nth),
     phiMin(phmin), phiMax(phmax),
     phiStep((nph>0)?(phmax-phmin)/nph:1.), phiCount(nph),
-    mapper(map), lookupReady(false) {;}
+    mapper(map), lookupReady(false), useSymmetry(sym),
+    symmetry(NO_SYMMETRY) {;}
 
 void G4CMPPhononKinTable::initialize() {
   if (lookupReady) return;		// Tables already generated
 
-  generateLookupTable();
-  generateMultiEvenTable();
-  lookupReady = true;
-}
+  setUpSymmetry();			// Changes binning used in cache key
 
-void G4CMPPhononKinTable::clearQuantityMap() {
-  // common technique to free up the memory of a vector:
-  quantityMap.clear(); // this alone actually does not free up the memory
-  vector<vector<G4CMPGridInterp> > newVec;
-  quantityMap.swap(newVec);
+  // Eigensolver results may be reused from an earlier job
+  uint64_t key = cacheKey();
+  G4String cacheFile = mapper->getLattice()->GetKinCacheName(key, ".kintable");
+  if (cacheFile.empty() || !LoadCache(cacheFile, key)) {
+    generateLookupTable();
+    generateRecordTable();
 
-  lookupReady = false;
+    // Only the interleaved records are used after this point
+    vector<vector<vector<double> > >().swap(lookupData);
+
+    if (!cacheFile.empty()) SaveCache(cacheFile, key);
+  }
+
+  lookupReady = true;
 }
 
 // returns aphi quantity desired from the interpolation table
@@ -62,8 +78,24 @@ double G4CMPPhononKinTable::interpGeneral(int mode, const G4ThreeVector& k,
   double theta = k.theta(); theta+=(theta<0.)?pi:0.;
   double phi = k.phi();     phi+=(phi<0.)?twopi:0.;
 
-  // note: this method at present does not require nz
-  return interpolateEven(theta, phi, mode, typeDesired);
+  if (symmetry == NO_SYMMETRY)		// Note: does not require nz
+    return interpolateEven(theta, phi, mode, typeDesired);
+
+  if (typeDesired == THETA || typeDesired == PHI)	// Input, not wedge
+    return (typeDesired==THETA ? theta : phi);
+
+  // Scalar quantities are the same in the wedge; vectors must be mapped back
+  SymOp op;
+  mapToWedge(k.x(), k.y(), k.z(), theta, phi, op);
+  if (typeDesired == V_P || typeDesired == V_G || typeDesired == S_MAG ||
+      !goodBin(theta, phi))
+    return interpolateEven(theta, phi, mode, typeDesired);
+
+  double rec[NUM_DATA_TYPES];
+  interpolateRecord(theta, phi, mode, 0, NUM_DATA_TYPES, rec);
+  mapFromWedge(op, rec);
+
+  return rec[typeDesired];
 }
 
 // returns the unit vector pointing in the direction of Vg
@@ -75,6 +107,305 @@ G4CMPPhononKinTable::interpGroupVelocity_N(int mode, const G4ThreeVector& k) {
   return Vg.unit();
 }
 
+// returns the group velocity vector, with magnitude interpolated separately
+G4ThreeVector
+G4CMPPhononKinTable::interpGroupVelocityVector(int mode,
+					       const G4ThreeVector& k) {
+  if (!lookupReady) initialize();	// Fill tables on first query
+
+  double theta, phi;
+  SymOp op;
+  mapToWedge(k.x(), k.y(), k.z(), theta, phi, op);
+
+  // Out-of-range angles are passed to the single-value code to report
+  if (!goodBin(theta,phi))
+    return interpGroupVelocity(mode, k) * interpGroupVelocity_N(mode, k);
+
+  double vg[4];				// V_G, V_GX, V_GY, V_GZ are adjacent
+  interpolateRecord(theta, phi, mode, V_G, 4, vg);
+  mapFromWedge(op, vg[1], vg[2], vg[3]);
+
+  G4ThreeVector Vg(vg[1], vg[2], vg[3]);
+  double vmag = Vg.mag();
+  return (vmag > 0. ? Vg*(vg[0]/vmag) : Vg);
+}
+
+// fills all kinematic quantities from a single interpolation of the record
+void G4CMPPhononKinTable::
+interpKinematics(int mode, const G4ThreeVector& k, G4double& vphase,
+		 G4ThreeVector& slowness, G4ThreeVector& vgroup,
+		 G4ThreeVector& polarization) {
+  if (!lookupReady) initialize();	// Fill tables on first query
+
+  double theta, phi;
+  SymOp op;
+  mapToWedge(k.x(), k.y(), k.z(), theta, phi, op);
+
+  if (!goodBin(theta,phi)) {
+    cerr << "ERROR: Cannot interpolate (" << theta << ", " << phi << ")"
+	 << endl;
+    vphase = ERRONEOUS_INPUT;
+    slowness.set(ERRONEOUS_INPUT, ERRONEOUS_INPUT, ERRONEOUS_INPUT);
+    vgroup = polarization = slowness;
+    return;
+  }
+
+  double rec[NUM_DATA_TYPES];
+  interpolateRecord(theta, phi, mode, 0, NUM_DATA_TYPES, rec);
+  mapFromWedge(op, rec);
+
+  vphase = rec[V_P];
+  slowness.set(rec[S_X], rec[S_Y], rec[S_Z]);
+  vgroup.set(rec[V_GX], rec[V_GY], rec[V_GZ]);
+  if (vgroup.mag() > 0.) vgroup *= rec[V_G]/vgroup.mag();
+  polarization.set(rec[E_X], rec[E_Y], rec[E_Z]);
+}
+
+/* batch version of interpGroupVelocity()*interpGroupVelocity_N().  Since
+   the table is evenly spaced in (theta,phi), the cell is found by direct
+   indexing rather than by bisection, and one set of bilinear weights is
+   shared by the four adjacent velocity entries of each record.  Points
+   are processed in blocks, with the mapping into the table and the
+   interpolation in separate simple loops over plain arrays. */
+void G4CMPPhononKinTable::
+interpGroupVelocities(size_t n, const G4int* mode, const G4double* kx,
+		      const G4double* ky, const G4double* kz,
+		      G4double* vx, G4double* vy, G4double* vz) {
+  if (!lookupReady) initialize();	// Fill tables on first query
+
+  const int nPhi = phiCount+1;		// Row length of record table
+  const int nCell = (thetaCount+1)*nPhi;	// Records per mode
+  const double invTStep = 1./thetaStep;
+  const double invPStep = 1./phiStep;
+
+  const size_t BLOCK = 64;
+  int cell[BLOCK];
+  double t[BLOCK], u[BLOCK];
+  bool good[BLOCK];
+  SymOp op[BLOCK];
+
+  for (size_t i0=0; i0<n; i0+=BLOCK) {
+    const size_t nb = std::min(BLOCK, n-i0);
+
+    // Angles in table and bin offsets, same conventions as interpGeneral()
+    for (size_t j=0; j<nb; j++) {
+      const size_t i = i0+j;
+      double theta, phi;
+      mapToWedge(kx[i], ky[i], kz[i], theta, phi, op[j]);
+
+      good[j] = goodBin(theta, phi);
+
+      double ft = (theta-thetaMin)*invTStep;
+      double fp = (phi-phiMin)*invPStep;
+      int ith = std::max(0, std::min(int(ft), thetaCount-1));
+      int iph = std::max(0, std::min(int(fp), phiCount-1));
+      t[j] = ft - ith;
+      u[j] = fp - iph;
+      cell[j] = ith*nPhi + iph;
+    }
+
+    // Bilinear interpolation of magnitude and direction components
+    for (size_t j=0; j<nb; j++) {
+      const size_t i = i0+j;
+      const double* r00 =
+	&recordTable[(mode[i]*nCell + cell[j])*NUM_DATA_TYPES + V_G];
+      const double* r10 = r00 + nPhi*NUM_DATA_TYPES;
+      const double* r01 = r00 + NUM_DATA_TYPES;
+      const double* r11 = r10 + NUM_DATA_TYPES;
+      const double w00 = (1.-t[j])*(1.-u[j]), w10 = t[j]*(1.-u[j]);
+      const double w01 = (1.-t[j])*u[j],      w11 = t[j]*u[j];
+
+      double vg = w00*r00[0] + w10*r10[0] + w01*r01[0] + w11*r11[0];
+      double dx = w00*r00[1] + w10*r10[1] + w01*r01[1] + w11*r11[1];
+      double dy = w00*r00[2] + w10*r10[2] + w01*r01[2] + w11*r11[2];
+      double dz = w00*r00[3] + w10*r10[3] + w01*r01[3] + w11*r11[3];
+
+      double dmag = std::sqrt(dx*dx + dy*dy + dz*dz);
+      double scale = (dmag > 0.) ? vg/dmag : 0.;
+      vx[i] = scale*dx;
+      vy[i] = scale*dy;
+      vz[i] = scale*dz;
+      mapFromWedge(op[j], vx[i], vy[i], vz[i]);
+    }
+
+    // Out-of-range angles are passed to the single-point code to report
+    for (size_t j=0; j<nb; j++) {
+      if (good[j]) continue;
+
+      const size_t i = i0+j;
+      G4ThreeVector k(kx[i], ky[i], kz[i]);
+      G4ThreeVector vg = (interpGroupVelocity(mode[i], k) *
+			  interpGroupVelocity_N(mode[i], k));
+      vx[i] = vg.x();
+      vy[i] = vg.y();
+      vz[i] = vg.z();
+    }
+  }
+}
+
+// ***************************** SYMMETRY METHODS ******************************
+/* reduces a full-sphere table to the irreducible wedge of the symmetry
+   group.  The angular steps are kept, and the grid is extended to the
+   next full step past the wedge edges. */
+void G4CMPPhononKinTable::setUpSymmetry() {
+  if (!useSymmetry || symmetry != NO_SYMMETRY) return;	// Already done
+
+  if (thetaMin != 0. || thetaMax != pi || phiMin != 0. || phiMax != twopi)
+    return;				// Only full sphere can be reduced
+
+  symmetry = chooseSymmetry();
+
+  G4double thetaWedge = halfpi, phiWedge = halfpi;
+  switch (symmetry) {
+  case NO_SYMMETRY:    return;
+  case INVERSION:      phiWedge = twopi; break;
+  case ORTHORHOMBIC:
+  case TETRAGONAL_LOW: break;
+  case TETRAGONAL:     phiWedge = pi/4.; break;
+  case CUBIC:          thetaWedge = acos(1./sqrt(3.)); phiWedge = pi/4.;
+		       break;
+  }
+
+  thetaCount = std::max(1, int(std::ceil(thetaWedge/thetaStep - 1e-9)));
+  thetaMax = std::max(thetaWedge, thetaMin + thetaCount*thetaStep);
+  phiCount = std::max(1, int(std::ceil(phiWedge/phiStep - 1e-9)));
+  phiMax = std::max(phiWedge, phiMin + phiCount*phiStep);
+
+#ifdef G4CMP_DEBUG
+  cout << "G4CMPPhononKinTable: symmetry " << symmetry << " wedge "
+       << thetaCount << " X bins [0.." << thetaMax << "], "
+       << phiCount << " X bins [0.." << phiMax << "]" << G4endl;
+#endif
+}
+
+/* highest symmetry expected for lattice's Bravais group, which is
+   actually present in the elasticity tensor.  Inversion (k -> -k) is a
+   symmetry of every elastic medium. */
+G4CMPPhononKinTable::Symmetry G4CMPPhononKinTable::chooseSymmetry() const {
+  static const SymOp mirrorX = { {0,1,2}, {-1., 1., 1.} };
+  static const SymOp mirrorY = { {0,1,2}, { 1.,-1., 1.} };
+  static const SymOp mirrorZ = { {0,1,2}, { 1., 1.,-1.} };
+  static const SymOp swapXY  = { {1,0,2}, { 1., 1., 1.} };  // Diagonal mirror
+  static const SymOp rotateZ = { {1,0,2}, { 1.,-1., 1.} };  // 90 deg about Z
+  static const SymOp rotate3 = { {1,2,0}, { 1., 1., 1.} };  // 120 deg, (111)
+
+  const G4bool mmm = (isSymmetryOf(mirrorX) && isSymmetryOf(mirrorY) &&
+		      isSymmetryOf(mirrorZ));
+
+  switch (mapper->getLattice()->GetCrystal().group) {
+  case G4CMPCrystalGroup::amorphous:
+  case G4CMPCrystalGroup::cubic:
+    if (mmm && isSymmetryOf(swapXY) && isSymmetryOf(rotate3)) return CUBIC;
+    [[fallthrough]];
+  case G4CMPCrystalGroup::tetragonal:
+  case G4CMPCrystalGroup::hexagonal:
+    if (mmm && isSymmetryOf(swapXY)) return TETRAGONAL;
+    if (isSymmetryOf(mirrorZ) && isSymmetryOf(rotateZ)) return TETRAGONAL_LOW;
+    [[fallthrough]];
+  case G4CMPCrystalGroup::orthorhombic:
+    if (mmm) return ORTHORHOMBIC;
+    [[fallthrough]];
+  default: break;
+  }
+
+  return INVERSION;
+}
+
+/* transformed tensor is C'_ijkl = s_i s_j s_k s_l C_p(i)p(j)p(k)p(l) */
+G4bool G4CMPPhononKinTable::isSymmetryOf(const SymOp& op) const {
+  const G4LatticeLogical* lat = mapper->getLattice();
+
+  G4double cmax = 0.;
+  for (int i=0; i<3; i++) for (int j=0; j<3; j++)
+    for (int k=0; k<3; k++) for (int l=0; l<3; l++)
+      cmax = std::max(cmax, std::fabs(lat->GetCijkl(i,j,k,l)));
+
+  const G4double tolerance = 1e-6*cmax;
+  for (int i=0; i<3; i++) for (int j=0; j<3; j++)
+    for (int k=0; k<3; k++) for (int l=0; l<3; l++) {
+      G4double cnew = (op.sign[i]*op.sign[j]*op.sign[k]*op.sign[l] *
+		       lat->GetCijkl(op.perm[i], op.perm[j],
+				     op.perm[k], op.perm[l]));
+      if (std::fabs(cnew - lat->GetCijkl(i,j,k,l)) > tolerance) return false;
+    }
+
+  return true;
+}
+
+/* finds operation taking k into the tabulated wedge (see Symmetry), and
+   returns the angles of the transformed vector */
+void G4CMPPhononKinTable::mapToWedge(G4double kx, G4double ky, G4double kz,
+				     G4double& theta, G4double& phi,
+				     SymOp& op) const {
+  const G4double k[3] = { kx, ky, kz };
+  for (int i=0; i<3; i++) {
+    op.perm[i] = i;
+    op.sign[i] = 1.;
+  }
+
+  switch (symmetry) {
+  case NO_SYMMETRY: break;
+  case INVERSION:
+    if (kz < 0.) op.sign[0] = op.sign[1] = op.sign[2] = -1.;
+    break;
+  case TETRAGONAL_LOW:			// Rotate (x,y) into first quadrant
+    if (kz < 0.) op.sign[2] = -1.;
+    if (kx <= 0. && ky > 0.) {			// (x',y') = (y,-x)
+      op.perm[0] = 1; op.perm[1] = 0; op.sign[1] = -1.;
+    } else if (kx < 0. && ky <= 0.) {		// (x',y') = (-x,-y)
+      op.sign[0] = op.sign[1] = -1.;
+    } else if (kx >= 0. && ky < 0.) {		// (x',y') = (-y,x)
+      op.perm[0] = 1; op.perm[1] = 0; op.sign[0] = -1.;
+    }
+    break;
+  case ORTHORHOMBIC:
+  case TETRAGONAL:
+  case CUBIC: {				// Reflect into octant, then permute
+    const G4double a[3] = { std::fabs(kx), std::fabs(ky), std::fabs(kz) };
+    if (symmetry == TETRAGONAL && a[1] > a[0]) {
+      op.perm[0] = 1; op.perm[1] = 0;
+    } else if (symmetry == CUBIC) {		// Largest to z, smallest to y
+      int idx[3] = { 0, 1, 2 };
+      if (a[idx[0]] > a[idx[1]]) std::swap(idx[0], idx[1]);
+      if (a[idx[1]] > a[idx[2]]) std::swap(idx[1], idx[2]);
+      if (a[idx[0]] > a[idx[1]]) std::swap(idx[0], idx[1]);
+      op.perm[0] = idx[1]; op.perm[1] = idx[0]; op.perm[2] = idx[2];
+    }
+    for (int i=0; i<3; i++) op.sign[i] = (k[op.perm[i]] < 0.) ? -1. : 1.;
+    break;
+  }
+  }
+
+  const G4double x = op.sign[0]*k[op.perm[0]];
+  const G4double y = op.sign[1]*k[op.perm[1]];
+  const G4double z = op.sign[2]*k[op.perm[2]];
+
+  theta = std::atan2(std::sqrt(x*x+y*y), z);
+  phi = std::atan2(y, x);
+  phi += (phi<0.) ? twopi : 0.;
+}
+
+void G4CMPPhononKinTable::mapFromWedge(const SymOp& op, double& x,
+				       double& y, double& z) const {
+  const double v[3] = { x, y, z };
+  double* out[3] = { &x, &y, &z };
+  for (int i=0; i<3; i++) *out[op.perm[i]] = op.sign[i]*v[i];
+}
+
+void G4CMPPhononKinTable::mapFromWedge(const SymOp& op,
+				       double* record) const {
+  if (symmetry == NO_SYMMETRY) return;
+
+  mapFromWedge(op, record[N_X], record[N_Y], record[N_Z]);
+  mapFromWedge(op, record[S_X], record[S_Y], record[S_Z]);
+  mapFromWedge(op, record[V_GX], record[V_GY], record[V_GZ]);
+  mapFromWedge(op, record[E_X], record[E_Y], record[E_Z]);
+
+  record[S_PAR] = std::sqrt(record[S_X]*record[S_X] +
+			    record[S_Y]*record[S_Y]);
+}
+// *****************************************************************************
+
 // ****************************** BUILD METHODS ********************************
 /* sets up the vector of vectors of vectors used to store the data
    from the lookup table */
@@ -144,26 +475,8 @@ void G4CMPPhononKinTable::generateLookupTable() {
 
 // $$$$$$$$$$$$$$$$$$$$$$$$$$$ EVEN INTERPOLATION HEADERS $$$$$$$$$$$$$$$$$$$$$$
 
-/* given the (pointer to the) evenly spaced interpolation grid
-   generated previously, this method returns an interpolated value for
-   the data type already built into the G4CMPGridInterp structure */
-double G4CMPPhononKinTable::interpolateEven(G4CMPGridInterp& grid,
-					    double theta, double phi) {
-    // check that the n values we're interpolating at are possible:
-  if (!goodBin(theta,phi)) {
-    cerr << "ERROR: Cannot interpolate (" << theta << ", " << phi << ")"
-	 << endl;
-    return ERRONEOUS_INPUT; // exit method
-  }
-
-  // perform interpolation and return result:
-  return grid.interp(theta, phi);
-}
-
-/* overloaded method interpolates on the vector of vectors of
-   interpolation grid structures.  Much the same as its simpler version,
-   but this one requires specification of the mode and data type
-   desired */
+/* interpolates one data type for the specified mode on the evenly
+   spaced (theta,phi) grid */
 double G4CMPPhononKinTable::interpolateEven(double theta, double phi, int MODE,
 					    int TYPE_OUT, bool SILENT) {
   // check that the n values we're interpolating at are possible:
@@ -181,81 +494,56 @@ double G4CMPPhononKinTable::interpolateEven(double theta, double phi, int MODE,
   }
     
   // perform interpolation and return result:
-  return interpolateEven(quantityMap[MODE][TYPE_OUT], theta, phi);
+  double result;
+  interpolateRecord(theta, phi, MODE, TYPE_OUT, 1, &result);
+  return result;
 }
 
-/* sets up JUST ONE interpolation table for N_X and N_Y, which are evenly spaced.
-   Aphi one kind of data (TYPE_OUT) can be read off of this table */
-G4CMPGridInterp 
-G4CMPPhononKinTable::generateEvenTable(int MODE,
-				     G4CMPPhononKinTable::DataTypes TYPE_OUT) {
-  /* set up the two vectors of input components (N_X and N_Y) which
-     will define the grid that will be interpolated on
-     these grids are deliberately oversized, as our grid is evenly
-     spaced but circular, not square. */
-  vector<double> x1;
-  for (int ith=0; ith<=thetaCount; ith++) x1.push_back(thetaMin+ith*thetaStep);
-
-  vector<double> x2;
-  for (int iphi=0; iphi<=phiCount; iphi++) x2.push_back(phiMin+iphi*phiStep);
-
-  /* set up the matrix of data values to be interpolated */
-  matrix<double> dataVals(x1.size(), x2.size(), OUT_OF_BOUNDS);
-  size_t SIZE = lookupData[MODE][N_X].size();
-  for (size_t i = 0; i<SIZE; i++) {
-    double thetaVal = lookupData[MODE][THETA][i];
-    double phiVal = lookupData[MODE][PHI][i];
-    
-    // figure out n_x-index of current data point:
-    size_t x1vecIndex = (size_t)((thetaVal-thetaMin) / thetaStep);
-    if (doubApproxEquals(x1[x1vecIndex+1], thetaVal) && x1vecIndex+1 < x1.size())
-      x1vecIndex++;                           // resolve possible rounding issue
-    else if (!doubApproxEquals(x1[x1vecIndex], thetaVal)) { // check
-      cerr << "ERROR: Unanticipated index rounding behavior, thetaVal= "
-	   << thetaVal << " index " << x1vecIndex << " = " << x1[x1vecIndex]
-	   << endl;
-    }
-
-    // figure out n_y-index of current data point:
-    size_t x2vecIndex = (size_t)((phiVal-phiMin) / phiStep);    // may round down to nearest integer index
-    if (doubApproxEquals(x2[x2vecIndex+1], phiVal) && x2vecIndex+1 < x2.size())
-      x2vecIndex++;                           // resolve possible rounding issue
-    else if (!doubApproxEquals(x2[x2vecIndex], phiVal)) {  // check
-      cerr << "ERROR: Unanticipated index rounding behavior, phiVal= "
-	   << phiVal << " index " << x2vecIndex << " = " << x2[x2vecIndex]
-	   << endl;
-    }
-
-    // fill in data point in matrix:
-    // first check to make sure that point not already entered:
-    if (!doubApproxEquals(dataVals[x1vecIndex][x2vecIndex], OUT_OF_BOUNDS,
-			  1.0e-10, false))
-      cerr << "ERROR: Attempting to enter a data value more than once @ "
-	   << x1vecIndex << " " << x2vecIndex << endl;
-    else // at long last, put data point in matrix
-      dataVals[x1vecIndex][x2vecIndex] = lookupData[MODE][TYPE_OUT][i];
+/* bilinear interpolation of a consecutive range of data types.  Since the
+   grid is evenly spaced, the bin is computed directly rather than found by
+   bisection.  Angles must already have been checked with goodBin(). */
+void G4CMPPhononKinTable::interpolateRecord(double theta, double phi,
+					    int MODE, int firstType,
+					    int nType, double* result) const {
+  double ft = (theta-thetaMin)/thetaStep;
+  double fp = (phi-phiMin)/phiStep;
+  int ith = std::max(0, std::min(int(ft), thetaCount-1));
+  int iph = std::max(0, std::min(int(fp), phiCount-1));
+  double t = ft - ith;
+  double u = fp - iph;
+
+  const int nPhi = phiCount+1;
+  const double* r00 =
+    &recordTable[((MODE*(thetaCount+1) + ith)*nPhi + iph)*NUM_DATA_TYPES
+		 + firstType];
+  const double* r10 = r00 + nPhi*NUM_DATA_TYPES;
+  const double* r01 = r00 + NUM_DATA_TYPES;
+  const double* r11 = r10 + NUM_DATA_TYPES;
+
+  const double w00 = (1.-t)*(1.-u), w10 = t*(1.-u);
+  const double w01 = (1.-t)*u,      w11 = t*u;
+  for (int i=0; i<nType; i++) {
+    result[i] = w00*r00[i] + w10*r10[i] + w01*r01[i] + w11*r11[i];
   }
-
-  // create and return interpolation data structure, the output of this method
-  return G4CMPGridInterp(x1, x2, dataVals);
 }
 
-/* a method for setting up a vector of interpolation grids - it does
-   so by calling the single grid constructor maphi times. While this is
-   certainly not the absolute most efficient method concievable, the
-   gains in efficiency that might be made are not terribly
-   significant. Output is a vector of vectors of G4CMPGridInterps, with the
-   first index specifying mode, and the 2nd data type, as ususal */
-void G4CMPPhononKinTable::generateMultiEvenTable() {
-  clearQuantityMap();
+/* copies the lookup data, stored separately for each data type, into
+   one record per mode and grid point, so that all quantities needed for
+   an interpolation are adjacent in memory.  The lookup data are filled
+   in grid order (theta outer, phi inner), and are released afterwards. */
+void G4CMPPhononKinTable::generateRecordTable() {
+  const size_t nEntry = size_t(thetaCount+1)*(phiCount+1);
 
+  recordTable.assign(G4PhononPolarization::NUM_MODES*nEntry*NUM_DATA_TYPES,
+		     OUT_OF_BOUNDS);
+
+  double* rec = recordTable.data();
   for (int mode = 0; mode < G4PhononPolarization::NUM_MODES; mode++) {
-    // create 2nd level vectors:
-    vector<G4CMPGridInterp> subTable;
-    for (int dType = 0; dType < NUM_DATA_TYPES; dType++)
-      // make individual tables:
-      subTable.push_back(generateEvenTable(mode, (DataTypes)dType));
-    quantityMap.push_back(subTable);
+    for (size_t entry = 0; entry < nEntry; entry++) {
+      for (int dType = 0; dType < NUM_DATA_TYPES; dType++, rec++) {
+	*rec = lookupData[mode][dType][entry];
+      }
+    }
   }
 }
 
@@ -263,6 +551,8 @@ void G4CMPPhononKinTable::generateMultiEvenTable() {
 
 // +++++++++++++++++++++++++++++ COMPLETE LOOKUP TABLE +++++++++++++++++++++++++
 void G4CMPPhononKinTable::write() {
+  if (!lookupReady) initialize();	// Fill tables on first query
+
   // <^><^><^><^><^><^><^><^><^> INITIAL SETUP <^><^><^><^><^><^><^><^><
   // set up the lookup table as a data file:
   string fName = mapper->getLatticeName()+"LookupTable.txt";
@@ -292,18 +582,21 @@ void G4CMPPhononKinTable::write() {
     lookupTable << "# " << headerLines[i] << endl;
   // <^><^><^><^><^><^><^><^><^><^><^><^><^><^><^><^><^><^><^><^><^><^><
 
-  int entry=0;
+  const size_t nEntry = size_t(thetaCount+1)*(phiCount+1);
+
+  size_t entry=0;
   for (int ith=0; ith<=thetaCount; ith++) {
     for (int iphi=0; iphi<=phiCount; iphi++) {
       for (int mode = 0; mode < G4PhononPolarization::NUM_MODES; mode++) {
+	const double* rec = &recordTable[(mode*nEntry + entry)*NUM_DATA_TYPES];
 	lookupTable << setw(18) << G4PhononPolarization::Label(mode);
 	for (size_t cols=0; cols<NUM_DATA_TYPES; cols++) {
-	  lookupTable << setw(18) << lookupData[mode][cols][entry]/getDataUnit(cols);
+	  lookupTable << setw(18) << rec[cols]/getDataUnit(cols);
 	}
 	lookupTable << endl;
       }
 
-      entry++;		// Increment counter, corresponding to push_back()
+      entry++;		// Records are in same grid order as lookup data
     }
   }
 }
@@ -361,6 +654,86 @@ G4double G4CMPPhononKinTable::getDataUnit(int TYPE) {
 }
 // +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
+// ++++++++++++++++++++++++++++++ BINARY CACHE ++++++++++++++++++++++++++++++++
+// Binary cache file layout (native byte order):
+//   CacheHeader	(below)
+//   recordTable	NUM_MODES x (nTheta+1)*(nPhi+1) x NUM_DATA_TYPES double
+
+namespace {
+  const char cacheMagic[8] = { 'G','4','C','M','P','K','I','N' };
+  const uint32_t cacheVersion = 2;
+
+  struct CacheHeader {
+    G4CMP::CacheFileHeader file;	// Key identifies kinematics and binning
+    uint32_t nModes;
+    uint32_t nTypes;
+    int32_t  nTheta;
+    int32_t  nPhi;
+  };
+}
+
+// Key combines lattice elasticity and density with table binning
+uint64_t G4CMPPhononKinTable::cacheKey() const {
+  const double binning[6] = { thetaMin, thetaMax, double(thetaCount),
+			      phiMin, phiMax, double(phiCount) };
+  return G4CMP::HashBytes(binning, sizeof(binning),
+			  mapper->getLattice()->GetKinematicsKey());
+}
+
+G4bool G4CMPPhononKinTable::SaveCache(const G4String& fname,
+				      uint64_t key) const {
+  const size_t nRecord = (G4PhononPolarization::NUM_MODES *
+			  size_t(thetaCount+1)*(phiCount+1) * NUM_DATA_TYPES);
+
+  CacheHeader head;
+  memset(&head, 0, sizeof(head));
+  G4CMP::FillCacheHeader(head.file, cacheMagic, cacheVersion, key);
+  head.nModes    = G4PhononPolarization::NUM_MODES;
+  head.nTypes    = NUM_DATA_TYPES;
+  head.nTheta    = thetaCount;
+  head.nPhi      = phiCount;
+
+  G4bool good = (recordTable.size() == nRecord &&
+		 G4CMP::WriteCacheFile(fname, {
+		     { &head, sizeof(head) },
+		     { recordTable.data(), nRecord*sizeof(double) } }));
+
+  if (!good) {
+    G4cerr << "G4CMPPhononKinTable::SaveCache unable to write " << fname
+	   << G4endl;
+    return false;
+  }
+
+  return true;
+}
+
+G4bool G4CMPPhononKinTable::LoadCache(const G4String& fname, uint64_t key) {
+  ifstream load(fname, ios::binary);
+  if (!load.good()) return false;		// No cache file available
+
+  CacheHeader head;
+  load.read((char*)&head, sizeof(head));
+  if (!load.good() ||
+      !G4CMP::IsValidCacheHeader(head.file, cacheMagic, cacheVersion, key) ||
+      head.nModes != G4PhononPolarization::NUM_MODES ||
+      head.nTypes != NUM_DATA_TYPES || head.nTheta != thetaCount ||
+      head.nPhi != phiCount) return false;
+
+  const size_t nRecord = (G4PhononPolarization::NUM_MODES *
+			  size_t(thetaCount+1)*(phiCount+1) * NUM_DATA_TYPES);
+
+  recordTable.resize(nRecord);
+  load.read((char*)recordTable.data(), nRecord*sizeof(double));
+
+  if (!load.good()) {				// Truncated file
+    recordTable.clear();
+    return false;
+  }
+
+  return true;
+}
+// +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
 // ############################# EXTRANEOUS HEADERS ############################
 
 /* takes two Doubs and returns 'true' if they are sufficiently close
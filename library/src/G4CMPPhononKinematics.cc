@@ -3,64 +3,95 @@
 //
 //  20160624  Allow non-unit vector to be passed into computeKinematics()
 //  20170525  Drop unnecessary empty destructor ("rule of five" semantics)
+//  20261017  Use specialized 3x3 eigensolver; fill Christoffel matrix and group
+//		velocity using symmetries; cache results for recent directions
+//  20261017  Use G4CMP::HashBytes() to select cache slot
 
 #include "G4CMPPhononKinematics.hh"
+#include "G4CMPUtils.hh"
 #include "G4LatticeLogical.hh"
 #include "G4PhononPolarization.hh"
 #include "G4ThreeVector.hh"
+#include <stdint.h>
 
 // ++++++++++++++++++++++ G4CMPPhononKinematics METHODS +++++++++++++++++++++++++++
 
 G4CMPPhononKinematics::G4CMPPhononKinematics(G4LatticeLogical *lat)
-  : lattice(lat), christoffel(G4ThreeVector::SIZE, G4ThreeVector::SIZE, 0.) {;}
+  : lattice(lat), cache(cacheSize), current(0) {
+  for (auto& soln: cache) soln.ndir.set(0.,0.,0.);	// Mark all unused
+}
 
 // Build D_il, the Christoffel matrix that defines the eigensystem
+// Matrix is symmetric, so only upper triangle is computed
 void G4CMPPhononKinematics::fillChristoffelMatrix(const G4ThreeVector& nn)
 {
-  christoffel.clear();
+  const double nnjm[3][3] = { { nn[0]*nn[0], nn[0]*nn[1], nn[0]*nn[2] },
+			      { nn[1]*nn[0], nn[1]*nn[1], nn[1]*nn[2] },
+			      { nn[2]*nn[0], nn[2]*nn[1], nn[2]*nn[2] } };
+
+  const double invRho = 1./lattice->GetDensity();
   for (int i = 0; i < G4ThreeVector::SIZE; i++) {
-    for (int l = 0; l < G4ThreeVector::SIZE; l++) {
+    for (int l = i; l < G4ThreeVector::SIZE; l++) {
+      double sum = 0.;
       for (int j = 0; j < G4ThreeVector::SIZE; j++) {
 	for (int m = 0; m < G4ThreeVector::SIZE; m++) {
-	  christoffel[i][l] += (lattice->GetCijkl(i,j,l,m) * nn[j] * nn[m]);
+	  sum += lattice->GetCijkl(i,j,l,m) * nnjm[j][m];
 	}
       }
-      christoffel[i][l] /= lattice->GetDensity();
+      christoffel[i][l] = christoffel[l][i] = sum * invRho;
     }
   }
 }
 
 // Compute kinematics for specified wavevector (direction)
 void G4CMPPhononKinematics::computeKinematics(const G4ThreeVector& n_dir) {
-  if (n_dir.unit().isNear(last_ndir)) return;		// Already computed
+  const G4ThreeVector ndir = n_dir.unit();
+  if (ndir.isNear(cache[current].ndir)) return;		// Already computed
+
+  current = cacheIndex(ndir);
+  if (!ndir.isNear(cache[current].ndir)) solve(ndir, cache[current]);
+}
+
+// Hash of direction bits selects cache slot
+size_t G4CMPPhononKinematics::cacheIndex(const G4ThreeVector& ndir) const {
+  const double x[3] = { ndir.x()+0., ndir.y()+0., ndir.z()+0. };  // -0 as +0
+  uint64_t hash = G4CMP::HashBytes(x, sizeof(x));
 
+  return size_t(hash ^ (hash >> 32)) & (cacheSize-1);
+}
+
+// Compute phase speed, polarization and group velocity of all modes
+void G4CMPPhononKinematics::solve(const G4ThreeVector& ndir,
+				  Solution& soln) {
   /* get the Christoffel Matrix D_il, which is symmetric (it
      equals its transpose).  This also means its eigenvalues will
      all be real (NR, pg. 564) */
-  fillChristoffelMatrix(n_dir.unit());
-  
-  /* set up and solve eigensystem of D_il:
-     Use NR's method for real, symmetric matricies.
+  fillChristoffelMatrix(ndir);
+
+  /* solve eigensystem of D_il:
      Eigenvalues are the phase velocities squared (v_phase = omega/k).
      Eigenvectors are the corresponding polaizrations e_l.
-     Eigenvalues stored in eigenSys.d[0..n-1] in descening order.
-     Corresponding eigenvectors are the columns of eigenSys.z[0..n-1][0..n-1] */
+     Eigenvalues stored in eigenSys.d[0..2] in descending order.
+     Corresponding eigenvectors are the columns of eigenSys.z */
   eigenSys.setup(christoffel);
-  
+
   /* Extract eigen vectors and values for each mode.
    * We must sort them to match the sorting in G4PhononPolarization.
    * This assumes that fast transverse is more energetic than slow transverse,
    * and I'm not positive that's always true.
    */
+  G4ThreeVector evec[3];
+  for (size_t i = 0; i < 3; ++i) {
+    evec[i].set(eigenSys.z[G4ThreeVector::X][i],
+		eigenSys.z[G4ThreeVector::Y][i],
+		eigenSys.z[G4ThreeVector::Z][i]);
+  }
 
   //Whichever eigenvector is most parallel with k is the longitudinal mode
   G4double mostParallelMeasure = 0;
   size_t longIdx = 0;
   for (size_t i = 0; i < 3; ++i) {
-    const G4double howParallel = G4ThreeVector(eigenSys.z[0][i],
-                                               eigenSys.z[1][i],
-                                               eigenSys.z[2][i])
-                                              .howOrthogonal(n_dir);
+    const G4double howParallel = evec[i].howOrthogonal(ndir);
     if (howParallel > mostParallelMeasure) {
       mostParallelMeasure = howParallel;
       longIdx = i;
@@ -80,68 +111,72 @@ void G4CMPPhononKinematics::computeKinematics(const G4ThreeVector& n_dir) {
   }
 
   for (int mode = 0; mode < G4PhononPolarization::NUM_MODES; mode++) {
-    // calculate desired quantities that will populate lookup table.
     // Must map the G4PhononPolarization indices to the eigen indices from
     // the solver.
     size_t idx = (mode == G4PhononPolarization::Long ? longIdx :
 		  mode == G4PhononPolarization::TransFast ? fastTransIdx :
 		  slowTransIdx);
-    vphase[mode] = sqrt(eigenSys.d[idx]);
-    slowness[mode] = n_dir.unit()/vphase[mode];
-    polarization[mode].set(eigenSys.z[G4ThreeVector::X][idx],
-                           eigenSys.z[G4ThreeVector::Y][idx],
-                           eigenSys.z[G4ThreeVector::Z][idx]);
-    
-    computeGroupVelocity(mode, idx, eigenSys.z, slowness[mode]);
+    soln.vphase[mode] = sqrt(eigenSys.d[idx]);
+    soln.slowness[mode] = ndir/soln.vphase[mode];
+    soln.polarization[mode] = evec[idx];
+    soln.vgroup[mode] = groupVelocity(evec[idx], soln.slowness[mode]);
   }
-  
+
   /* Store wavevector direction to avoid recalculations */
-  last_ndir = n_dir.unit();
+  soln.ndir = ndir;
 }
 
-// Fill group velocity cache for specified mode from lattice parameters
-// NOTE:  Must only be called from computeKinematics() above!
-void G4CMPPhononKinematics::computeGroupVelocity(int mode,
-                                                 size_t idx,
-                                                 const matrix<double>& e_mat,
-                                                 const G4ThreeVector& slow) {
-  vgroup[mode].set(0.,0.,0.);
+// Group velocity from lattice parameters, v_k = e_i C_ijlk s_j e_l / rho
+G4ThreeVector
+G4CMPPhononKinematics::groupVelocity(const G4ThreeVector& e,
+				     const G4ThreeVector& slow) const {
+  double ees[3][3][3];			// e_i s_j e_l, reused for all k
+  for (int i=0; i<G4ThreeVector::SIZE; i++) {
+    for (int j=0; j<G4ThreeVector::SIZE; j++) {
+      for (int l=0; l<G4ThreeVector::SIZE; l++) {
+	ees[i][j][l] = e[i] * slow[j] * e[l];
+      }
+    }
+  }
+
+  G4ThreeVector vg;
   for (int dim=0; dim<G4ThreeVector::SIZE; dim++) {
+    double sum = 0.;
     for (int i=0; i<G4ThreeVector::SIZE; i++) {
       for (int j=0; j<G4ThreeVector::SIZE; j++) {
 	for (int l=0; l<G4ThreeVector::SIZE; l++) {
-    vgroup[mode][dim] += (e_mat[i][idx] * lattice->GetCijkl(i,j,l,dim)
-        * slow[j] * e_mat[l][idx]);
+	  sum += ees[i][j][l] * lattice->GetCijkl(i,j,l,dim);
 	}
       }
     }
+    vg[dim] = sum;
   }
-  
-  vgroup[mode] /= lattice->GetDensity();
+
+  return vg / lattice->GetDensity();
 }
 
 const G4ThreeVector& 
 G4CMPPhononKinematics::getGroupVelocity(int mode, const G4ThreeVector& n_dir) {
   computeKinematics(n_dir);
-  return vgroup[mode];
+  return cache[current].vgroup[mode];
 }
 
 const G4ThreeVector& 
 G4CMPPhononKinematics::getPolarization(int mode, const G4ThreeVector& n_dir) {
   computeKinematics(n_dir);
-  return polarization[mode];
+  return cache[current].polarization[mode];
 }
 
 const G4ThreeVector& 
 G4CMPPhononKinematics::getSlowness(int mode, const G4ThreeVector& n_dir) {
   computeKinematics(n_dir);
-  return slowness[mode];
+  return cache[current].slowness[mode];
 }
 
 double 
 G4CMPPhononKinematics::getPhaseSpeed(int mode, const G4ThreeVector& n_dir) {
   computeKinematics(n_dir);
-  return vphase[mode];
+  return cache[current].vphase[mode];
 }
 
 const G4String& G4CMPPhononKinematics::getLatticeName() const {
@@ -0,0 +1,49 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file library/src/G4CMPPhononSurfaceImportance.cc
+/// \brief Implementation of the G4CMPPhononSurfaceImportance class
+//
+// $Id$
+//
+// 20261017  New class, for use with G4CMPPhononWeightWindow
+
+#include "G4CMPPhononSurfaceImportance.hh"
+#include "G4CMPGeometryUtils.hh"
+#include "G4Track.hh"
+#include <algorithm>
+#include <float.h>
+#include <cmath>
+
+
+G4double
+G4CMPPhononSurfaceImportance::GetImportance(const G4Track& track) const {
+  return BandImportance(GetDistance(G4CMP::GetLocalPosition(track.GetTouchable(),
+						track.GetPosition())));
+}
+
+
+void G4CMPPhononSurfaceImportance::AddSurface(const G4ThreeVector& point,
+					      const G4ThreeVector& normal) {
+  if (normal.mag2() <= 0.) {
+    G4Exception("G4CMPPhononSurfaceImportance::AddSurface", "Importance002",
+		JustWarning, "Surface normal must be non-zero; ignored.");
+    return;
+  }
+
+  points.push_back(point);
+  normals.push_back(normal.unit());
+}
+
+
+G4double
+G4CMPPhononSurfaceImportance::GetDistance(const G4ThreeVector& pos) const {
+  G4double dist = DBL_MAX;
+  for (size_t i=0; i<points.size(); i++) {
+    dist = std::min(dist, std::fabs((pos-points[i]).dot(normals[i])));
+  }
+
+  return dist;
+}
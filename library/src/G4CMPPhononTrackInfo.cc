@@ -13,14 +13,16 @@
 //
 // 20161111 Initial commit - R. Agnese
 // 20170728 M. Kelsey -- Replace "k" function args with "theK" (-Wshadow)
+// 20261017 Use thread-local G4Allocator, with large pages, for track info
+// 20261017 Add last-applied importance, for G4CMPPhononWeightWindow
 
 #include "G4CMPPhononTrackInfo.hh"
 
-//G4Allocator<G4CMPPhononTrackInfo> G4CMPPhononTrackInfoAllocator;
+G4ThreadLocal G4Allocator<G4CMPPhononTrackInfo>* G4CMPPhononTrackInfoAllocator = 0;
 
 G4CMPPhononTrackInfo::G4CMPPhononTrackInfo(const G4LatticePhysical* lat,
                                            G4ThreeVector theK)
-  : G4CMPVTrackInfo(lat), waveVec(theK) {;}
+  : G4CMPVTrackInfo(lat), waveVec(theK), importance(-1.) {;}
 
 void G4CMPPhononTrackInfo::Print() const {
 //TODO
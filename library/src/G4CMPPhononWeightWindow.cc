@@ -0,0 +1,170 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file library/src/G4CMPPhononWeightWindow.cc
+/// \brief Implementation of the G4CMPPhononWeightWindow process, to split
+///	   or roulette phonons according to a user importance map.
+//
+// $Id$
+//
+// 20261017  New process for in-flight phonon variance reduction
+
+#include "G4CMPPhononWeightWindow.hh"
+#include "G4CMPConfigManager.hh"
+#include "G4CMPPhononTrackInfo.hh"
+#include "G4CMPTrackUtils.hh"
+#include "G4CMPUtils.hh"
+#include "G4CMPVPhononImportance.hh"
+#include "G4DynamicParticle.hh"
+#include "G4ForceCondition.hh"
+#include "G4ParticleChange.hh"
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "Randomize.hh"
+#include <cmath>
+#include <float.h>
+
+
+// Limit on copies from a single step, to avoid runaway memory use
+namespace {
+  const G4int maxSplit = 100;
+}
+
+
+// Only applies to phonons
+
+G4bool G4CMPPhononWeightWindow::IsApplicable(const G4ParticleDefinition& pd) {
+  return G4CMP::IsPhonon(pd);
+}
+
+
+// Evaluate every step if an importance map is configured
+
+G4double G4CMPPhononWeightWindow::GetMeanFreePath(const G4Track&, G4double,
+						  G4ForceCondition* condition) {
+  *condition = (G4CMPConfigManager::GetPhononImportance() ? StronglyForced
+		: NotForced);
+  return DBL_MAX;
+}
+
+G4double G4CMPPhononWeightWindow::
+PostStepGetPhysicalInteractionLength(const G4Track& trk, G4double sl,
+				     G4ForceCondition* condition) {
+  return GetMeanFreePath(trk, sl, condition);	// No GPIL handling needed
+}
+
+
+// Compare current importance to last applied, and adjust population
+
+G4VParticleChange* G4CMPPhononWeightWindow::PostStepDoIt(const G4Track& track,
+							 const G4Step&) {
+  aParticleChange.Initialize(track);
+
+  const G4CMPVPhononImportance* importance =
+    G4CMPConfigManager::GetPhononImportance();
+
+  // Track may already have been absorbed or killed during this step
+  if (!importance || track.GetTrackStatus() == fStopAndKill ||
+      !G4CMP::HasTrackInfo(track)) return &aParticleChange;
+
+  auto trackInfo = G4CMP::GetTrackInfo<G4CMPPhononTrackInfo>(track);
+  G4double newImp = importance->GetImportance(track);
+  G4double oldImp = trackInfo->Importance();
+
+  if (verboseLevel>2) {
+    G4cout << GetProcessName() << "::PostStepDoIt importance " << oldImp
+	   << " -> " << newImp << " weight " << track.GetWeight() << G4endl;
+  }
+
+  if (newImp <= 0.) {			// Zero importance, no need to track
+    aParticleChange.ProposeTrackStatus(fStopAndKill);
+    return &aParticleChange;
+  }
+
+  if (oldImp <= 0.) {			// First use sets reference
+    trackInfo->SetImportance(newImp);
+    return &aParticleChange;
+  }
+
+  const G4double window = G4CMPConfigManager::GetImportanceRatio();
+  G4double ratio = newImp / oldImp;
+  if (ratio < window && ratio*window > 1.) return &aParticleChange;
+
+  if (ratio > maxSplit) {		// Remaining split done on later steps
+    newImp = oldImp * maxSplit;
+    ratio = maxSplit;
+  }
+
+  trackInfo->SetImportance(newImp);
+
+  if (ratio > 1.) SplitTrack(track, ratio);
+  else RouletteTrack(track, ratio);
+
+  return &aParticleChange;
+}
+
+
+// Generate floor(ratio) or ceil(ratio) tracks, so average number is ratio
+
+void G4CMPPhononWeightWindow::SplitTrack(const G4Track& track,
+					 G4double ratio) {
+  G4int nCopy = G4int(ratio);
+  if (G4UniformRand() < ratio-nCopy) nCopy++;
+
+  G4double weight = track.GetWeight() / ratio;
+
+  if (verboseLevel>1) {
+    G4cout << GetProcessName() << " splitting track " << track.GetTrackID()
+	   << " into " << nCopy << " with weight " << weight << G4endl;
+  }
+
+  aParticleChange.ProposeWeight(weight);	// Original is first copy
+
+  if (nCopy < 2) return;
+
+  aParticleChange.SetSecondaryWeightByProcess(true);
+  aParticleChange.SetNumberOfSecondaries(nCopy-1);
+  for (G4int i=1; i<nCopy; i++) {
+    aParticleChange.AddSecondary(CloneTrack(track, weight));
+  }
+}
+
+
+// Keep track with probability ratio, with weight increased to match
+
+void G4CMPPhononWeightWindow::RouletteTrack(const G4Track& track,
+					    G4double ratio) {
+  if (G4UniformRand() < ratio) {
+    aParticleChange.ProposeWeight(track.GetWeight() / ratio);
+  } else {
+    aParticleChange.ProposeTrackStatus(fStopAndKill);
+  }
+
+  if (verboseLevel>1) {
+    G4cout << GetProcessName() << " roulette track " << track.GetTrackID()
+	   << (aParticleChange.GetTrackStatus()==fStopAndKill ? " killed"
+	       : " kept") << G4endl;
+  }
+}
+
+
+// Copy current kinematics, including wavevector and importance
+
+G4Track* G4CMPPhononWeightWindow::CloneTrack(const G4Track& track,
+					     G4double weight) const {
+  auto clone =
+    new G4Track(new G4DynamicParticle(*track.GetDynamicParticle()),
+		track.GetGlobalTime(), track.GetPosition());
+  clone->SetTouchableHandle(track.GetTouchableHandle());
+  clone->SetGoodForTrackingFlag(true);	// Protect against production cuts
+  clone->SetVelocity(track.GetVelocity());
+  clone->UseGivenVelocity(true);
+  clone->SetWeight(weight);
+
+  auto trackInfo = G4CMP::GetTrackInfo<G4CMPPhononTrackInfo>(track);
+  G4CMP::AttachTrackInfo(clone, new G4CMPPhononTrackInfo(*trackInfo));
+
+  return clone;
+}
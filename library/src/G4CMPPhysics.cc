@@ -19,6 +19,7 @@
 //		process instances for each beam/trap type.
 // 20210203  G4CMP-241: SecondaryProduction must be last PostStep process.
 // 20220331  G4CMP-293: Replace RegisterProcess() with local AddG4CMPProcess().
+// 20261017  Add phonon weight-window process (inactive without importance map)
 
 #include "G4CMPPhysics.hh"
 #include "G4CMPConfigManager.hh"
@@ -31,6 +32,7 @@
 #include "G4CMPInterValleyScattering.hh"
 #include "G4CMPLukeScattering.hh"
 #include "G4CMPPhononBoundaryProcess.hh"
+#include "G4CMPPhononWeightWindow.hh"
 #include "G4CMPSecondaryProduction.hh"
 #include "G4CMPTimeStepper.hh"
 #include "G4CMPTrackLimiter.hh"
@@ -75,6 +77,7 @@ void G4CMPPhysics::ConstructProcess() {
   G4VProcess* luke    = new G4CMPLukeScattering(tmStep);
   G4VProcess* recomb  = new G4CMPDriftRecombinationProcess;
   G4VProcess* eLimit  = new G4CMPTrackLimiter;
+  G4VProcess* phWind  = new G4CMPPhononWeightWindow;
   G4VProcess* trapping = new G4CMPDriftTrappingProcess;
 
   // NOTE: Trap ionization needs separate instances for each particle type
@@ -94,18 +97,21 @@ void G4CMPPhysics::ConstructProcess() {
   AddG4CMPProcess(phDown, particle);
   AddG4CMPProcess(phRefl, particle);
   AddG4CMPProcess(eLimit, particle);
+  AddG4CMPProcess(phWind, particle);
 
   particle = G4PhononTransSlow::PhononDefinition();
   AddG4CMPProcess(phScat, particle);
   AddG4CMPProcess(phDown, particle);
   AddG4CMPProcess(phRefl, particle);
   AddG4CMPProcess(eLimit, particle);
+  AddG4CMPProcess(phWind, particle);
 
   particle = G4PhononTransFast::PhononDefinition();
   AddG4CMPProcess(phScat, particle);
   AddG4CMPProcess(phDown, particle);
   AddG4CMPProcess(phRefl, particle);
   AddG4CMPProcess(eLimit, particle);
+  AddG4CMPProcess(phWind, particle);
 
   particle = edrift;
   AddG4CMPProcess(tmStep, particle);
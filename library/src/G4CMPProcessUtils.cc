@@ -48,6 +48,8 @@
 // 20240303  Add local currentTouchable pointer for non-tracking situations.
 // 20240402  Drop FindTouchable() function.  Set currentTouchable internally
 //		not available from track, and delete it at end of track.
+// 20261017  Take current-track lattice and local kinematics from per-step
+//		G4CMPStepContext, shared with other processes and rate models.
 
 #include "G4CMPProcessUtils.hh"
 #include "G4CMPDriftElectron.hh"
@@ -55,6 +57,7 @@
 #include "G4CMPDriftTrackInfo.hh"
 #include "G4CMPGeometryUtils.hh"
 #include "G4CMPPhononTrackInfo.hh"
+#include "G4CMPStepContext.hh"
 #include "G4CMPUtils.hh"
 #include "G4CMPTrackUtils.hh"
 #include "G4AffineTransform.hh"
@@ -169,7 +172,15 @@ void G4CMPProcessUtils::SetCurrentTrack(const G4Track* track) {
 }
 
 void G4CMPProcessUtils::SetLattice(const G4Track* track) {
-  theLattice = track ? G4CMP::GetLattice(*track) : nullptr;
+  theLattice = track ? G4CMPStepContext::Get(*track).GetLattice() : nullptr;
+}
+
+
+// Current track's cached values are only usable with its own transforms
+
+G4bool G4CMPProcessUtils::UseStepContext(const G4Track& track) const {
+  return (&track == currentTrack && track.GetTouchable() &&
+	  G4CMPStepContext::Get(track).GetLattice() == theLattice);
 }
 
 
@@ -257,6 +268,9 @@ void G4CMPProcessUtils::RotateToGlobalPosition(G4ThreeVector& pos) const {
 // Access track position and momentum in local coordinates
 
 G4ThreeVector G4CMPProcessUtils::GetLocalPosition(const G4Track& track) const {
+  if (UseStepContext(track))
+    return G4CMPStepContext::Get(track).GetLocalPosition();
+
   return GetLocalPosition(track.GetPosition());
 }
 
@@ -269,6 +283,9 @@ void G4CMPProcessUtils::GetLocalPosition(const G4Track& track,
 }
 
 G4ThreeVector G4CMPProcessUtils::GetLocalMomentum(const G4Track& track) const {
+  if (UseStepContext(track) && G4CMP::IsChargeCarrier(track))
+    return G4CMPStepContext::Get(track).GetLocalMomentum();
+
   if (G4CMP::IsElectron(track)) {
     return theLattice->MapV_elToP(GetValleyIndex(track),
                                   GetLocalVelocityVector(track));
@@ -291,6 +308,9 @@ void G4CMPProcessUtils::GetLocalMomentum(const G4Track& track,
 
 G4ThreeVector 
 G4CMPProcessUtils::GetLocalVelocityVector(const G4Track& track) const {
+  if (UseStepContext(track))
+    return G4CMPStepContext::Get(track).GetLocalVelocity();
+
   G4ThreeVector vel = track.CalculateVelocity() * track.GetMomentumDirection();
   RotateToLocalDirection(vel);
   return vel;
@@ -305,6 +325,10 @@ void G4CMPProcessUtils::GetLocalVelocityVector(const G4Track &track,
 }
 
 G4ThreeVector G4CMPProcessUtils::GetLocalWaveVector(const G4Track& track) const {
+  if ((G4CMP::IsChargeCarrier(track) || G4CMP::IsPhonon(track)) &&
+      UseStepContext(track))
+    return G4CMPStepContext::Get(track).GetLocalWaveVector();
+
   if (G4CMP::IsChargeCarrier(track)) {
     return GetLocalMomentum(track) / hbarc;
   } else if (G4CMP::IsPhonon(track)) {
@@ -367,6 +391,9 @@ void G4CMPProcessUtils::GetGlobalVelocityVector(const G4Track &track, G4double v
 
 G4double G4CMPProcessUtils::GetKineticEnergy(const G4Track &track) const {
   if (G4CMP::IsElectron(track)) {
+    if (UseStepContext(track))
+      return G4CMPStepContext::Get(track).GetKineticEnergy();
+
     return theLattice->MapV_elToEkin(GetValleyIndex(track),
                                      GetLocalVelocityVector(track));
   } else if (G4CMP::IsHole(track)) {
@@ -490,6 +517,9 @@ G4int G4CMPProcessUtils::ChangeValley(G4int valley) const {
 // Access electron propagation direction/index
 
 G4int G4CMPProcessUtils::GetValleyIndex(const G4Track& track) const {
+  if (G4CMP::IsChargeCarrier(track) && UseStepContext(track))
+    return G4CMPStepContext::Get(track).GetValleyIndex();
+
   return G4CMP::GetTrackInfo<G4CMPDriftTrackInfo>(track)->ValleyIndex();
 }
 
@@ -0,0 +1,355 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+// $Id$
+//
+// 20261017  Adapted from TriLinearInterp, for use with G4CMPMeshElectricField
+// 20261017  Use cache header and WriteCacheFile() from G4CMPUtils
+
+#include "G4CMPRegularGridInterp.hh"
+#include "G4CMPConfigManager.hh"
+#include "G4CMPTriLinearInterp.hh"
+#include "G4CMPUtils.hh"
+#include "G4SystemOfUnits.hh"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <string.h>
+
+using std::vector;
+
+
+// Constructors keep a private copy of source mesh (sharing its tables)
+
+G4CMPRegularGridInterp::
+G4CMPRegularGridInterp(const G4CMPTriLinearInterp& source, G4double step,
+		       G4bool resample)
+  : G4CMPVMeshInterpolator("GRD"), Grid(std::make_shared<GridTables>()),
+    Source(static_cast<G4CMPTriLinearInterp*>(source.Clone())),
+    GridStep(step) {
+  if (resample) Resample();
+}
+
+G4CMPRegularGridInterp::
+G4CMPRegularGridInterp(const G4CMPRegularGridInterp& rhs)
+  : G4CMPVMeshInterpolator(rhs), Grid(rhs.Grid),	// Tables are shared
+    Source(static_cast<G4CMPTriLinearInterp*>(rhs.Source->Clone())),
+    GridStep(rhs.GridStep) {;}
+
+G4CMPRegularGridInterp::~G4CMPRegularGridInterp() {
+  delete Source;
+}
+
+
+// Replace values in source mesh, then recompute all grid nodes
+
+void G4CMPRegularGridInterp::UseValues(const vector<G4double>& v) {
+  Source->UseValues(v);
+  Resample();
+}
+
+
+// Overlay grid on source mesh bounding box and evaluate at each node
+
+void G4CMPRegularGridInterp::FillGradients() {
+  const size_t maxNodes = 1<<24;	// Limits memory use to 128 MB
+
+  Grid = std::make_shared<GridTables>();	// Don't modify shared tables
+  GridTables& grid = *Grid;			// For convenience below
+
+  point3d xmax;
+  Source->GetBoundingBox(grid.Min, xmax);
+
+  if (!(GridStep > 0.) || xmax[0] <= grid.Min[0] || xmax[1] <= grid.Min[1]
+      || xmax[2] <= grid.Min[2]) {
+    G4cerr << "G4CMPRegularGridInterp: Invalid grid step or empty mesh."
+	   << " Using tetrahedral mesh directly." << G4endl;
+    return;
+  }
+
+  // Coarsen grid if requested spacing would use too much memory
+  G4double step = GridStep;
+  size_t nNodes = 0;
+  while (true) {
+    nNodes = 1;
+    for (G4int dim=0; dim<3; dim++) {
+      grid.Dim[dim] = std::max(1, (G4int)std::ceil((xmax[dim]-grid.Min[dim])
+						   / step));
+      nNodes *= grid.Dim[dim]+1;
+    }
+
+    if (nNodes <= maxNodes) break;
+    step *= 1.01*std::cbrt(G4double(nNodes)/maxNodes);
+  }
+
+  if (step != GridStep) {
+    G4cerr << "G4CMPRegularGridInterp: Grid step " << GridStep/mm << " mm would"
+	   << " exceed " << maxNodes << " nodes; using " << step/mm << " mm"
+	   << G4endl;
+  }
+
+  for (G4int dim=0; dim<3; dim++) {	// Fit cells exactly to bounding box
+    grid.Step[dim] = (xmax[dim]-grid.Min[dim]) / grid.Dim[dim];
+    grid.InvStep[dim] = 1./grid.Step[dim];
+  }
+
+  // Nodes are filled along Z first, so that mesh searches stay short
+  grid.Nodes.resize(nNodes);
+  vector<char> nodeGood(nNodes, 0);
+
+  G4double pos[3];
+  G4ThreeVector grad;
+  size_t inode = 0;
+  for (G4int i=0; i<=grid.Dim[0]; i++) {
+    pos[0] = grid.Min[0] + i*grid.Step[0];
+    for (G4int j=0; j<=grid.Dim[1]; j++) {
+      pos[1] = grid.Min[1] + j*grid.Step[1];
+      for (G4int k=0; k<=grid.Dim[2]; k++, inode++) {
+	pos[2] = grid.Min[2] + k*grid.Step[2];
+	nodeGood[inode] = Source->GetValueAndGrad(pos, grid.Nodes[inode],
+						  grad);
+      }
+    }
+  }
+
+  // Cells may be interpolated only if all corners are inside the hull
+  const size_t sj = grid.Dim[2]+1, si = (grid.Dim[1]+1)*sj;
+
+  grid.CellGood.resize(size_t(grid.Dim[0])*grid.Dim[1]*grid.Dim[2]);
+  size_t icell = 0, nGood = 0;
+  for (G4int i=0; i<grid.Dim[0]; i++) {
+    for (G4int j=0; j<grid.Dim[1]; j++) {
+      for (G4int k=0; k<grid.Dim[2]; k++, icell++) {
+	size_t base = i*si + j*sj + k;
+	grid.CellGood[icell] = (nodeGood[base]       && nodeGood[base+1] &&
+				nodeGood[base+sj]    && nodeGood[base+sj+1] &&
+				nodeGood[base+si]    && nodeGood[base+si+1] &&
+				nodeGood[base+si+sj] && nodeGood[base+si+sj+1]);
+	if (grid.CellGood[icell]) nGood++;
+      }
+    }
+  }
+
+  if (G4CMPConfigManager::GetVerboseLevel()) {
+    G4cout << "G4CMPRegularGridInterp: Resampled mesh onto " << grid.Dim[0]
+	   << " x " << grid.Dim[1] << " x " << grid.Dim[2] << " cells; "
+	   << grid.CellGood.size()-nGood << " use tetrahedral mesh" << G4endl;
+  }
+}
+
+
+// Trilinear interpolation within grid cell, and its derivatives
+
+G4bool G4CMPRegularGridInterp::Interpolate(const G4double pos[3],
+				    G4double result[4]) const {
+  const GridTables& grid = *Grid;	// For convenience below
+  if (grid.CellGood.empty()) return false;
+
+  G4int cell[3];
+  G4double frac[3];
+  for (G4int dim=0; dim<3; dim++) {
+    G4double u = (pos[dim]-grid.Min[dim])*grid.InvStep[dim];
+    if (!(u >= 0. && u <= grid.Dim[dim])) return false;	// Also catches NaN
+
+    cell[dim] = std::min((G4int)u, grid.Dim[dim]-1);
+    frac[dim] = u - cell[dim];
+  }
+
+  if (!grid.CellGood[(cell[0]*grid.Dim[1] + cell[1])*grid.Dim[2] + cell[2]])
+    return false;
+
+  const size_t sj = grid.Dim[2]+1, si = (grid.Dim[1]+1)*sj;
+  const size_t base = cell[0]*si + cell[1]*sj + cell[2];
+
+  result[0] = result[1] = result[2] = result[3] = 0.;
+  for (G4int corner=0; corner<8; corner++) {
+    G4int di = (corner>>2)&1, dj = (corner>>1)&1, dk = corner&1;
+    G4double wx = di ? frac[0] : 1.-frac[0];
+    G4double wy = dj ? frac[1] : 1.-frac[1];
+    G4double wz = dk ? frac[2] : 1.-frac[2];
+
+    G4double node = grid.Nodes[base + di*si + dj*sj + dk];
+    result[0] += wx*wy*wz * node;
+    result[1] += (di ? 1. : -1.)*grid.InvStep[0] * wy*wz * node;
+    result[2] += (dj ? 1. : -1.)*grid.InvStep[1] * wx*wz * node;
+    result[3] += (dk ? 1. : -1.)*grid.InvStep[2] * wx*wy * node;
+  }
+
+  return true;
+}
+
+
+// Evaluate grid at arbitrary location, returning potential or gradient
+
+G4double
+G4CMPRegularGridInterp::GetValue(const G4double pos[3], G4bool quiet) const {
+  G4double result[4];
+  return (Interpolate(pos, result) ? result[0] : Source->GetValue(pos, quiet));
+}
+
+G4ThreeVector
+G4CMPRegularGridInterp::GetGrad(const G4double pos[3], G4bool quiet) const {
+  G4double result[4];
+  return (Interpolate(pos, result)
+	  ? G4ThreeVector(result[1], result[2], result[3])
+	  : Source->GetGrad(pos, quiet));
+}
+
+void G4CMPRegularGridInterp::
+GetValuesAndGrads(const vector<point3d>& pos, vector<G4double>& values,
+		  vector<G4ThreeVector>& grads, G4bool quiet) const {
+  values.resize(pos.size());
+  grads.resize(pos.size());
+
+  G4double result[4];
+  for (size_t i=0; i<pos.size(); i++) {
+    if (Interpolate(pos[i].data(), result)) {
+      values[i] = result[0];
+      grads[i].set(result[1], result[2], result[3]);
+    } else if (!Source->GetValueAndGrad(pos[i].data(), values[i], grads[i])
+	       && !quiet) {
+      G4cerr << "G4CMPRegularGridInterp::GetValuesAndGrads:"
+	     << " Point outside of hull!\n pt = " << pos[i] << G4endl;
+    }
+  }
+}
+
+
+// Write data blocks to output file: grid nodes and values
+
+void G4CMPRegularGridInterp::SavePoints(const G4String& fname) const {
+  const GridTables& grid = *Grid;	// For convenience below
+  if (grid.Nodes.empty()) {
+    Source->SavePoints(fname);
+    return;
+  }
+
+  G4cout << "Writing grid nodes and values to " << fname << G4endl;
+  std::ofstream save(fname);
+  size_t inode = 0;
+  for (G4int i=0; i<=grid.Dim[0]; i++) {
+    for (G4int j=0; j<=grid.Dim[1]; j++) {
+      for (G4int k=0; k<=grid.Dim[2]; k++, inode++) {
+	save << grid.Min[0]+i*grid.Step[0] << " " << grid.Min[1]+j*grid.Step[1]
+	     << " " << grid.Min[2]+k*grid.Step[2] << " "
+	     << grid.Nodes[inode] << std::endl;
+      }
+    }
+  }
+}
+
+void G4CMPRegularGridInterp::SaveTetra(const G4String& fname) const {
+  Source->SaveTetra(fname);
+}
+
+
+// Binary cache file layout (native byte order, no padding between blocks):
+//
+//   GridCacheHeader	(below)
+//   Nodes	nNodes double		potential at each node
+//   CellGood	nCells char		cell entirely inside mesh hull
+//
+// Files are rejected if the magic string, version, byte order, source key,
+// requested grid step, or array sizes don't match; the version must be
+// incremented with any change to the layout.
+
+namespace {
+  const char gridMagic[8] = { 'G','4','C','M','P','G','R','D' };
+  const uint32_t gridVersion = 1;
+
+  struct GridCacheHeader {
+    G4CMP::CacheFileHeader file;	// Key identifies mesh input
+    uint64_t nNodes;
+    uint64_t nCells;
+    int32_t  dim[3];
+    int32_t  unused;
+    double   gridStep;		// Requested spacing, before any coarsening
+    double   gridMin[3];
+    double   step[3];
+  };
+}
+
+G4bool G4CMPRegularGridInterp::SaveCache(const G4String& fname,
+				  uint64_t sourceKey) const {
+  const GridTables& grid = *Grid;	// For convenience below
+  if (grid.Nodes.empty()) return false;
+
+  GridCacheHeader head;
+  memset(&head, 0, sizeof(head));
+  G4CMP::FillCacheHeader(head.file, gridMagic, gridVersion, sourceKey);
+  head.nNodes    = grid.Nodes.size();
+  head.nCells    = grid.CellGood.size();
+  head.gridStep  = GridStep;
+  for (G4int dim=0; dim<3; dim++) {
+    head.dim[dim]     = grid.Dim[dim];
+    head.gridMin[dim] = grid.Min[dim];
+    head.step[dim]    = grid.Step[dim];
+  }
+
+  G4cout << "Writing grid tables to cache " << fname << G4endl;
+
+  G4bool good = G4CMP::WriteCacheFile(fname, {
+      { &head, sizeof(head) },
+      { grid.Nodes.data(), grid.Nodes.size()*sizeof(grid.Nodes[0]) },
+      { grid.CellGood.data(), grid.CellGood.size() } });
+
+  if (!good) {
+    G4cerr << "G4CMPRegularGridInterp::SaveCache failed writing " << fname
+	   << G4endl;
+  }
+
+  return good;
+}
+
+G4bool G4CMPRegularGridInterp::LoadCache(const G4String& fname,
+					 uint64_t sourceKey) {
+  std::ifstream load(fname, std::ios::binary);
+  if (!load.good()) return false;		// No cache file available
+
+  GridCacheHeader head;
+  if (!load.read((char*)&head, sizeof(head))) return false;
+
+  G4bool good = (G4CMP::IsValidCacheHeader(head.file, gridMagic, gridVersion,
+					   sourceKey) &&
+		 head.gridStep == GridStep &&
+		 head.dim[0] > 0 && head.dim[1] > 0 && head.dim[2] > 0 &&
+		 head.nCells == (uint64_t)head.dim[0]*head.dim[1]*head.dim[2] &&
+		 head.nNodes == ((uint64_t)(head.dim[0]+1)*(head.dim[1]+1)
+				 *(head.dim[2]+1)));
+
+  std::shared_ptr<GridTables> newGrid;
+  if (good) {
+    newGrid = std::make_shared<GridTables>();
+    GridTables& grid = *newGrid;		// For convenience below
+
+    grid.Nodes.resize(head.nNodes);
+    grid.CellGood.resize(head.nCells);
+    load.read((char*)grid.Nodes.data(),
+	      grid.Nodes.size()*sizeof(grid.Nodes[0]));
+    load.read(grid.CellGood.data(), grid.CellGood.size());
+
+    // Cache file must end exactly after last table
+    good = (load.good() && load.peek() == std::ifstream::traits_type::eof());
+
+    for (G4int dim=0; dim<3; dim++) {
+      grid.Dim[dim]     = head.dim[dim];
+      grid.Min[dim]     = head.gridMin[dim];
+      grid.Step[dim]    = head.step[dim];
+      grid.InvStep[dim] = 1./head.step[dim];
+    }
+  }
+
+  if (good) {
+    Grid = newGrid;
+    G4cout << "G4CMPRegularGridInterp: Loaded " << head.nNodes
+	   << " grid nodes from cache " << fname << G4endl;
+  } else if (G4CMPConfigManager::GetVerboseLevel()) {
+    G4cerr << "G4CMPRegularGridInterp: Ignoring invalid or stale cache "
+	   << fname << G4endl;
+  }
+
+  return good;
+}
@@ -13,6 +13,9 @@
 // 20210518 M. Kelsey -- Protect new secondaries from production cuts
 // 20220907 G4CMP-316 -- Pass track into CreateXYZ() functions; do valley
 //		selection for electrons in CreateChargeCarrier().
+// 20261017 Add CreatePhonon() with precomputed group velocity, so callers
+//		can use batch G4LatticePhysical::MapKtoVg().
+// 20261017 Phonon secondaries of phonons inherit importance (weight window)
 
 #include "G4CMPSecondaryUtils.hh"
 #include "G4CMPDriftHole.hh"
@@ -68,7 +71,17 @@ G4Track* G4CMP::CreatePhonon(const G4Track& track, G4int mode,
     mode = ChoosePhononPolarization(lat);
   }
 
-  G4ThreeVector vgroup = lat->MapKtoVDir(mode, waveVec);
+  return CreatePhonon(track, mode, waveVec, lat->MapKtoVg(mode, waveVec),
+		      energy, time, pos);
+}
+
+// Group velocity (local coordinates) already computed, e.g. in a batch
+
+G4Track* G4CMP::CreatePhonon(const G4Track& track, G4int mode,
+			     const G4ThreeVector& waveVec,
+			     const G4ThreeVector& vgLocal, G4double energy,
+			     G4double time, const G4ThreeVector& pos) {
+  G4ThreeVector vgroup = vgLocal.unit();
   if (std::fabs(vgroup.mag()-1.) > 0.01) {
     G4cerr << "WARNING: vgroup not a unit vector: " << vgroup
      << " length " << vgroup.mag() << G4endl;
@@ -87,7 +100,13 @@ G4Track* G4CMP::CreatePhonon(const G4Track& track, G4int mode,
   // Store wavevector in auxiliary info for track
   AttachTrackInfo(sec, GetGlobalDirection(touch, waveVec));
 
-  sec->SetVelocity(lat->MapKtoV(mode, waveVec));
+  // Phonon from phonon inherits importance, matching its initial weight
+  if (IsPhonon(track) && HasTrackInfo(track)) {
+    GetTrackInfo<G4CMPPhononTrackInfo>(sec)->SetImportance(
+      GetTrackInfo<G4CMPPhononTrackInfo>(track)->Importance());
+  }
+
+  sec->SetVelocity(vgLocal.mag());
   sec->UseGivenVelocity(true);
 
   return sec;
@@ -111,7 +130,8 @@ G4Track* G4CMP::CreatePhonon(const G4VTouchable* touch, G4int mode,
     mode = ChoosePhononPolarization(lat);
   }
 
-  G4ThreeVector vgroup = lat->MapKtoVDir(mode, waveVec);
+  G4ThreeVector vgLocal = lat->MapKtoVg(mode, waveVec);
+  G4ThreeVector vgroup = vgLocal.unit();
   if (std::fabs(vgroup.mag()-1.) > 0.01) {
     G4cerr << "WARNING: vgroup not a unit vector: " << vgroup
      << " length " << vgroup.mag() << G4endl;
@@ -129,7 +149,7 @@ G4Track* G4CMP::CreatePhonon(const G4VTouchable* touch, G4int mode,
   // Store wavevector in auxiliary info for track
   AttachTrackInfo(sec, GetGlobalDirection(touch, waveVec));
 
-  sec->SetVelocity(lat->MapKtoV(mode, waveVec));
+  sec->SetVelocity(vgLocal.mag());
   sec->UseGivenVelocity(true);
 
   return sec;
@@ -20,6 +20,7 @@
 // 20170620 Drop obsolete SetTransforms() call
 // 20170624 Clean up track initialization
 // 20170928 Replace "polarization" with "mode"
+// 20261017 Get phonon speed and direction from one MapKtoVg() lookup
 
 #include "G4CMPStackingAction.hh"
 
@@ -99,7 +100,9 @@ void G4CMPStackingAction::SetPhononVelocity(const G4Track* aTrack) const {
   // Compute direction of propagation from wave vector
   // Geant4 thinks that momentum and velocity point in same direction,
   // momentumDir here actually means velocity direction.
-  G4ThreeVector momentumDir = theLattice->MapKtoVDir(mode, k);
+  // One lookup provides both the direction and the speed
+  G4ThreeVector vgroup = theLattice->MapKtoVg(mode, k);
+  G4ThreeVector momentumDir = vgroup.unit();
 
   if (momentumDir.mag() < 0.9) {
     G4cerr << " track mode " << mode << " k " << k << G4endl;
@@ -109,7 +112,7 @@ void G4CMPStackingAction::SetPhononVelocity(const G4Track* aTrack) const {
   }
 
   //Compute true velocity of propagation
-  G4double velocity = theLattice->MapKtoV(mode, k);
+  G4double velocity = vgroup.mag();
   
   // Cast to non-const pointer so we can adjust non-standard kinematics
   G4Track* theTrack = const_cast<G4Track*>(aTrack);
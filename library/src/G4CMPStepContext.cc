@@ -0,0 +1,161 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file library/src/G4CMPStepContext.cc
+/// \brief Implementation of the G4CMPStepContext class.  Caches per-step
+///	   quantities for the current track, shared by G4CMP processes.
+//
+// $Id$
+//
+// 20261017  New class to share field and kinematics among drift processes
+// 20261017  Use G4ThreadLocalSingleton for per-thread instance
+
+#include "G4CMPStepContext.hh"
+#include "G4CMPDriftTrackInfo.hh"
+#include "G4CMPFieldUtils.hh"
+#include "G4CMPGeometryUtils.hh"
+#include "G4CMPPhononTrackInfo.hh"
+#include "G4CMPTrackUtils.hh"
+#include "G4CMPUtils.hh"
+#include "G4LatticePhysical.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4Track.hh"
+
+
+// Singleton access, one context per worker thread
+
+G4CMPStepContext& G4CMPStepContext::Instance() {
+  static G4ThreadLocalSingleton<G4CMPStepContext> instance;
+  return *(instance.Instance());	// G4TLSing returns pointer
+}
+
+G4CMPStepContext& G4CMPStepContext::Get(const G4Track& track) {
+  G4CMPStepContext& context = Instance();
+  if (!context.IsCurrent(track)) context.Reset(track);
+  return context;
+}
+
+void G4CMPStepContext::Invalidate() {
+  Instance().track = 0;
+}
+
+
+// Constructor sets empty key, so first use always loads track
+
+G4CMPStepContext::G4CMPStepContext()
+  : track(0), trackID(-1), stepNumber(-1), touchable(0), trackEkin(0.),
+    filled(0), lattice(0), kinEnergy(0.), valley(-1) {;}
+
+
+// Any change to track, step, or kinematics requires new values
+
+G4bool G4CMPStepContext::IsCurrent(const G4Track& trk) const {
+  return (track == &trk && trackID == trk.GetTrackID() &&
+	  stepNumber == trk.GetCurrentStepNumber() &&
+	  touchable == trk.GetTouchable() &&
+	  trackEkin == trk.GetKineticEnergy() &&
+	  position == trk.GetPosition() &&
+	  direction == trk.GetMomentumDirection());
+}
+
+void G4CMPStepContext::Reset(const G4Track& trk) {
+  track      = &trk;
+  trackID    = trk.GetTrackID();
+  stepNumber = trk.GetCurrentStepNumber();
+  touchable  = trk.GetTouchable();
+  trackEkin  = trk.GetKineticEnergy();
+  position   = trk.GetPosition();
+  direction  = trk.GetMomentumDirection();
+  filled     = 0;
+}
+
+
+// Fill cached quantities on first request
+
+const G4LatticePhysical* G4CMPStepContext::GetLattice() {
+  if (!Has(kLattice)) {
+    lattice = G4CMP::GetLattice(*track);
+    filled |= kLattice;
+  }
+  return lattice;
+}
+
+const G4ThreeVector& G4CMPStepContext::GetField() {
+  if (!Has(kField)) {
+    field = G4CMP::GetFieldAtPosition(touchable, position);
+    filled |= kField;
+  }
+  return field;
+}
+
+const G4ThreeVector& G4CMPStepContext::GetLocalPosition() {
+  if (!Has(kPosition)) {
+    localPos = G4CMP::GetLocalPosition(touchable, position);
+    filled |= kPosition;
+  }
+  return localPos;
+}
+
+const G4ThreeVector& G4CMPStepContext::GetLocalVelocity() {
+  if (!Has(kVelocity)) {
+    localVel = G4CMP::GetLocalDirection(touchable,
+				track->CalculateVelocity()*direction);
+    filled |= kVelocity;
+  }
+  return localVel;
+}
+
+G4int G4CMPStepContext::GetValleyIndex() {
+  if (!Has(kValley)) {
+    valley = (G4CMP::IsChargeCarrier(*track)
+	      ? G4CMP::GetTrackInfo<G4CMPDriftTrackInfo>(*track)->ValleyIndex()
+	      : -1);
+    filled |= kValley;
+  }
+  return valley;
+}
+
+const G4ThreeVector& G4CMPStepContext::GetLocalMomentum() {
+  if (!Has(kMomentum)) {
+    if (G4CMP::IsElectron(*track)) {
+      localP = GetLattice()->MapV_elToP(GetValleyIndex(), GetLocalVelocity());
+    } else if (G4CMP::IsHole(*track)) {
+      localP = G4CMP::GetLocalDirection(touchable, track->GetMomentum());
+    } else {
+      G4Exception("G4CMPStepContext::GetLocalMomentum", "StepContext001",
+		  EventMustBeAborted, "Unknown charge carrier");
+      localP.set(0.,0.,0.);
+    }
+    filled |= kMomentum;
+  }
+  return localP;
+}
+
+const G4ThreeVector& G4CMPStepContext::GetLocalWaveVector() {
+  if (!Has(kWaveVector)) {
+    if (G4CMP::IsChargeCarrier(*track)) {
+      localK = GetLocalMomentum() / hbarc;
+    } else if (G4CMP::IsPhonon(*track)) {
+      localK = G4CMP::GetTrackInfo<G4CMPPhononTrackInfo>(*track)->k();
+    } else {
+      G4Exception("G4CMPStepContext::GetLocalWaveVector", "StepContext002",
+		  EventMustBeAborted, "Unknown condensed matter particle");
+      localK.set(0.,0.,0.);
+    }
+    filled |= kWaveVector;
+  }
+  return localK;
+}
+
+G4double G4CMPStepContext::GetKineticEnergy() {
+  if (!Has(kEnergy)) {
+    kinEnergy = (G4CMP::IsElectron(*track)
+		 ? GetLattice()->MapV_elToEkin(GetValleyIndex(),
+					       GetLocalVelocity())
+		 : track->GetKineticEnergy());
+    filled |= kEnergy;
+  }
+  return kinEnergy;
+}
@@ -0,0 +1,168 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file library/src/G4CMPTabulatedRate.cc
+/// \brief Implementation of the G4CMPTabulatedRate class.  Interpolates
+///	   scattering rates from tables of the wrapped model.
+//
+// $Id$
+//
+// 20261017  New class, for use with G4CMPVProcess rate models
+
+#include "G4CMPTabulatedRate.hh"
+#include "G4ExceptionSeverity.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Track.hh"
+#include <algorithm>
+#include <cmath>
+
+
+// Constructor and destructor
+
+G4CMPTabulatedRate::G4CMPTabulatedRate(G4CMPVScatteringRate* rateModel,
+				       size_t bins, G4double tol)
+  : G4CMPVScatteringRate(rateModel ? rateModel->GetName() : "Tabulated",
+			 rateModel && rateModel->IsForced()),
+    model(rateModel), nBins(std::max<size_t>(bins, 2)), tolerance(tol),
+    lastKey(0,0), lastTable(0) {
+  if (!model || !model->CanTabulate()) {
+    G4Exception("G4CMPTabulatedRate", "TabRate001", FatalErrorInArgument,
+		"Rate model must be present and support tabulation.");
+  }
+
+  verboseLevel = model ? model->GetVerboseLevel() : verboseLevel;
+}
+
+G4CMPTabulatedRate::~G4CMPTabulatedRate() {
+  delete model;
+}
+
+
+// Keep wrapped model synchronized with current track
+
+void G4CMPTabulatedRate::LoadDataForTrack(const G4Track* track) {
+  G4CMPVScatteringRate::LoadDataForTrack(track);
+  model->SetVerboseLevel(verboseLevel);
+  model->LoadDataForTrack(track);
+}
+
+void G4CMPTabulatedRate::ReleaseTrack() {
+  G4CMPVScatteringRate::ReleaseTrack();
+  model->ReleaseTrack();
+}
+
+
+// Get variable from model, and interpolate in table
+
+G4double G4CMPTabulatedRate::Rate(const G4Track& aTrack) const {
+  G4double x = model->RateVariable(aTrack);
+  if (x < 0.) return 0.;			// Model has no rate here
+
+  G4double rate = Interpolate(x, model->RateChannel(aTrack));
+
+  if (verboseLevel>1) {
+    G4cout << GetName() << " tabulated rate at " << x << " = "
+	   << rate/hertz << " Hz" << G4endl;
+  }
+
+  return rate;
+}
+
+G4double G4CMPTabulatedRate::Interpolate(G4double x, G4int chan) const {
+  const Table& table = GetTable(x, chan);
+  if (!table.valid || !(x <= table.xMax))
+    return model->RateFromVariable(x, chan);
+
+  const size_t nmax = table.rate.size()-2;	// Last bin's lower index
+  G4double u = x*table.invStep;
+  size_t i = std::min(size_t(u), nmax);
+  G4double frac = u - i;
+
+  return table.rate[i] + frac*(table.rate[i+1] - table.rate[i]);
+}
+
+G4double G4CMPTabulatedRate::GetMaxError(G4int chan) const {
+  auto itab = tables.find(TableKey(theLattice, chan));
+  return (itab == tables.end() ? 0. : itab->second.maxError);
+}
+
+
+// Get table for current lattice, filling or extending range as needed
+
+const G4CMPTabulatedRate::Table&
+G4CMPTabulatedRate::GetTable(G4double x, G4int chan) const {
+  // Successive calls are usually for the same lattice and channel
+  TableKey key(theLattice, chan);
+  if (!lastTable || key != lastKey) {
+    lastTable = &tables[key];
+    lastKey = key;
+  }
+
+  Table& table = *lastTable;
+
+  if (table.rate.empty()) {			// New table, use model's range
+    G4double scale = model->RateVariableScale(chan);
+    if (!(scale > 0.)) scale = std::max(x, 1.);
+
+    table.xLimit = 1024.*scale;
+    FillTable(table, scale, chan);
+  }
+
+  if (table.valid && x > table.xMax && x <= table.xLimit) {	// Extend range
+    G4double xMax = table.xMax;
+    while (xMax < x) xMax *= 2.;
+    FillTable(table, std::min(xMax, table.xLimit), chan);
+  }
+
+  return table;
+}
+
+// Tabulate model on uniform grid, adding bins until accuracy is met
+
+void G4CMPTabulatedRate::FillTable(Table& table, G4double xMax,
+				   G4int chan) const {
+  const size_t maxBins = 16*nBins;
+
+  table.xMax = xMax;
+  for (size_t n=nBins; n<=maxBins; n*=2) {
+    const G4double step = xMax/n;
+    table.invStep = 1./step;
+
+    table.rate.resize(n+1);
+    G4double rateMax = 0.;
+    for (size_t i=0; i<=n; i++) {
+      table.rate[i] = model->RateFromVariable(i*step, chan);
+      rateMax = std::max(rateMax, std::fabs(table.rate[i]));
+    }
+
+    // Linear interpolation is worst near middle of each bin
+    G4double errMax = 0.;
+    for (size_t i=0; i<n; i++) {
+      G4double exact = model->RateFromVariable((i+0.5)*step, chan);
+      G4double interp = 0.5*(table.rate[i]+table.rate[i+1]);
+      errMax = std::max(errMax, std::fabs(interp-exact));
+    }
+
+    table.maxError = (rateMax > 0. ? errMax/rateMax : 0.);
+    table.valid = (table.maxError <= tolerance);
+    if (table.valid) break;
+  }
+
+  if (verboseLevel) {
+    G4cout << GetName() << " rate table for channel " << chan << ": "
+	   << table.rate.size()-1 << " bins to " << xMax
+	   << ", max error " << table.maxError << G4endl;
+  }
+
+  if (!table.valid) {
+    G4ExceptionDescription msg;
+    msg << GetName() << " rate table deviates from model by "
+	<< table.maxError << " (tolerance " << tolerance << ").\n"
+	<< "Model will be used directly.";
+    G4Exception("G4CMPTabulatedRate::FillTable", "TabRate002",
+		JustWarning, msg);
+    table.rate.resize(2);			// Keep table marked as filled
+  }
+}
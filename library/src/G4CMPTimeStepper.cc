@@ -39,14 +39,15 @@
 //		be delta(E)/(q*V).
 // 20220730  Drop trapping processes, as they have built-in MFPs, and don't
 //		need TimeStepper for energy-dependent calculation.
+// 20261017  Get field from G4CMPStepContext, to look up only once per step
 
 #include "G4CMPTimeStepper.hh"
 #include "G4CMPConfigManager.hh"
 #include "G4CMPDriftElectron.hh"
 #include "G4CMPDriftHole.hh"
 #include "G4CMPDriftTrackInfo.hh"
-#include "G4CMPFieldUtils.hh"
 #include "G4CMPGeometryUtils.hh"
+#include "G4CMPStepContext.hh"
 #include "G4CMPTrackUtils.hh"
 #include "G4CMPUtils.hh"
 #include "G4CMPVProcess.hh"
@@ -119,7 +120,7 @@ G4double G4CMPTimeStepper::GetMeanFreePath(const G4Track& aTrack, G4double,
   *cond = NotForced;
 
   // SPECIAL:  If no electric field, no need to limit steps
-  if (G4CMP::GetFieldAtPosition(aTrack).mag() <= 0.) return DBL_MAX;
+  if (G4CMPStepContext::Get(aTrack).GetField().mag() <= 0.) return DBL_MAX;
 
   // Evaluate different step lengths to avoid overrunning process thresholds
   G4double vtrk = GetVelocity(aTrack);
@@ -210,7 +211,7 @@ G4double G4CMPTimeStepper::EnergyStep(G4double Estart, G4double Efinal) const {
 
   const G4Track* trk = GetCurrentTrack();
 
-  G4double EMmag = G4CMP::GetFieldAtPosition(*trk).mag();
+  G4double EMmag = G4CMPStepContext::Get(trk).GetField().mag();
   if (EMmag <= 0.) return DBL_MAX;		// No field, no acceleration
 
   if (verboseLevel>1) {
@@ -13,6 +13,7 @@
 // 20190906 M. Kelsey -- Add function to look up process for track
 // 20200829 M. Kelsey -- Don't override initial direction of phonons
 // 20220907 G4CMP-316 -- Try using pre-step point to find lattice volume
+// 20261017 Fetch G4LatticeManager once in GetLattice()
 
 #include "G4CMPTrackUtils.hh"
 #include "G4CMPConfigManager.hh"
@@ -116,12 +117,12 @@ G4LatticePhysical* G4CMP::GetLattice(const G4Track& track) {
   G4VPhysicalVolume* trkvol = track.GetVolume();
   if (!trkvol) trkvol = G4CMP::GetVolumeAtPoint(track.GetPosition());
 
-  if (!G4LatticeManager::GetLatticeManager()->HasLattice(trkvol)
-      && track.GetStep()) {
+  const G4LatticeManager* latMan = G4LatticeManager::GetLatticeManager();
+  if (!latMan->HasLattice(trkvol) && track.GetStep()) {
     trkvol = track.GetStep()->GetPreStepPoint()->GetPhysicalVolume();
   }
 
-  return G4LatticeManager::GetLatticeManager()->GetLattice(trkvol);
+  return latMan->GetLattice(trkvol);
 }
 
 
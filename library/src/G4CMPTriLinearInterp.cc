@@ -24,17 +24,45 @@
 // 20200914  Include TExtend precalculation in FillTInverse action,
 //		gradient (field) precalc in UseMesh functions.
 // 20201002  Report tetrahedra errors during FillTInverse() initialization.
+// 20261017  Add uniform-grid index of tetrahedra to seed FindTetrahedron(),
+//		built at end of FillTInverse(); see $G4CMP_MESH_INDEX.
+// 20261017  Add binary cache file of mesh tables, read back with mmap().
+// 20261017  Tables held in shared MeshTables block, so that Clone() copies
+//		don't duplicate the mesh; UseValues() copies before writing.
+// 20261017  Unroll Cart2Bary() rows, computing vertex offset only once.
+//		Add GetValuesAndGrads(), single search for both quantities.
+// 20261017  Keep inverse matrix, origin, gradient, neighbors in one record
+//		per tetrahedron; TExtend computed on the fly for gradients.
+// 20261017  Add GetValueAndGrad() reporting hull failures, GetBoundingBox().
+// 20261017  Match neighbor facets within per-vertex buckets, replacing the
+//		four sorted Tetra0xx lists; run buckets and FillTInverse()
+//		matrix inversions on all available cores.
+// 20261017  Origin and gradients kept in double precision with
+//		G4CMP_MESH_FLOAT; facet tolerance scaled to MeshReal epsilon.
+// 20261017  Use G4CMP cache header and WriteCacheFile() for mesh cache.
+// 20261017  Read cache file directly into tables, replacing mmap() image
+//		which was copied and discarded.
+// 20261017  GetValuesAndGrads() interpolates blocks of points from
+//		structure-of-arrays copies, after per-point searches.
 
 #include "G4CMPTriLinearInterp.hh"
 #include "G4CMPConfigManager.hh"
+#include "G4CMPUtils.hh"
+#include "G4Threading.hh"
 #include "libqhullcpp/Qhull.h"
 #include "libqhullcpp/QhullFacetList.h"
 #include "libqhullcpp/QhullFacetSet.h"
 #include "libqhullcpp/QhullVertexSet.h"
 #include <algorithm>
+#include <cmath>
 #include <ctime>
 #include <fstream>
 #include <iostream>
+#include <limits>
+#include <functional>
+#include <thread>
+#include <float.h>
+#include <string.h>
 
 using namespace orgQhull;
 using std::array;
@@ -43,6 +71,12 @@ using std::sort;
 using std::vector;
 
 
+// Float records round barycentric coordinates near 1e-7, not 1e-16
+
+const G4double G4CMPTriLinearInterp::barySafety =
+  -std::max(1e-10, 1e3*std::numeric_limits<MeshReal>::epsilon());
+
+
 // Constructors to load mesh and possibly re-triangulate
 
 G4CMPTriLinearInterp::G4CMPTriLinearInterp(const vector<point3d>& xyz,
@@ -57,21 +91,7 @@ G4CMPTriLinearInterp(const vector<point3d>& xyz, const vector<G4double>& v,
 // Copy constructor used by Clone() function
 
 G4CMPTriLinearInterp::G4CMPTriLinearInterp(const G4CMPTriLinearInterp& rhs)
-  : G4CMPTriLinearInterp() {
-  X = rhs.X;
-  V = rhs.V;
-  Grad = rhs.Grad;
-  Tetrahedra = rhs.Tetrahedra;
-  Neighbors = rhs.Neighbors;
-  TInverse = rhs.TInverse;
-  TInvGood = rhs.TInvGood;
-  TExtend  = rhs.TExtend;
-
-  Tetra012 = rhs.Tetra012;	// Not really needed, but for completeness
-  Tetra013 = rhs.Tetra013;
-  Tetra023 = rhs.Tetra023;
-  Tetra123 = rhs.Tetra123;
-
+  : G4CMPVMeshInterpolator(rhs), Mesh(rhs.Mesh) {	// Tables are shared
   TetraIdx = -1;
   TetraStart = rhs.TetraStart;
 }
@@ -81,8 +101,9 @@ G4CMPTriLinearInterp::G4CMPTriLinearInterp(const G4CMPTriLinearInterp& rhs)
 
 void G4CMPTriLinearInterp::UseMesh(const vector<point3d> &xyz,
 				   const vector<G4double>& v) {
-  X = xyz;
-  V = v;
+  Mesh = std::make_shared<MeshTables>();	// Don't modify shared tables
+  Mesh->X = xyz;
+  Mesh->V = v;
   BuildTetraMesh();
   FillTInverse();
   FillGradients();
@@ -99,9 +120,10 @@ void G4CMPTriLinearInterp::UseMesh(const vector<point3d> &xyz,
 void G4CMPTriLinearInterp::UseMesh(const vector<point3d>& xyz,
 				   const vector<G4double>& v,
 				   const vector<tetra3d>& tetra) {
-  X = xyz;
-  V = v;
-  Tetrahedra = tetra;
+  Mesh = std::make_shared<MeshTables>();	// Don't modify shared tables
+  Mesh->X = xyz;
+  Mesh->V = v;
+  Mesh->Tetrahedra = tetra;
   FillNeighbors();
   FillTInverse();
   FillGradients();
@@ -116,9 +138,26 @@ void G4CMPTriLinearInterp::UseMesh(const vector<point3d>& xyz,
 }
 
 
+// Replace values at mesh points, making private copy of tables if shared
+
+void G4CMPTriLinearInterp::UseValues(const vector<G4double>& v) {
+  if (!CheckValues(v, Mesh->V.size())) return;
+
+  if (Mesh.use_count() > 1) Mesh = std::make_shared<MeshTables>(*Mesh);
+
+  Mesh->V = v;
+  FillGradients();
+
+#ifdef G4CMPTLI_DEBUG
+  SavePoints(savePrefix+"_points.dat");
+#endif
+}
+
+
 // Generate new Delaunay triagulation for current mesh of points
 
 void G4CMPTriLinearInterp::BuildTetraMesh() {
+  MeshTables& mesh = *Mesh;		// For convenience below
   time_t start, fin;
   G4cout << "G4CMPTriLinearInterp::Constructor: Creating Tetrahedral Mesh..."
          << G4endl;
@@ -126,12 +165,12 @@ void G4CMPTriLinearInterp::BuildTetraMesh() {
   /* Qhull requires a column-major array of the
    * 3D points. i.e., [x1,y1,z1,x2,y2,z2,...]
    */
-  G4double* boxPoints = new G4double[3*X.size()];
+  G4double* boxPoints = new G4double[3*mesh.X.size()];
       
-  for (size_t i=0, e=X.size(); i<e; ++i) {
-    boxPoints[i*3] = X[i][0];
-    boxPoints[i*3+1]= X[i][1];
-    boxPoints[i*3+2]= X[i][2];
+  for (size_t i=0, e=mesh.X.size(); i<e; ++i) {
+    boxPoints[i*3] = mesh.X[i][0];
+    boxPoints[i*3+1]= mesh.X[i][1];
+    boxPoints[i*3+2]= mesh.X[i][2];
   }
     
   /* Run Qhull
@@ -145,7 +184,7 @@ void G4CMPTriLinearInterp::BuildTetraMesh() {
    *   Qbb = Scales the paraboloid that Qhull creates. This helps with precision
    *   Qz = Add a point at infinity. This somehow helps with precision...
    */
-  Qhull hull = Qhull("", 3, X.size(), boxPoints, "d Qt Qz Qbb");
+  Qhull hull = Qhull("", 3, mesh.X.size(), boxPoints, "d Qt Qz Qbb");
         
   QhullFacet facet, neighbor;
   QhullVertex vertex;
@@ -183,10 +222,11 @@ void G4CMPTriLinearInterp::BuildTetraMesh() {
     }
 
   tmpTetrahedra.resize(numTet);
-  tmpNeighbors.resize(numTet);
+  mesh.Tetrahedra.swap(tmpTetrahedra);
 
-  Tetrahedra.swap(tmpTetrahedra);
-  Neighbors.swap(tmpNeighbors);
+  mesh.Records.resize(numTet);
+  for (G4int i = 0; i < numTet; ++i)
+    mesh.Records[i].Neighbors = tmpNeighbors[i];
 
   delete[] boxPoints;
 
@@ -199,6 +239,7 @@ void G4CMPTriLinearInterp::BuildTetraMesh() {
 
 G4int G4CMPTriLinearInterp::FindPointID(const vector<G4double>& pt,
                                         const G4int id) const {
+  const vector<point3d>& X = Mesh->X;	// For convenience below
   if (qhull2x.count(id)) {
     return qhull2x[id];
   }
@@ -236,166 +277,277 @@ G4int G4CMPTriLinearInterp::FindPointID(const vector<G4double>& pt,
 }
 
 
-// Tetrahedra sort functions, labelled for each facet option
+// Mesh construction steps are independent for each tetrahedron or vertex
 
 namespace {
-  G4bool tLess012(const tetra3d& a, const tetra3d& b) {
-    return ( a[0]<b[0] ||
-	     (a[0]==b[0] && (a[1]<b[1] ||
-			     (a[1]==b[1] && a[2]<b[2]))) );
-  }
-  
-  G4bool tLess013(const tetra3d& a, const tetra3d& b) {
-    return ( a[0]<b[0] ||
-	     (a[0]==b[0] && (a[1]<b[1] ||
-			     (a[1]==b[1] && a[3]<b[3]))) );
-  }
-  
-  G4bool tLess023(const tetra3d& a, const tetra3d& b) {
-    return ( a[0]<b[0] ||
-	     (a[0]==b[0] && (a[2]<b[2] ||
-			     (a[2]==b[2] && a[3]<b[3]))) );
-  }
-  
-  G4bool tLess123(const tetra3d& a, const tetra3d& b) {
-    return ( a[1]<b[1] ||
-	     (a[1]==b[1] && (a[2]<b[2] ||
-			     (a[2]==b[2] && a[3]<b[3]))) );
+  // Call body(begin,end) on blocks of index range, using all available cores
+  void ParallelFor(size_t n, const std::function<void(size_t,size_t)>& body) {
+    const size_t minBlock = 10000;	// Not worth starting threads for less
+
+    size_t nthread = std::max(1, G4Threading::G4GetNumberOfCores());
+    nthread = std::min(nthread, (n+minBlock-1)/minBlock);
+    if (nthread <= 1) {
+      body(0, n);
+      return;
+    }
+
+    size_t block = (n+nthread-1)/nthread;
+    vector<std::thread> workers;
+    for (size_t ithr=1; ithr<nthread; ithr++) {
+      workers.emplace_back(body, std::min(n,ithr*block),
+			   std::min(n,(ithr+1)*block));
+    }
+
+    body(0, block);
+    for (auto& worker: workers) worker.join();
   }
+
+  // Facet of tetrahedron, identified by its upper two (sorted) vertices;
+  // lowest vertex is implied by location in list
+  struct Facet {
+    G4int v1, v2;
+    G4int slot;			// Tetrahedron index * 4 + opposite vertex
+
+    G4bool operator<(const Facet& rhs) const {
+      return (v1<rhs.v1 || (v1==rhs.v1 && v2<rhs.v2));
+    }
+  };
 }
 
 // Process list of defined tetrahedra and build table of neighbors
 
 void G4CMPTriLinearInterp::FillNeighbors() {
-  G4cout << "G4CMPTriLinearInterp::FillNeighbors (" << Tetrahedra.size()
+  MeshTables& mesh = *Mesh;		// For convenience below
+  G4cout << "G4CMPTriLinearInterp::FillNeighbors (" << mesh.Tetrahedra.size()
 	 << " tetrahedra)" << G4endl;
 
   time_t start, fin;
   std::time(&start);
 
   // Put the tetrahedra vertices, then the whole list, in indexed order
-  for (auto& iTetra: Tetrahedra) sort(iTetra.begin(), iTetra.end());
-  sort(Tetrahedra.begin(), Tetrahedra.end());
+  for (auto& iTetra: mesh.Tetrahedra) sort(iTetra.begin(), iTetra.end());
+  sort(mesh.Tetrahedra.begin(), mesh.Tetrahedra.end());
+
+  G4int Ntet = mesh.Tetrahedra.size();		// For convenience below
+  size_t Npts = mesh.X.size();
 
-  // Duplicate list sorted on facets (triplets of vertices)
-  Tetra012 = Tetrahedra; sort(Tetra012.begin(), Tetra012.end(), tLess012);
-  Tetra013 = Tetrahedra; sort(Tetra013.begin(), Tetra013.end(), tLess013);
-  Tetra023 = Tetrahedra; sort(Tetra023.begin(), Tetra023.end(), tLess023);
-  Tetra123 = Tetrahedra; sort(Tetra123.begin(), Tetra123.end(), tLess123);
+  mesh.Records.clear();
+  mesh.Records.resize(Ntet);		// Pre-allocate space
 
-  G4int Ntet = Tetrahedra.size();		// For convenience below
+  // Bucket all facets by lowest vertex (counting sort), so that matching
+  // facets need only be sorted and compared within small groups
+  vector<size_t> first(Npts+1, 0);
+  for (const tetra3d& iTet: mesh.Tetrahedra) {
+    first[iTet[1]+1]++;		// Facet opposite vertex 0
+    first[iTet[0]+1] += 3;	// Other three facets all include vertex 0
+  }
 
-  Neighbors.clear();
-  Neighbors.resize(Ntet, {{-1,-1,-1,-1}});	// Pre-allocate space
+  for (size_t ipt=0; ipt<Npts; ipt++) first[ipt+1] += first[ipt];
 
-  // For each tetrahedron, find another which shares three corners
+  vector<Facet> facets(first[Npts]);
+  vector<size_t> fill(first.begin(), first.end()-1);
   for (G4int i=0; i<Ntet; i++) {
-    const auto& iTet = Tetrahedra[i];
-    Neighbors[i][0] = FindNeighbor({{iTet[1],iTet[2],iTet[3]}}, i);
-    Neighbors[i][1] = FindNeighbor({{iTet[0],iTet[2],iTet[3]}}, i);
-    Neighbors[i][2] = FindNeighbor({{iTet[0],iTet[1],iTet[3]}}, i);
-    Neighbors[i][3] = FindNeighbor({{iTet[0],iTet[1],iTet[2]}}, i);
+    const tetra3d& iTet = mesh.Tetrahedra[i];
+    facets[fill[iTet[1]]++] = { iTet[2], iTet[3], 4*i+0 };
+    facets[fill[iTet[0]]++] = { iTet[2], iTet[3], 4*i+1 };
+    facets[fill[iTet[0]]++] = { iTet[1], iTet[3], 4*i+2 };
+    facets[fill[iTet[0]]++] = { iTet[1], iTet[2], 4*i+3 };
   }
 
+  // Tetrahedra sharing a facet are adjacent after sorting; each facet slot
+  // is written by only one bucket, so buckets may be processed in parallel
+  ParallelFor(Npts, [&](size_t begin, size_t end) {
+    for (size_t ipt=begin; ipt<end; ipt++) {
+      auto bFirst = facets.begin()+first[ipt];
+      auto bLast  = facets.begin()+first[ipt+1];
+      sort(bFirst, bLast);
+
+      for (auto iFacet = bFirst; iFacet != bLast; ++iFacet) {
+	G4int nbr = -1;		// Facet on hull has no neighbor
+	if (iFacet != bFirst && !(*(iFacet-1) < *iFacet))
+	  nbr = (iFacet-1)->slot/4;
+	else if (iFacet+1 != bLast && !(*iFacet < *(iFacet+1)))
+	  nbr = (iFacet+1)->slot/4;
+
+	mesh.Records[iFacet->slot/4].Neighbors[iFacet->slot%4] = nbr;
+      }
+    }
+  });
+
   std::time(&fin);
   G4cout << "G4CMPTriLinearInterp::FillNeighbors: Took "
-         << difftime(fin, start) << " seconds for " << Neighbors.size()
+         << difftime(fin, start) << " seconds for " << mesh.Records.size()
 	 << " entries." << G4endl;
 
 }
 
-// Locate other tetrahedron with specified face (excluding "skip" tetrahedron)
 
-G4int G4CMPTriLinearInterp::FindNeighbor(const array<G4int,3>& facet,
-					G4int skip) const {
-  G4int result = -1;
-  result = FindTetraID(Tetra123, {{-1,facet[0],facet[1],facet[2]}}, skip, tLess123);
-  if (result >= 0) return result;	// Successful match
+// Compute matrices used in tetrahedral barycentric coordinate calculation
 
-  result = FindTetraID(Tetra023, {{facet[0],-1,facet[1],facet[2]}}, skip, tLess023);
-  if (result >= 0) return result;	// Successful match
+void G4CMPTriLinearInterp::FillTInverse() {
+  MeshTables& mesh = *Mesh;		// For convenience below
+#ifdef G4CMPTLI_DEBUG
+  G4cout << "G4CMPTriLinearInterp::FillTInverse (" << mesh.Tetrahedra.size()
+	 << " tetrahedra)" << G4endl;
 
-  result = FindTetraID(Tetra013, {{facet[0],facet[1],-1,facet[2]}}, skip, tLess013);
-  if (result >= 0) return result;	// Successful match
+  time_t start, fin;
+  std::time(&start);
+#endif
 
-  result = FindTetraID(Tetra012, {{facet[0],facet[1],facet[2],-1}}, skip, tLess012);
-  return result;			// If this one failed, they all failed
-}
+  size_t ntet = mesh.Tetrahedra.size();
+  mesh.Records.resize(ntet);		    // Avoid reallocation inside loop
 
-// Locate other tetrahedron with given vertices (excluding "skip" tetrahedron)
-// "Wild" means that at least one vertex may be "-1", which matches anything
+  // Inversions are independent; errors are collected for reporting below
+  ParallelFor(ntet, [&](size_t begin, size_t end) {
+    mat3x3 T, invT;
+    for (size_t itet=begin; itet<end; itet++) {
+      const tetra3d& tetra = mesh.Tetrahedra[itet];	// For convenience below
 
-G4int G4CMPTriLinearInterp::
-FindTetraID(const vector<tetra3d>& tetras, const tetra3d& wildTetra, G4int skip,
-	    G4CMPTriLinearInterp::TetraComp tLess) const {
-  const auto start  = tetras.begin();
-  const auto finish = tetras.end();
+      for (G4int dim=0; dim<3; ++dim) {
+	for (G4int vert=0; vert<3; ++vert) {
+	  T[dim][vert] = (mesh.X[tetra[vert]][dim] - mesh.X[tetra[3]][dim]);
+	}
+      }
 
-  // Shared facet (if any) will always be adjacent in sorted table
-  auto match = lower_bound(start, finish, wildTetra, tLess);
-  if (match == finish) return -1;		// No match at all? PROBLEM!
+      TetraRecord& rec = mesh.Records[itet];
+      rec.TInvGood = MatInv(T, invT, true);
+      for (G4int dim=0; dim<3; ++dim) {
+	for (G4int vert=0; vert<3; ++vert) {
+	  rec.TInverse[dim][vert] = invT[dim][vert];
+	}
+	rec.Origin[dim] = mesh.X[tetra[3]][dim];
+      }
+    }	// for (itet...
+  });
 
-  G4int index = (lower_bound(Tetrahedra.begin(),Tetrahedra.end(),*match)
-		 - Tetrahedra.begin());
-  if (index == skip) {				// Move to adjacent entry
-    if (match == finish-1) return -1;		// Nothing left to search
+  for (size_t itet=0; itet<ntet; itet++) {
+    if (mesh.Records[itet].TInvGood) continue;
 
-    index = (lower_bound(Tetrahedra.begin(),Tetrahedra.end(),*(++match))
-	     - Tetrahedra.begin());
+    const tetra3d& tetra = mesh.Tetrahedra[itet];	// For convenience below
+    G4cerr << "ERROR: Non-invertible matrix " << itet << " with " << G4endl;
+    for (G4int i=0; i<4; i++) {
+      G4cerr << " " << tetra[i] << " @ " << mesh.X[tetra[i]] << G4endl;
+    }
   }
 
-  // Test for equality (not < nor >), return index or failure
-  return (!tLess(*match,wildTetra) && !tLess(wildTetra,*match)) ? index : -1;
+  FillGridIndex();		// Needs TInvGood to select usable tetrahedra
+
+#ifdef G4CMPTLI_DEBUG
+  std::time(&fin);
+  G4cout << "G4CMPTriLinearInterp::FillTInverse: Took "
+         << difftime(fin, start) << " seconds for " << mesh.Records.size()
+	 << " entries." << G4endl;
+#endif
 }
 
 
-// Compute matrices used in tetrahedral barycentric coordinate calculation
+// Overlay uniform grid on mesh, storing tetrahedron closest to each cell
 
-void G4CMPTriLinearInterp::FillTInverse() {
-#ifdef G4CMPTLI_DEBUG
-  G4cout << "G4CMPTriLinearInterp::FillTInverse (" << Tetrahedra.size()
-	 << " tetrahedra)" << G4endl;
+void G4CMPTriLinearInterp::FillGridIndex() {
+  MeshTables& mesh = *Mesh;		// For convenience below
+  mesh.GridTetra.clear();
+  if (!G4CMPConfigManager::UseMeshIndex() || mesh.Tetrahedra.empty()) return;
 
-  time_t start, fin;
-  std::time(&start);
-#endif
+  const G4double tetraPerCell = 4.;	// Average occupancy of grid cells
+  const G4int maxDim = 1024;		// Limit memory use for skinny meshes
 
-  size_t ntet = Tetrahedra.size();
-  TInverse.resize(ntet);		    // Avoid reallocation inside loop
-  TExtend.resize(ntet);
-  TInvGood.resize(ntet, false);
+  // Bounding box of mesh points
+  point3d xmax = mesh.X[0];
+  mesh.GridMin = mesh.X[0];
+  for (const point3d& pt: mesh.X) {
+    for (G4int dim=0; dim<3; dim++) {
+      mesh.GridMin[dim] = std::min(mesh.GridMin[dim], pt[dim]);
+      xmax[dim] = std::max(xmax[dim], pt[dim]);
+    }
+  }
 
-  mat3x3 T;
-  for (size_t itet=0; itet<ntet; itet++) {
-    const tetra3d& tetra = Tetrahedra[itet];	// For convenience below
-#ifdef G4CMPTLI_DEBUG
-    if (G4CMPConfigManager::GetVerboseLevel() > 1) {
-      G4cout << " Processing Tetrahedra[" << itet << "]: " << tetra << G4endl;
+  // Cell size chosen for fixed number of tetrahedra per cell; flat mesh
+  // axes (e.g., all points with same Z) are given a single cell
+  G4double volume = 1.;
+  G4int ndim = 0;
+  for (G4int dim=0; dim<3; dim++) {
+    if (xmax[dim] > mesh.GridMin[dim]) {
+      volume *= xmax[dim] - mesh.GridMin[dim];
+      ndim++;
     }
-#endif
+  }
 
-    for (G4int dim=0; dim<3; ++dim) {
-      for (G4int vert=0; vert<3; ++vert) {
-	T[dim][vert] = (X[tetra[vert]][dim] - X[tetra[3]][dim]);
-      }
+  if (ndim == 0) return;		// Degenerate mesh, nothing to index
+
+  G4double ncell = std::max(1., mesh.Tetrahedra.size()/tetraPerCell);
+  G4double step = std::pow(volume/ncell, 1./ndim);
+
+  for (G4int dim=0; dim<3; dim++) {
+    G4double extent = xmax[dim] - mesh.GridMin[dim];
+    mesh.GridDim[dim] = std::min(maxDim,
+				 std::max(1, (G4int)std::ceil(extent/step)));
+    mesh.GridInvStep[dim] = extent>0. ? mesh.GridDim[dim]/extent : 0.;
+  }
+
+  size_t ngrid = mesh.GridDim[0]*mesh.GridDim[1]*mesh.GridDim[2];
+  mesh.GridTetra.resize(ngrid, -1);
+  std::vector<G4double> bestDist(ngrid, DBL_MAX);
+
+  // Assign tetrahedron with centroid nearest to center of each cell
+  G4double cell[3];
+  for (size_t itet=0; itet<mesh.Tetrahedra.size(); itet++) {
+    if (!mesh.Records[itet].TInvGood) continue;	// Can't use for searching
+
+    const tetra3d& tetra = mesh.Tetrahedra[itet];
+    G4double dist2 = 0.;
+    for (G4int dim=0; dim<3; dim++) {
+      G4double ctr = 0.25*(mesh.X[tetra[0]][dim] + mesh.X[tetra[1]][dim] +
+			   mesh.X[tetra[2]][dim] + mesh.X[tetra[3]][dim]);
+      G4double u = (ctr-mesh.GridMin[dim])*mesh.GridInvStep[dim];
+      cell[dim] = std::min(std::floor(u), mesh.GridDim[dim]-1.);
+      dist2 += (u-cell[dim]-0.5)*(u-cell[dim]-0.5);
+    }
+
+    size_t igrid = (((G4int)cell[0]*mesh.GridDim[1] + (G4int)cell[1])
+		    * mesh.GridDim[2] + (G4int)cell[2]);
+    if (dist2 < bestDist[igrid]) {
+      bestDist[igrid] = dist2;
+      mesh.GridTetra[igrid] = itet;
     }
+  }
+
+  // Empty cells (outside hull, or large tetrahedra) take adjacent entries
+  std::vector<size_t> fill;
+  fill.reserve(ngrid);
+  for (size_t igrid=0; igrid<ngrid; igrid++) {
+    if (mesh.GridTetra[igrid] >= 0) fill.push_back(igrid);
+  }
+
+  if (fill.empty()) {			// No usable tetrahedra at all
+    mesh.GridTetra.clear();
+    return;
+  }
+
+  const G4int stride[3] = { mesh.GridDim[1]*mesh.GridDim[2],
+			    mesh.GridDim[2], 1 };
+  for (size_t next=0; next<fill.size(); next++) {
+    size_t igrid = fill[next];
+    G4int ijk[3] = { G4int(igrid/stride[0]),
+		     G4int(igrid/stride[1])%mesh.GridDim[1],
+		     G4int(igrid%mesh.GridDim[2]) };
+
+    for (G4int dim=0; dim<3; dim++) {
+      for (G4int dir=-1; dir<=1; dir+=2) {
+	G4int adj = ijk[dim]+dir;
+	if (adj < 0 || adj >= mesh.GridDim[dim]) continue;
 
-    TInvGood[itet] = MatInv(T, TInverse[itet], true);
-    BuildT4x3(itet, TExtend[itet]);
+	size_t jgrid = igrid + dir*stride[dim];
+	if (mesh.GridTetra[jgrid] >= 0) continue;
 
-    if (!TInvGood[itet]) {
-      G4cerr << "ERROR: Non-invertible matrix " << itet << " with " << G4endl;
-      for (G4int i=0; i<4; i++) {
-	G4cerr << " " << tetra[i] << " @ " << X[tetra[i]] << G4endl;
+	mesh.GridTetra[jgrid] = mesh.GridTetra[igrid];
+	fill.push_back(jgrid);
       }
     }
-  }	// for (itet...
+  }
 
 #ifdef G4CMPTLI_DEBUG
-  std::time(&fin);
-  G4cout << "G4CMPTriLinearInterp::FillTInverse: Took "
-         << difftime(fin, start) << " seconds for " << TInverse.size()
-	 << " entries." << G4endl;
+  G4cout << "G4CMPTriLinearInterp::FillGridIndex: " << mesh.GridDim[0] << " x "
+	 << mesh.GridDim[1] << " x " << mesh.GridDim[2] << " cells" << G4endl;
 #endif
 }
 
@@ -403,31 +555,33 @@ void G4CMPTriLinearInterp::FillTInverse() {
 // Compute field (gradient) across each tetrahedron
 
 void G4CMPTriLinearInterp::FillGradients() {
+  MeshTables& mesh = *Mesh;		// For convenience below
 #ifdef G4CMPTLI_DEBUG
-  G4cout << "G4CMPTriLinearInterp::FillGradients (" << Tetrahedra.size()
+  G4cout << "G4CMPTriLinearInterp::FillGradients (" << mesh.Tetrahedra.size()
 	 << " tetrahedra)" << G4endl;
 
   time_t start, fin;
   std::time(&start);
 #endif
 
-  size_t ntet = Tetrahedra.size();
-  Grad.resize(ntet);		    // Avoid reallocation inside loop
+  size_t ntet = mesh.Tetrahedra.size();
+  const vector<G4double>& V = mesh.V;
 
+  mat4x3 ET;
   for (size_t itet=0; itet<ntet; itet++) {
-    const tetra3d& tetra = Tetrahedra[itet];  // For convenience below
-    const mat4x3& ET = TExtend[itet];
-
-    Grad[itet].set((V[tetra[0]]*ET[0][0] + V[tetra[1]]*ET[1][0] +
-		    V[tetra[2]]*ET[2][0] + V[tetra[3]]*ET[3][0]),
-		   (V[tetra[0]]*ET[0][1] + V[tetra[1]]*ET[1][1] +
-		    V[tetra[2]]*ET[2][1] + V[tetra[3]]*ET[3][1]),
-		   (V[tetra[0]]*ET[0][2] + V[tetra[1]]*ET[1][2] +
-		    V[tetra[2]]*ET[2][2] + V[tetra[3]]*ET[3][2])
-		   );
+    const tetra3d& tetra = mesh.Tetrahedra[itet];  // For convenience below
+    BuildT4x3(itet, ET);
+
+    for (G4int dim=0; dim<3; dim++) {
+      mesh.Records[itet].Grad[dim] = (V[tetra[0]]*ET[0][dim] +
+				      V[tetra[1]]*ET[1][dim] +
+				      V[tetra[2]]*ET[2][dim] +
+				      V[tetra[3]]*ET[3][dim]);
+    }
 #ifdef G4CMPTLI_DEBUG
     if (G4CMPConfigManager::GetVerboseLevel() > 1) {
-      G4cout << " Computed Grad[" << itet << "]: " << Grad[itet] << G4endl;
+      G4cout << " Computed Grad[" << itet << "]: "
+	     << mesh.Records[itet].Grad << G4endl;
     }
 #endif
   }	// for (itet...
@@ -435,7 +589,7 @@ void G4CMPTriLinearInterp::FillGradients() {
 #ifdef G4CMPTLI_DEBUG
   std::time(&fin);
   G4cout << "G4CMPTriLinearInterp::FillGradients: Took "
-         << difftime(fin, start) << " seconds for " << Grad.size()
+         << difftime(fin, start) << " seconds for " << ntet
 	 << " entries." << G4endl;
 #endif
 }
@@ -444,38 +598,162 @@ void G4CMPTriLinearInterp::FillGradients() {
 // Return index of tetrahedron with all facets shared, to start FindTetra()
 
 G4int G4CMPTriLinearInterp::FirstInteriorTetra() {
-  G4int minIndex = Neighbors.size()/4;
+  MeshTables& mesh = *Mesh;		// For convenience below
+  G4int minIndex = mesh.Records.size()/4;
 
-  for (G4int i=0; i<(G4int)Neighbors.size(); i++) {
-    if (*std::min_element(Neighbors[i].begin(), Neighbors[i].end())>minIndex)
+  for (G4int i=0; i<(G4int)mesh.Records.size(); i++) {
+    const tetra3d& iNbr = mesh.Records[i].Neighbors;
+    if (*std::min_element(iNbr.begin(), iNbr.end()) > minIndex)
       return i;
   }
 
-  return Neighbors.size()/2;
+  return mesh.Records.size()/2;
+}
+
+// Return tetrahedron registered near point, or -1 if outside of grid
+
+G4int G4CMPTriLinearInterp::GridStartTetra(const G4double pt[3]) const {
+  const MeshTables& mesh = *Mesh;	// For convenience below
+  if (mesh.GridTetra.empty()) return -1;
+
+  G4int cell[3];
+  for (G4int dim=0; dim<3; dim++) {
+    G4double u = (pt[dim]-mesh.GridMin[dim])*mesh.GridInvStep[dim];
+    if (!(u >= 0. && u <= mesh.GridDim[dim])) return -1;	// Also catches NaN
+
+    cell[dim] = std::min((G4int)u, mesh.GridDim[dim]-1);
+  }
+
+  return mesh.GridTetra[(cell[0]*mesh.GridDim[1] + cell[1])*mesh.GridDim[2]
+			+ cell[2]];
 }
 
 // Evaluate mesh at arbitrary location, returning potential or gradient
 
 G4double 
 G4CMPTriLinearInterp::GetValue(const G4double pos[3], G4bool quiet) const {
+  const MeshTables& mesh = *Mesh;	// For convenience below
   G4double bary[4] = { 0. };
   FindTetrahedron(&pos[0], bary, quiet);
     
   if (TetraIdx == -1) return 0;
 
-  return(V[Tetrahedra[TetraIdx][0]] * bary[0] +
-	 V[Tetrahedra[TetraIdx][1]] * bary[1] +
-	 V[Tetrahedra[TetraIdx][2]] * bary[2] +
-	 V[Tetrahedra[TetraIdx][3]] * bary[3]);    
+  return(mesh.V[mesh.Tetrahedra[TetraIdx][0]] * bary[0] +
+	 mesh.V[mesh.Tetrahedra[TetraIdx][1]] * bary[1] +
+	 mesh.V[mesh.Tetrahedra[TetraIdx][2]] * bary[2] +
+	 mesh.V[mesh.Tetrahedra[TetraIdx][3]] * bary[3]);    
 }
 
 G4ThreeVector 
 G4CMPTriLinearInterp::GetGrad(const G4double pos[3], G4bool quiet) const {
+  const MeshTables& mesh = *Mesh;	// For convenience below
   static const G4ThreeVector zero(0.,0.,0.);	// For failure returns
 
   G4double bary[4] = { 0. };
   FindTetrahedron(pos, bary, quiet);
-  return (TetraIdx<0. ? zero : Grad[TetraIdx]);
+  if (TetraIdx < 0) return zero;
+
+  const auto& grad = mesh.Records[TetraIdx].Grad;
+  return G4ThreeVector(grad[0], grad[1], grad[2]);
+}
+
+void G4CMPTriLinearInterp::
+GetValuesAndGrads(const vector<point3d>& pos, vector<G4double>& values,
+		  vector<G4ThreeVector>& grads, G4bool quiet) const {
+  const MeshTables& mesh = *Mesh;	// For convenience below
+
+  vector<size_t> order;
+  SpatialOrder(pos, order);
+
+  values.resize(pos.size());
+  grads.resize(pos.size());
+
+  // Points are taken in blocks: the tetrahedron search depends on the data
+  // and runs point by point, then interpolation over the whole block runs
+  // on structure-of-arrays copies, in a loop the compiler can vectorize
+  const size_t blockSize = 64;
+  size_t index[blockSize];		// Position in input list
+  G4double dx[blockSize], dy[blockSize], dz[blockSize];	// Offset from Origin
+  G4double invT[9][blockSize];		// Elements of TInverse, by row
+  G4double vtx[4][blockSize];		// Values at the four vertices
+  G4double val[blockSize];
+
+  G4double bary[4];
+  for (size_t first=0; first<order.size(); first+=blockSize) {
+    const size_t last = std::min(first+blockSize, order.size());
+
+    size_t n = 0;			// Points found in this block
+    for (size_t k=first; k<last; k++) {
+      const size_t i = order[k];
+      FindTetrahedron(pos[i].data(), bary, quiet);
+      if (TetraIdx < 0) {
+	values[i] = 0.;
+	grads[i].set(0.,0.,0.);
+	continue;
+      }
+
+      const TetraRecord& rec = mesh.Records[TetraIdx];
+      const tetra3d& tetra = mesh.Tetrahedra[TetraIdx];
+      index[n] = i;
+      dx[n] = pos[i][0]-rec.Origin[0];
+      dy[n] = pos[i][1]-rec.Origin[1];
+      dz[n] = pos[i][2]-rec.Origin[2];
+      for (G4int j=0; j<9; j++) invT[j][n] = rec.TInverse[j/3][j%3];
+      for (G4int j=0; j<4; j++) vtx[j][n] = mesh.V[tetra[j]];
+      grads[i].set(rec.Grad[0], rec.Grad[1], rec.Grad[2]);
+      n++;
+    }
+
+    // Same arithmetic as Cart2Bary(), without branches or indirection
+    for (size_t j=0; j<n; j++) {
+      G4double b0 = invT[0][j]*dx[j] + invT[1][j]*dy[j] + invT[2][j]*dz[j];
+      G4double b1 = invT[3][j]*dx[j] + invT[4][j]*dy[j] + invT[5][j]*dz[j];
+      G4double b2 = invT[6][j]*dx[j] + invT[7][j]*dy[j] + invT[8][j]*dz[j];
+      G4double b3 = 1.0 - b0 - b1 - b2;
+      val[j] = vtx[0][j]*b0 + vtx[1][j]*b1 + vtx[2][j]*b2 + vtx[3][j]*b3;
+    }
+
+    for (size_t j=0; j<n; j++) values[index[j]] = val[j];
+  }
+}
+
+G4bool G4CMPTriLinearInterp::GetValueAndGrad(const G4double pos[3],
+					     G4double& value,
+					     G4ThreeVector& grad) const {
+  const MeshTables& mesh = *Mesh;	// For convenience below
+
+  value = 0.;
+  grad.set(0.,0.,0.);
+
+  G4double bary[4];
+  FindTetrahedron(pos, bary, true);
+
+  // Search may end at closest tetrahedron, which doesn't contain point
+  if (TetraIdx < 0 ||
+      *std::min_element(bary, bary+4) < barySafety) return false;
+
+  const tetra3d& tetra = mesh.Tetrahedra[TetraIdx];
+  value = (mesh.V[tetra[0]] * bary[0] + mesh.V[tetra[1]] * bary[1] +
+	   mesh.V[tetra[2]] * bary[2] + mesh.V[tetra[3]] * bary[3]);
+  const auto& rgrad = mesh.Records[TetraIdx].Grad;
+  grad.set(rgrad[0], rgrad[1], rgrad[2]);
+
+  return true;
+}
+
+void G4CMPTriLinearInterp::GetBoundingBox(point3d& xmin, point3d& xmax) const {
+  const MeshTables& mesh = *Mesh;	// For convenience below
+  xmin.fill(0.);
+  xmax.fill(0.);
+  if (mesh.X.empty()) return;
+
+  xmin = xmax = mesh.X[0];
+  for (const point3d& pt: mesh.X) {
+    for (G4int dim=0; dim<3; dim++) {
+      xmin[dim] = std::min(xmin[dim], pt[dim]);
+      xmax[dim] = std::max(xmax[dim], pt[dim]);
+    }
+  }
 }
 
 
@@ -484,12 +762,22 @@ G4CMPTriLinearInterp::GetGrad(const G4double pos[3], G4bool quiet) const {
 void 
 G4CMPTriLinearInterp::FindTetrahedron(const G4double pt[3], G4double bary[4],
 				      G4bool quiet) const {
-  const G4double barySafety = -1e-10;	// Deal with points close to facets
+  const MeshTables& mesh = *Mesh;	// For convenience below
+
+  auto isInside = [](const G4double b[4]) {
+    return std::all_of(b, b+4, [](G4double bi){return bi>=barySafety;});
+  };
 
   G4double bestBary = 0.;	// Norm of barycentric coordinates (below)
   G4int bestTet = -1;
 
-  if (TetraIdx == -1) TetraIdx = TetraStart;
+  // Start from grid index, unless point is still in last tetrahedron
+  G4int gridTet = GridStartTetra(pt);
+  if (TetraIdx == -1) TetraIdx = (gridTet >= 0 ? gridTet : TetraStart);
+  else if (gridTet >= 0 && gridTet != TetraIdx) {
+    if (Cart2Bary(pt,bary) && isInside(bary)) return;
+    TetraIdx = gridTet;
+  }
 
 #ifdef G4CMPTLI_DEBUG
   if (G4CMPConfigManager::GetVerboseLevel() > 1) {
@@ -499,7 +787,7 @@ G4CMPTriLinearInterp::FindTetrahedron(const G4double pt[3], G4double bary[4],
 #endif
 
   // Loop is used to limit search time, does not index tetrahedra
-  for (size_t count = 0; count < Tetrahedra.size(); ++count) {
+  for (size_t count = 0; count < mesh.Tetrahedra.size(); ++count) {
     if (!Cart2Bary(pt,bary)) {	// Get barycentric coord in current tetrahedron
       if (!quiet) {
 	G4cerr << "G4CMPTriLinearInterp::FindTetrahedron:"
@@ -518,15 +806,14 @@ G4CMPTriLinearInterp::FindTetrahedron(const G4double pt[3], G4double bary[4],
 #ifdef G4CMPTLI_DEBUG
     if (G4CMPConfigManager::GetVerboseLevel() > 2) {
       G4cout << " Loop " << count << ": Tetra " << TetraIdx << ": "
-	     << Tetrahedra[TetraIdx] << "\n bary " << bary[0] << " " << bary[1]
+	     << mesh.Tetrahedra[TetraIdx] << "\n bary " << bary[0] << " " << bary[1]
 	     << " " << bary[2] << " " << bary[3] << " norm " << BaryNorm(bary)
 	     << G4endl;
     }
 #endif
 
     // Point is inside current tetrahedron (TetraIdx)
-    if (std::all_of(bary, bary+4,
-		    [barySafety](G4double b){return b>=barySafety;})) return;
+    if (isInside(bary)) return;
 
     // Evaluate barycentric distance from current tetrahedron
     G4double newNorm = BaryNorm(bary);
@@ -545,7 +832,7 @@ G4CMPTriLinearInterp::FindTetrahedron(const G4double pt[3], G4double bary[4],
     // Point is outside current tetrahedron; shift to nearest neighbor
     G4int minBaryIdx = std::min_element(bary, bary+4) - bary;
 
-    G4int newTetraIdx = Neighbors[TetraIdx][minBaryIdx];
+    G4int newTetraIdx = mesh.Records[TetraIdx].Neighbors[minBaryIdx];
     if (newTetraIdx == -1) {	// Fell off edge of world
       if (!quiet) {
 	G4cerr << "G4CMPTriLinearInterp::FindTetrahedron:"
@@ -586,20 +873,21 @@ G4CMPTriLinearInterp::FindTetrahedron(const G4double pt[3], G4double bary[4],
 
 G4bool
 G4CMPTriLinearInterp::Cart2Bary(const G4double pt[3], G4double bary[4]) const {
-  const tetra3d& tetra = Tetrahedra[TetraIdx];	// For convenience below
-  const mat3x3& invT = TInverse[TetraIdx];
-
-  if (TInvGood[TetraIdx]) {
-    bary[3] = 1.0;
-    for(G4int k=0; k<3; ++k) {
-      bary[k] = (invT[k][0]*(pt[0] - X[tetra[3]][0]) +
-		 invT[k][1]*(pt[1] - X[tetra[3]][1]) +
-		 invT[k][2]*(pt[2] - X[tetra[3]][2]) );
-      bary[3] -= bary[k];
-    }
+  const TetraRecord& rec = Mesh->Records[TetraIdx];	// All in one place
+  const auto& invT = rec.TInverse;
+
+  if (rec.TInvGood) {
+    // Offset from fourth vertex computed once; rows unrolled for compiler
+    const auto& x3 = rec.Origin;
+    const G4double d0 = pt[0]-x3[0], d1 = pt[1]-x3[1], d2 = pt[2]-x3[2];
+
+    bary[0] = invT[0][0]*d0 + invT[0][1]*d1 + invT[0][2]*d2;
+    bary[1] = invT[1][0]*d0 + invT[1][1]*d1 + invT[1][2]*d2;
+    bary[2] = invT[2][0]*d0 + invT[2][1]*d1 + invT[2][2]*d2;
+    bary[3] = 1.0 - bary[0] - bary[1] - bary[2];
   }
 
-  return TInvGood[TetraIdx];
+  return rec.TInvGood;
 }
 
 G4double G4CMPTriLinearInterp::BaryNorm(G4double bary[4]) const {
@@ -607,8 +895,19 @@ G4double G4CMPTriLinearInterp::BaryNorm(G4double bary[4]) const {
 }
 
 G4bool G4CMPTriLinearInterp::BuildT4x3(size_t iTet, mat4x3& ET) const {
+  const MeshTables& mesh = *Mesh;		// For convenience below
+  const tetra3d& tetra = mesh.Tetrahedra[iTet];
+
+  // Invert from vertices in double, not from (possibly float) TInverse
+  mat3x3 T, invT;
+  for (G4int dim=0; dim<3; ++dim) {
+    for (G4int vert=0; vert<3; ++vert) {
+      T[dim][vert] = (mesh.X[tetra[vert]][dim] - mesh.X[tetra[3]][dim]);
+    }
+  }
+
   // NOTE:  If matrix inversion failed, invT is set to all zeros
-  const mat3x3& invT = TInverse[iTet];	// For convenience below
+  G4bool good = MatInv(T, invT, true);
   for (G4int i=0; i<3; ++i) {
     for (G4int j=0; j<3; ++j) {
       ET[i][j] = invT[i][j];
@@ -616,7 +915,7 @@ G4bool G4CMPTriLinearInterp::BuildT4x3(size_t iTet, mat4x3& ET) const {
     ET[3][i] = -invT[0][i] - invT[1][i] - invT[2][i];
   }
 
-  return TInvGood[iTet];
+  return good;
 }
 
 G4double G4CMPTriLinearInterp::Det3(const mat3x3& matrix) const {
@@ -664,30 +963,191 @@ G4bool G4CMPTriLinearInterp::MatInv(const mat3x3& matrix, mat3x3& result,
 // Write data blocks to output file: points and values
 
 void G4CMPTriLinearInterp::SavePoints(const G4String& fname) const {
+  const MeshTables& mesh = *Mesh;	// For convenience below
   G4cout << "Writing points and values to " << fname << G4endl;
   std::ofstream save(fname);
-  for (size_t i=0; i<X.size(); i++) {
-    save << X[i] << " " << V[i]
+  for (size_t i=0; i<mesh.X.size(); i++) {
+    save << mesh.X[i] << " " << mesh.V[i]
 	 << std::endl;
   }
 }
 
 void G4CMPTriLinearInterp::SaveTetra(const G4String& fname) const {
+  const MeshTables& mesh = *Mesh;	// For convenience below
   G4cout << "Writing tetrahedra and neighbors to " << fname << G4endl;
   std::ofstream save(fname);
-    for (size_t i=0; i<Tetrahedra.size(); i++) {
-      save << Tetrahedra[i] << "        " << Neighbors[i] << std::endl;
+    for (size_t i=0; i<mesh.Tetrahedra.size(); i++) {
+      save << mesh.Tetrahedra[i] << "        " << mesh.Records[i].Neighbors
+	   << std::endl;
   }
 }
 
 
+// Binary cache file layout (native byte order, no padding between blocks):
+//
+//   CacheHeader	(below)
+//   X		nPoints x 3 double	mesh coordinates
+//   V		nPoints double		values at mesh points
+//   Tetrahedra	nTetra x 4 int32	vertex indices
+//   Records	nTetra TetraRecord	inverse matrix, origin, gradient,
+//					neighbors and flag, as in memory
+//   GridTetra	nGrid int32		search start for each grid cell
+//
+// Files are rejected if the magic string, version, byte order, record size
+// (e.g., G4CMP_MESH_FLOAT build) or any of the array sizes don't match; the
+// version must be incremented with any change to the layout.
+
+namespace {
+  const char cacheMagic[8] = { 'G','4','C','M','P','T','L','I' };
+  const uint32_t cacheVersion = 3;
+
+  struct CacheHeader {
+    G4CMP::CacheFileHeader file;	// Key identifies mesh input
+    uint64_t nPoints;
+    uint64_t nTetra;
+    uint64_t nGrid;
+    int32_t  gridDim[3];
+    int32_t  tetraStart;
+    uint32_t realSize;		// Floating point size in TetraRecord
+    uint32_t recordSize;	// Size of TetraRecord, including padding
+    double   gridMin[3];
+    double   gridInvStep[3];
+  };
+
+  // Ensure that STL containers can be copied as blocks of memory
+  static_assert(sizeof(point3d) == 3*sizeof(double), "point3d not packed");
+  static_assert(sizeof(tetra3d) == 4*sizeof(int32_t), "tetra3d not packed");
+}
+
+G4bool G4CMPTriLinearInterp::SaveCache(const G4String& fname,
+				       uint64_t sourceKey) const {
+  const MeshTables& mesh = *Mesh;	// For convenience below
+  CacheHeader head;
+  memset(&head, 0, sizeof(head));
+  G4CMP::FillCacheHeader(head.file, cacheMagic, cacheVersion, sourceKey);
+  head.nPoints    = mesh.X.size();
+  head.nTetra     = mesh.Tetrahedra.size();
+  head.nGrid      = mesh.GridTetra.size();
+  head.tetraStart = TetraStart;
+  head.realSize   = sizeof(MeshReal);
+  head.recordSize = sizeof(TetraRecord);
+  for (G4int dim=0; dim<3; dim++) {
+    head.gridDim[dim]     = mesh.GridTetra.empty() ? 0 : mesh.GridDim[dim];
+    head.gridMin[dim]     = mesh.GridTetra.empty() ? 0. : mesh.GridMin[dim];
+    head.gridInvStep[dim] = mesh.GridTetra.empty() ? 0. : mesh.GridInvStep[dim];
+  }
+
+  G4cout << "Writing mesh tables to cache " << fname << G4endl;
+
+  G4bool good = G4CMP::WriteCacheFile(fname, {
+      { &head, sizeof(head) },
+      { mesh.X.data(), mesh.X.size()*sizeof(point3d) },
+      { mesh.V.data(), mesh.V.size()*sizeof(G4double) },
+      { mesh.Tetrahedra.data(), mesh.Tetrahedra.size()*sizeof(tetra3d) },
+      { mesh.Records.data(),		// Padding zeroed by resize
+	mesh.Records.size()*sizeof(TetraRecord) },
+      { mesh.GridTetra.data(), mesh.GridTetra.size()*sizeof(G4int) } });
+
+  if (!good) {
+    G4cerr << "G4CMPTriLinearInterp::SaveCache failed writing " << fname
+	   << G4endl;
+  }
+
+  return good;
+}
+
+G4bool G4CMPTriLinearInterp::LoadCache(const G4String& fname,
+				       uint64_t sourceKey) {
+  std::ifstream cache(fname, std::ios::binary|std::ios::ate);
+  if (!cache.good()) return false;		// No cache file available
+
+  size_t length = cache.tellg();
+  cache.seekg(0);
+
+  G4bool good = ReadCache(cache, length, sourceKey);
+
+  if (good) {
+    G4cout << "G4CMPTriLinearInterp: Loaded " << Mesh->Tetrahedra.size()
+	   << " tetrahedra from cache " << fname << G4endl;
+  } else if (G4CMPConfigManager::GetVerboseLevel()) {
+    G4cerr << "G4CMPTriLinearInterp: Ignoring invalid or stale cache "
+	   << fname << G4endl;
+  }
+
+  return good;
+}
+
+// Tables are read directly into place; header is checked first, so that
+// a stale or truncated file is rejected before any allocation
+
+G4bool G4CMPTriLinearInterp::ReadCache(std::istream& cache, size_t length,
+				       uint64_t sourceKey) {
+  CacheHeader head;
+  if (length < sizeof(head) ||
+      !cache.read(reinterpret_cast<char*>(&head), sizeof(head)))
+    return false;
+
+  if (!G4CMP::IsValidCacheHeader(head.file, cacheMagic, cacheVersion,
+				 sourceKey) ||
+      head.realSize != sizeof(MeshReal) ||
+      head.recordSize != sizeof(TetraRecord)) return false;
+
+  size_t nPts = head.nPoints, nTet = head.nTetra, nGrid = head.nGrid;
+  if (nGrid != (size_t)head.gridDim[0]*head.gridDim[1]*head.gridDim[2])
+    return false;
+
+  size_t expected = (sizeof(head) + nPts*(sizeof(point3d)+sizeof(G4double))
+		     + nTet*(sizeof(tetra3d) + sizeof(TetraRecord))
+		     + nGrid*sizeof(G4int));
+  if (length != expected) return false;		// Truncated or corrupted
+
+  auto mesh = std::make_shared<MeshTables>();	// Don't modify shared tables
+
+  auto fill = [&cache](void* dest, size_t nbytes) {
+    cache.read(static_cast<char*>(dest), nbytes);
+  };
+
+  mesh->X.resize(nPts);          fill(mesh->X.data(), nPts*sizeof(point3d));
+  mesh->V.resize(nPts);          fill(mesh->V.data(), nPts*sizeof(G4double));
+  mesh->Tetrahedra.resize(nTet);
+  fill(mesh->Tetrahedra.data(), nTet*sizeof(tetra3d));
+  mesh->Records.resize(nTet);
+  fill(mesh->Records.data(), nTet*sizeof(TetraRecord));
+  mesh->GridTetra.resize(nGrid);
+  fill(mesh->GridTetra.data(), nGrid*sizeof(G4int));
+
+  if (!cache) return false;			// Keep existing tables
+
+  for (G4int dim=0; dim<3; dim++) {
+    mesh->GridDim[dim]     = head.gridDim[dim];
+    mesh->GridMin[dim]     = head.gridMin[dim];
+    mesh->GridInvStep[dim] = head.gridInvStep[dim];
+  }
+
+  Mesh = mesh;
+
+  // Grid index is rebuilt (or dropped) if stored form doesn't match config
+  if (mesh->GridTetra.empty() == G4CMPConfigManager::UseMeshIndex())
+    FillGridIndex();
+
+  TetraIdx = -1;
+  TetraStart = head.tetraStart;
+
+  return true;
+}
+
+
 // Print out tetrahedral information with coordinates
 
 void G4CMPTriLinearInterp::PrintTetra(std::ostream& os, G4int iTetra) const {
-  os << " from tetra " << iTetra << " neighbors " << Neighbors[iTetra] << ":"
-     << "\n " << Tetrahedra[iTetra][0] << ": " << X[Tetrahedra[iTetra][0]]
-     << "\n " << Tetrahedra[iTetra][1] << ": " << X[Tetrahedra[iTetra][1]]
-     << "\n " << Tetrahedra[iTetra][2] << ": " << X[Tetrahedra[iTetra][2]]
-     << "\n " << Tetrahedra[iTetra][3] << ": " << X[Tetrahedra[iTetra][3]]
+  const tetra3d& tetra = Mesh->Tetrahedra[iTetra];	// For convenience below
+  const vector<point3d>& X = Mesh->X;
+
+  os << " from tetra " << iTetra << " neighbors "
+     << Mesh->Records[iTetra].Neighbors << ":"
+     << "\n " << tetra[0] << ": " << X[tetra[0]]
+     << "\n " << tetra[1] << ": " << X[tetra[1]]
+     << "\n " << tetra[2] << ": " << X[tetra[2]]
+     << "\n " << tetra[3] << ": " << X[tetra[3]]
      << G4endl;
 }
@@ -16,6 +16,8 @@
 // 20190906  M. Kelsey -- Add function to look up process for track
 // 20220816  M. Kelsey -- Move RandomIndex here for more general use
 // 20220921  G4CMP-319 -- Add utilities for thermal (Maxwellian) distributions
+// 20261017  Add HashBytes() to build keys for binary cache files
+// 20261017  Add cache header and temporary-file writing shared by caches
 
 #include "G4CMPUtils.hh"
 #include "G4CMPConfigManager.hh"
@@ -32,6 +34,11 @@
 #include "G4Track.hh"
 #include "G4VProcess.hh"
 #include "Randomize.hh"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <unistd.h>
 
 
 // Select phonon mode using density of states in material
@@ -282,3 +289,54 @@ G4CMP::FindProcess(const G4ParticleDefinition* pd, const G4String& pname) {
 size_t G4CMP::RandomIndex(size_t n) {
   return (size_t)(n*G4UniformRand());
 }
+
+// Hash memory contents for keying cache files (not cryptographic)
+
+uint64_t G4CMP::HashBytes(const void* data, size_t nbytes, uint64_t seed) {
+  const unsigned char* bytes = (const unsigned char*)data;
+  uint64_t hash = seed;
+  for (size_t i=0; i<nbytes; i++) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+// Common fields of binary cache files, and atomic replacement of file
+
+namespace {
+  const uint32_t cacheByteOrder = 0x01020304;
+}
+
+void G4CMP::FillCacheHeader(CacheFileHeader& head, const char* magic,
+			    uint32_t version, uint64_t key) {
+  memcpy(head.magic, magic, sizeof(head.magic));
+  head.version   = version;
+  head.byteOrder = cacheByteOrder;
+  head.key       = key;
+}
+
+G4bool G4CMP::IsValidCacheHeader(const CacheFileHeader& head,
+				 const char* magic, uint32_t version,
+				 uint64_t key) {
+  return (memcmp(head.magic, magic, sizeof(head.magic)) == 0 &&
+	  head.version == version && head.byteOrder == cacheByteOrder &&
+	  head.key == key);
+}
+
+G4bool G4CMP::WriteCacheFile(const G4String& fname,
+			     std::initializer_list<CacheBlock> blocks) {
+  G4String tmpname = fname + ".tmp" + std::to_string(getpid());
+  std::ofstream save(tmpname, std::ios::binary|std::ios::trunc);
+  for (const CacheBlock& block: blocks) {
+    save.write((const char*)block.data, block.nbytes);
+  }
+  save.close();
+
+  if (save.fail() || rename(tmpname.c_str(), fname.c_str()) != 0) {
+    unlink(tmpname.c_str());
+    return false;
+  }
+
+  return true;
+}
@@ -20,6 +20,7 @@
 // 20170601  Inherit from new G4CMPVProcess, which provides G4CMPProcessUtils
 // 20170620  Follow interface changes in G4CMPProcessUtils
 // 20201231  FillParticleChange() should also reset valley index if requested
+// 20261017  Discard per-step G4CMPStepContext when valley index is changed
 
 #include "G4CMPVDriftProcess.hh"
 #include "G4CMPConfigManager.hh"
@@ -27,6 +28,7 @@
 #include "G4CMPDriftHole.hh"
 #include "G4CMPGeometryUtils.hh"
 #include "G4CMPDriftTrackInfo.hh"
+#include "G4CMPStepContext.hh"
 #include "G4CMPTrackUtils.hh"
 #include "G4CMPUtils.hh"
 #include "G4DynamicParticle.hh"
@@ -114,6 +116,7 @@ void
 G4CMPVDriftProcess::FillParticleChange(G4int ivalley, G4double Ekin,
              const G4ThreeVector& v) {
   G4CMP::GetTrackInfo<G4CMPDriftTrackInfo>(GetCurrentTrack())->SetValleyIndex(ivalley);
+  G4CMPStepContext::Invalidate();	// Cached kinematics used old valley
 
   aParticleChange.ProposeMomentumDirection(v.unit());
   aParticleChange.ProposeEnergy(Ekin);
@@ -12,23 +12,127 @@
 // in the concrete subclasses.
 //
 // 20200914  Add function call to precompute potential gradients (field)
+// 20261017  Replace UseValues() with CheckValues(); subclasses own values
+// 20261017  Add GetValues(), GetGrads() etc., evaluating in spatial order
 
 #include "G4CMPVMeshInterpolator.hh"
+#include <algorithm>
+#include <stdint.h>
 
 
-// Replace values at mesh points without rebuilding tables
+// Verify that replacement values match existing mesh
 
-void G4CMPVMeshInterpolator::UseValues(const std::vector<G4double>& v) {
-  if (!V.empty() && v.size() != V.size()) {
+G4bool G4CMPVMeshInterpolator::CheckValues(const std::vector<G4double>& v,
+					   size_t npts) const {
+  if (npts > 0 && v.size() != npts) {
     G4cerr << "G4CMPVMeshInterpolator::UseValues ERROR Input vector v does"
 	   << " not match existing mesh V." << G4endl;
+    return false;
+  }
+
+  return true;
+}
+
+
+// Evaluate many points, in an order which keeps successive points close
+
+void G4CMPVMeshInterpolator::GetValues(const std::vector<point3d>& pos,
+				       std::vector<G4double>& values,
+				       G4bool quiet) const {
+  std::vector<size_t> order;
+  SpatialOrder(pos, order);
+
+  values.resize(pos.size());
+  for (size_t i: order) values[i] = GetValue(pos[i].data(), quiet);
+}
+
+void G4CMPVMeshInterpolator::GetGrads(const std::vector<point3d>& pos,
+				      std::vector<G4ThreeVector>& grads,
+				      G4bool quiet) const {
+  std::vector<size_t> order;
+  SpatialOrder(pos, order);
+
+  grads.resize(pos.size());
+  for (size_t i: order) grads[i] = GetGrad(pos[i].data(), quiet);
+}
+
+void G4CMPVMeshInterpolator::
+GetValuesAndGrads(const std::vector<point3d>& pos,
+		  std::vector<G4double>& values,
+		  std::vector<G4ThreeVector>& grads, G4bool quiet) const {
+  std::vector<size_t> order;
+  SpatialOrder(pos, order);
+
+  values.resize(pos.size());
+  grads.resize(pos.size());
+  for (size_t i: order) {
+    values[i] = GetValue(pos[i].data(), quiet);
+    grads[i] = GetGrad(pos[i].data(), quiet);
+  }
+}
+
+
+// Sort points by interleaving bits of quantized coordinates (Morton code)
+
+namespace {
+  // Spread low 10 bits of input so that each is followed by two zeros
+  uint32_t SpreadBits(uint32_t x) {
+    x &= 0x3ff;
+    x = (x | x << 16) & 0x030000ff;
+    x = (x | x << 8)  & 0x0300f00f;
+    x = (x | x << 4)  & 0x030c30c3;
+    x = (x | x << 2)  & 0x09249249;
+    return x;
+  }
+}
+
+void G4CMPVMeshInterpolator::SpatialOrder(const std::vector<point3d>& pos,
+					  std::vector<size_t>& order) {
+  const size_t npts = pos.size();
+  order.resize(npts);
+  if (npts < 3 || npts > 0xffffffff) {	// Too few (or many) points to sort
+    for (size_t i=0; i<npts; i++) order[i] = i;
     return;
   }
 
-  V = v;
-  FillGradients();	// Will call subclass implementation
+  point3d lo = pos[0], hi = pos[0];
+  for (const point3d& pt: pos) {
+    for (G4int dim=0; dim<3; dim++) {
+      lo[dim] = std::min(lo[dim], pt[dim]);
+      hi[dim] = std::max(hi[dim], pt[dim]);
+    }
+  }
+
+  const G4double nbins = 1023.;		// 10 bits per axis, 30-bit key
+  G4double scale[3];
+  for (G4int dim=0; dim<3; dim++) {
+    scale[dim] = (hi[dim] > lo[dim]) ? nbins/(hi[dim]-lo[dim]) : 0.;
+  }
+
+  // Morton code in upper half of each entry, point index in lower half
+  std::vector<uint64_t> key(npts);
+  for (size_t i=0; i<npts; i++) {
+    uint64_t code = 0;
+    for (G4int dim=0; dim<3; dim++) {
+      G4double u = (pos[i][dim]-lo[dim])*scale[dim];
+      code |= SpreadBits(u>0. ? (uint32_t)u : 0) << dim;	// NaN to zero
+    }
+    key[i] = (code << 32) | i;
+  }
+
+  // Stable radix sort on Morton code, three passes of ten bits each
+  std::vector<uint64_t> work(npts);
+  std::vector<size_t> count(1024);
+  for (G4int shift=32; shift<62; shift+=10) {
+    std::fill(count.begin(), count.end(), 0);
+    for (uint64_t k: key) count[(k>>shift) & 0x3ff]++;
+
+    size_t sum = 0;
+    for (size_t& c: count) { size_t n = c; c = sum; sum += n; }
+
+    for (uint64_t k: key) work[count[(k>>shift) & 0x3ff]++] = k;
+    key.swap(work);
+  }
 
-#ifdef G4CMPTLI_DEBUG
-  SavePoints(savePrefix+"_points.dat");
-#endif
+  for (size_t i=0; i<npts; i++) order[i] = key[i] & 0xffffffff;
 }
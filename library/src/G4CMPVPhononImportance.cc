@@ -0,0 +1,43 @@
+/***********************************************************************\
+ * This software is licensed under the terms of the GNU General Public *
+ * License version 3 or later. See G4CMP/LICENSE for the full license. *
+\***********************************************************************/
+
+/// \file library/src/G4CMPVPhononImportance.cc
+/// \brief Implementation of the G4CMPVPhononImportance base class
+//
+// $Id$
+//
+// 20261017  New class, for use with G4CMPPhononWeightWindow
+
+#include "G4CMPVPhononImportance.hh"
+#include "globals.hh"
+#include <algorithm>
+
+
+// Insert new band in order of lower edge, replacing duplicate edges
+
+void G4CMPVPhononImportance::AddBand(G4double lower, G4double importance) {
+  if (importance < 0.) {
+    G4Exception("G4CMPVPhononImportance::AddBand", "Importance001",
+		JustWarning, "Negative importance ignored.");
+    return;
+  }
+
+  std::pair<G4double,G4double> band(lower, importance);
+  auto pos = std::lower_bound(bands.begin(), bands.end(), band);
+  if (pos != bands.end() && pos->first == lower) pos->second = importance;
+  else bands.insert(pos, band);
+}
+
+
+// Find last band with lower edge at or below value
+
+G4double G4CMPVPhononImportance::BandImportance(G4double value) const {
+  auto pos = std::upper_bound(bands.begin(), bands.end(), value,
+		[](G4double v, const std::pair<G4double,G4double>& band) {
+		  return v < band.first;
+		});
+
+  return (pos == bands.begin()) ? 1. : (pos-1)->second;
+}
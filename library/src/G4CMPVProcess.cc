@@ -14,9 +14,11 @@
 // 20190906  Bug fix in UseRateModel(), check for good pointer, not null;
 //		Add function to initialize rate model after LoadDataForTrack
 // 20210915  Change diagnostic output to verbose=3 or higher.
+// 20261017  Wrap rate model with G4CMPTabulatedRate if configured.
 
 #include "G4CMPVProcess.hh"
 #include "G4CMPConfigManager.hh"
+#include "G4CMPTabulatedRate.hh"
 #include "G4CMPVScatteringRate.hh"
 #include "G4ForceCondition.hh"
 #include "G4SystemOfUnits.hh"
@@ -43,9 +45,19 @@ G4CMPVProcess::~G4CMPVProcess() {
 void G4CMPVProcess::UseRateModel(G4CMPVScatteringRate* model) {
   if (model == rateModel) return;		// Nothing to change
 
+  const G4CMPTabulatedRate* table =
+    dynamic_cast<const G4CMPTabulatedRate*>(rateModel);
+  if (table && model == table->GetModel()) return;	// Already tabulated
+
   if (rateModel) delete rateModel;		// Avoid memory leaks!
   rateModel = model;
 
+  // Replace model's calculation with interpolation table if requested
+  if (rateModel && rateModel->CanTabulate() &&
+      G4CMPConfigManager::UseRateTables()) {
+    rateModel = new G4CMPTabulatedRate(rateModel);
+  }
+
   // Ensure that rate model is syncronized with process state
   ConfigureRateModel();
 }
@@ -46,17 +46,26 @@
 //		return thread-local instance.
 // 20231017  E. Michaud -- Add 'AddValley(const G4ThreeVector&)'
 // 20240426  S. Zatschler -- Add explicit fallthrough statements to switch cases
+// 20261017  Add batch MapKtoVg(), using G4CMPPhononKinTable batch lookup
+// 20261017  FillMaps() reads and writes binary cache of K-Vg map
+// 20261017  LookupKtoVg() uses single record lookup in kinematics table
+// 20261017  K-Vg map cache uses header and WriteCacheFile() from G4CMPUtils
 
 #include "G4LatticeLogical.hh"
 #include "G4CMPPhononKinematics.hh"	// **** THIS BREAKS G4 PORTING ****
 #include "G4CMPPhononKinTable.hh"	// **** THIS BREAKS G4 PORTING ****
 #include "G4CMPConfigManager.hh"	// **** THIS BREAKS G4 PORTING ****
 #include "G4CMPUnitsTable.hh"		// **** THIS BREAKS G4 PORTING ****
+#include "G4CMPUtils.hh"			// **** THIS BREAKS G4 PORTING ****
 #include "G4RotationMatrix.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4PhysicalConstants.hh"
+#include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <fstream>
+#include <iomanip>
+#include <sstream>
 
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
@@ -312,6 +321,13 @@ void G4LatticeLogical::FillElasticity() {
 void G4LatticeLogical::FillMaps() {
   if (!fpPhononKin) return;			// Can't fill without solver
 
+  // Map depends only on kinematics inputs and binning
+  const int32_t nBins = KVBINS;
+  const uint64_t key = G4CMP::HashBytes(&nBins, sizeof(nBins),
+					GetKinematicsKey());
+  const G4String cacheFile = GetKinCacheName(key, ".kvmap");
+  if (!cacheFile.empty() && LoadMaps(cacheFile, key)) return;
+
   G4ThreeVector k;
   for (G4int itheta = 0; itheta<KVBINS; itheta++) {
     G4double theta = itheta*pi/(KVBINS-1);	// Last entry is at pi
@@ -330,6 +346,91 @@ void G4LatticeLogical::FillMaps() {
     G4cout << "G4LatticeLogical::FillMaps populated " << KVBINS
 	   << " bins in theta and phi for all polarizations." << G4endl;
   }
+
+  if (!cacheFile.empty()) SaveMaps(cacheFile, key);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
+
+// Phonon kinematics are fully determined by elasticity tensor and density
+
+uint64_t G4LatticeLogical::GetKinematicsKey() const {
+  uint64_t key = G4CMP::HashBytes(fElReduced, sizeof(fElReduced));
+  return G4CMP::HashBytes(&fDensity, sizeof(fDensity), key);
+}
+
+G4String G4LatticeLogical::GetKinCacheName(uint64_t key,
+					   const G4String& suffix) const {
+  const G4String& dir = G4CMPConfigManager::GetKinCacheDir();
+  if (dir.empty()) return "";
+
+  std::ostringstream fname;
+  fname << dir << "/" << (fName.empty() ? "lattice" : fName) << "_"
+	<< std::hex << std::setw(16) << std::setfill('0') << key << suffix;
+  return fname.str();
+}
+
+// Binary K-Vg map cache file layout (native byte order):
+//   KVMapHeader	(below)
+//   fKVMap		NUM_MODES x KVBINS x KVBINS x 3 double
+
+namespace {
+  const char kvMapMagic[8] = { 'G','4','C','M','P','K','V','M' };
+  const uint32_t kvMapVersion = 1;
+
+  struct KVMapHeader {
+    G4CMP::CacheFileHeader file;	// Key identifies kinematics and binning
+    uint32_t nModes;
+    uint32_t nBins;
+  };
+
+  static_assert(sizeof(G4ThreeVector) == 3*sizeof(G4double),
+		"G4ThreeVector not packed");
+}
+
+G4bool G4LatticeLogical::LoadMaps(const G4String& fname, uint64_t key) {
+  std::ifstream load(fname, std::ios::binary);
+  if (!load.good()) return false;		// No cache file available
+
+  KVMapHeader head;
+  load.read((char*)&head, sizeof(head));
+  if (!load.good() ||
+      !G4CMP::IsValidCacheHeader(head.file, kvMapMagic, kvMapVersion, key) ||
+      head.nModes != G4PhononPolarization::NUM_MODES ||
+      head.nBins != KVBINS) {
+    if (verboseLevel) {
+      G4cerr << "G4LatticeLogical::LoadMaps ignoring invalid or stale cache "
+	     << fname << G4endl;
+    }
+    return false;
+  }
+
+  load.read((char*)fKVMap, sizeof(fKVMap));
+  if (load.gcount() != (std::streamsize)sizeof(fKVMap)) return false;
+
+  if (verboseLevel) {
+    G4cout << "G4LatticeLogical::FillMaps loaded " << KVBINS
+	   << " bins in theta and phi from " << fname << G4endl;
+  }
+
+  return true;
+}
+
+G4bool G4LatticeLogical::SaveMaps(const G4String& fname, uint64_t key) const {
+  KVMapHeader head;
+  memset(&head, 0, sizeof(head));
+  G4CMP::FillCacheHeader(head.file, kvMapMagic, kvMapVersion, key);
+  head.nModes    = G4PhononPolarization::NUM_MODES;
+  head.nBins     = KVBINS;
+
+  if (!G4CMP::WriteCacheFile(fname, { { &head, sizeof(head) },
+				      { fKVMap, sizeof(fKVMap) } })) {
+    G4cerr << "G4LatticeLogical::SaveMaps unable to write " << fname
+	   << G4endl;
+    return false;
+  }
+
+  return true;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
@@ -344,6 +445,74 @@ G4ThreeVector G4LatticeLogical::MapKtoVg(G4int mode,
 	   : LookupKtoVg(mode,k) );
 }
 
+// Batch mapping uses single interpolation pass over kinematics table
+
+void G4LatticeLogical::MapKtoVg(size_t n, const G4int* mode,
+				const G4double* kx, const G4double* ky,
+				const G4double* kz, G4double* vx,
+				G4double* vy, G4double* vz) const {
+  if (fpPhononKin && G4CMPConfigManager::UseKVSolver()) {
+    G4ThreeVector vg;		// Eigensolver has no batch form
+    for (size_t i=0; i<n; i++) {
+      vg = ComputeKtoVg(mode[i], G4ThreeVector(kx[i],ky[i],kz[i]));
+      vx[i] = vg.x();
+      vy[i] = vg.y();
+      vz[i] = vg.z();
+    }
+    return;
+  }
+
+  if (fpPhononTable) {
+    fpPhononTable->interpGroupVelocities(n, mode, kx, ky, kz, vx, vy, vz);
+    return;
+  }
+
+  // Same bilinear interpolation as LookupKtoVg(), done in blocks so that
+  // bin finding and interpolation are simple loops over plain arrays
+  const G4double tScale = (KVBINS-1)/pi;
+  const G4double pScale = (KVBINS-1)/twopi;
+
+  const size_t BLOCK = 64;
+  G4int iTheta[BLOCK], iPhi[BLOCK];
+  G4double dTheta[BLOCK], dPhi[BLOCK];
+
+  for (size_t i0=0; i0<n; i0+=BLOCK) {
+    const size_t nb = std::min(BLOCK, n-i0);
+
+    for (size_t j=0; j<nb; j++) {
+      const size_t i = i0+j;
+      G4double theta = std::atan2(std::sqrt(kx[i]*kx[i]+ky[i]*ky[i]), kz[i]);
+      G4double phi = std::atan2(ky[i], kx[i]);
+      phi += (phi<0.) ? twopi : 0.;
+
+      dTheta[j] = theta*tScale;
+      iTheta[j] = std::min(G4int(dTheta[j]), KVBINS-2);	// Upper edge
+      dTheta[j] -= iTheta[j];
+
+      dPhi[j] = phi*pScale;
+      iPhi[j] = std::min(G4int(dPhi[j]), KVBINS-2);
+      dPhi[j] -= iPhi[j];
+    }
+
+    for (size_t j=0; j<nb; j++) {
+      const size_t i = i0+j;
+      const G4ThreeVector& v00 = fKVMap[mode[i]][iTheta[j]][iPhi[j]];
+      const G4ThreeVector& v10 = fKVMap[mode[i]][iTheta[j]+1][iPhi[j]];
+      const G4ThreeVector& v01 = fKVMap[mode[i]][iTheta[j]][iPhi[j]+1];
+      const G4ThreeVector& v11 = fKVMap[mode[i]][iTheta[j]+1][iPhi[j]+1];
+
+      const G4double w00 = (1.-dTheta[j])*(1.-dPhi[j]);
+      const G4double w10 = dTheta[j]*(1.-dPhi[j]);
+      const G4double w01 = (1.-dTheta[j])*dPhi[j];
+      const G4double w11 = dTheta[j]*dPhi[j];
+
+      vx[i] = w00*v00.x() + w10*v10.x() + w01*v01.x() + w11*v11.x();
+      vy[i] = w00*v00.y() + w10*v10.y() + w01*v01.y() + w11*v11.y();
+      vz[i] = w00*v00.z() + w10*v10.z() + w01*v01.z() + w11*v11.z();
+    }
+  }
+}
+
 G4ThreeVector G4LatticeLogical::ComputeKtoVg(G4int mode,
 					     const G4ThreeVector& k) const {  
   if (!fpPhononKin) {
@@ -357,9 +526,7 @@ G4ThreeVector G4LatticeLogical::ComputeKtoVg(G4int mode,
 G4ThreeVector G4LatticeLogical::LookupKtoVg(G4int mode,
 					    const G4ThreeVector& k) const {  
   if (fpPhononTable)
-    return (fpPhononTable->interpGroupVelocity(mode, k.unit())*
-	    fpPhononTable->interpGroupVelocity_N(mode, k.unit()).unit()
-	    );
+    return fpPhononTable->interpGroupVelocityVector(mode, k.unit());
 
   G4int iTheta, iPhi;		// Bin indices
   G4double dTheta, dPhi;	// Offsets in bin for interpolation
@@ -19,6 +19,8 @@
 // 20170527  Drop unnecessary <fstream>
 // 20170817  Increase verbosity cut on informational messages
 // 20170928  Replace "polarizationState" with "mode"
+// 20261017  Replace mutex in GetLatticeManager() with atomic pointer; look
+//		up lattices in flat index published on registration.
 
 #include "G4LatticeManager.hh"
 #include "G4CMPConfigManager.hh"
@@ -30,7 +32,7 @@
 #include "G4VPhysicalVolume.hh"
 #include "G4SystemOfUnits.hh"
 
-G4LatticeManager* G4LatticeManager::fLM = 0;
+std::atomic<G4LatticeManager*> G4LatticeManager::fLM(nullptr);
 
 #include "G4AutoLock.hh"
 namespace {
@@ -40,7 +42,7 @@ namespace {
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
 
 G4LatticeManager::G4LatticeManager()
-  : verboseLevel(G4CMPConfigManager::GetVerboseLevel()) {
+  : verboseLevel(G4CMPConfigManager::GetVerboseLevel()), fIndex(nullptr) {
   Clear();
 }
 
@@ -72,16 +74,59 @@ void G4LatticeManager::Clear() {
 
   fLLatticeList.clear();
   fLLattices.clear();
+
+  // Geometry is being rebuilt; no tracking is using the old index
+  fIndex.store(nullptr, std::memory_order_release);
+  fIndexHistory.clear();
+}
+
+// Copy registered lattices into flat index for lookups during tracking
+
+void G4LatticeManager::PublishIndex() {
+  std::unique_ptr<LatticeIndex> index(new LatticeIndex);
+
+  for (const auto& entry: fPLatticeList) {
+    const G4VPhysicalVolume* vol = entry.first;
+    if (!vol) {
+      index->defaultLattice = entry.second;
+      continue;
+    }
+
+    size_t id = vol->GetInstanceID();
+    if (id >= index->byVolume.size())
+      index->byVolume.resize(id+1, std::make_pair(nullptr, nullptr));
+    index->byVolume[id] = entry;
+  }
+
+  for (const auto& entry: fLLatticeList) {
+    const G4Material* mat = entry.first;
+    size_t id = mat->GetIndex();
+    if (id >= index->byMaterial.size())
+      index->byMaterial.resize(id+1, std::make_pair(nullptr, nullptr));
+    index->byMaterial[id] = entry;
+  }
+
+  // Previous index is kept until Clear(), in case a reader still holds it
+  fIndex.store(index.get(), std::memory_order_release);
+  fIndexHistory.push_back(std::move(index));
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
 
 G4LatticeManager* G4LatticeManager::GetLatticeManager() {
+  G4LatticeManager* theLM = fLM.load(std::memory_order_acquire);
+  if (theLM) return theLM;
+
   G4AutoLock latLock(&latMutex);      // Protect before changing pointer
 
   // if no lattice manager exists, create one.
-  if (!fLM) fLM = new G4LatticeManager();
-  return fLM;
+  theLM = fLM.load(std::memory_order_relaxed);
+  if (!theLM) {
+    theLM = new G4LatticeManager();
+    fLM.store(theLM, std::memory_order_release);
+  }
+
+  return theLM;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
@@ -101,6 +146,7 @@ G4bool G4LatticeManager::RegisterLattice(const G4Material* Mat,
 
   fLLattices.insert(Lat);		// Take ownership in registry
   fLLatticeList[Mat] = Lat;
+  PublishIndex();
 
   if (verboseLevel) {
     G4cout << "G4LatticeManager::RegisterLattice: "
@@ -182,6 +228,7 @@ G4bool G4LatticeManager::RegisterLattice(const G4VPhysicalVolume* Vol,
 
   fPLattices.insert(Lat);
   fPLatticeList[Vol] = Lat;
+  PublishIndex();
 
   if (verboseLevel) {
     G4cout << "G4LatticeManager::RegisterLattice: "
@@ -208,12 +255,14 @@ G4bool G4LatticeManager::RegisterLattice(const G4VPhysicalVolume* Vol,
 // Returns a pointer to the LatticeLogical associated with material
 
 G4LatticeLogical* G4LatticeManager::GetLattice(const G4Material* Mat) const {
-  LatticeMatMap::const_iterator latFind = fLLatticeList.find(Mat);
-  if (latFind != fLLatticeList.end()) {
+  const LatticeIndex* index = fIndex.load(std::memory_order_acquire);
+  if (index && Mat && Mat->GetIndex() < index->byMaterial.size()
+      && index->byMaterial[Mat->GetIndex()].first == Mat) {
+    G4LatticeLogical* lat = index->byMaterial[Mat->GetIndex()].second;
     if (verboseLevel>2)
-      G4cout << "G4LatticeManager::GetLattice found " << latFind->second
-	     << " for " << (Mat?Mat->GetName():"NULL") << "." << G4endl;
-    return latFind->second;
+      G4cout << "G4LatticeManager::GetLattice found " << lat
+	     << " for " << Mat->GetName() << "." << G4endl;
+    return lat;
   }
 
 
@@ -229,12 +278,12 @@ G4LatticeLogical* G4LatticeManager::GetLattice(const G4Material* Mat) const {
 
 G4LatticePhysical* 
 G4LatticeManager::GetLattice(const G4VPhysicalVolume* Vol) const {
-  LatticeVolMap::const_iterator latFind = fPLatticeList.find(Vol);
-  if (latFind != fPLatticeList.end()) {
+  G4LatticePhysical* lat = FindLattice(Vol);
+  if (lat) {
     if (verboseLevel>2)
-      G4cout << "G4LatticeManager::GetLattice found " << latFind->second
+      G4cout << "G4LatticeManager::GetLattice found " << lat
 	     << " for " << (Vol?Vol->GetName():"default") << "." << G4endl;
-    return latFind->second;
+    return lat;
   }
 
   if (verboseLevel) 
@@ -249,13 +298,29 @@ G4LatticeManager::GetLattice(const G4VPhysicalVolume* Vol) const {
 // Return true if volume Vol has a physical lattice
 
 G4bool G4LatticeManager::HasLattice(const G4VPhysicalVolume* Vol) const {
-  return (fPLatticeList.find(Vol) != fPLatticeList.end());
+  return (FindLattice(Vol) != 0);
 }
 
 // Return true if material Mat has a logical lattice
 
 G4bool G4LatticeManager::HasLattice(const G4Material* Mat) const {
-  return (fLLatticeList.find(Mat) != fLLatticeList.end());
+  const LatticeIndex* index = fIndex.load(std::memory_order_acquire);
+  return (index && Mat && Mat->GetIndex() < index->byMaterial.size()
+	  && index->byMaterial[Mat->GetIndex()].first == Mat);
+}
+
+// Quiet lookup in published index, used by GetLattice() and HasLattice()
+
+G4LatticePhysical* 
+G4LatticeManager::FindLattice(const G4VPhysicalVolume* Vol) const {
+  const LatticeIndex* index = fIndex.load(std::memory_order_acquire);
+  if (!index) return 0;
+
+  if (!Vol) return index->defaultLattice;
+
+  size_t id = Vol->GetInstanceID();
+  return ((id < index->byVolume.size() && index->byVolume[id].first == Vol)
+	  ? index->byVolume[id].second : 0);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
@@ -25,6 +25,7 @@
 // 20200520  For MT thread safety, wrap G4ThreeVector buffer in function to
 //		return thread-local instance.
 // 20220921  G4CMP-319 -- Add utilities for thermal (Maxwellian) distributions
+// 20261017  Add MapKtoVg(), with batch version for vectors of phonons
 
 #include "G4LatticePhysical.hh"
 #include "G4CMPConfigManager.hh"
@@ -32,6 +33,7 @@
 #include "G4PhysicalConstants.hh"
 #include "G4RotationMatrix.hh"
 #include "G4SystemOfUnits.hh"
+#include <algorithm>
 
 
 // Null vector defined for convenience (avoid memory churn)
@@ -135,6 +137,55 @@ G4ThreeVector G4LatticePhysical::MapKtoVDir(G4int mode, const G4ThreeVector& k)
   return RotateToSolid(VG);
 }
 
+///////////////////////////////
+//Loads the group velocity vector, avoids separate MapKtoV and MapKtoVDir
+///////////////////////////////
+G4ThreeVector G4LatticePhysical::MapKtoVg(G4int mode, const G4ThreeVector& k) const {
+  if (verboseLevel>1) G4cout << "G4LatticePhysical::MapKtoVg " << k << G4endl;
+
+  RotateToLattice(tempvec()=k);
+  G4ThreeVector VG = fLattice->MapKtoVg(mode, tempvec());
+
+  return RotateToSolid(VG);
+}
+
+///////////////////////////////
+//Loads group velocity vectors for a list of phonons.  Rotated wavevectors
+//are staged in fixed-size component arrays for the lattice batch lookup.
+///////////////////////////////
+void G4LatticePhysical::MapKtoVg(const std::vector<G4int>& mode,
+				 const std::vector<G4ThreeVector>& k,
+				 std::vector<G4ThreeVector>& vg) const {
+  if (verboseLevel>1) {
+    G4cout << "G4LatticePhysical::MapKtoVg for " << k.size() << " phonons"
+	   << G4endl;
+  }
+
+  const size_t n = std::min(mode.size(), k.size());
+  vg.resize(n);
+
+  const size_t BLOCK = 256;
+  G4double kx[BLOCK], ky[BLOCK], kz[BLOCK];
+  G4double vx[BLOCK], vy[BLOCK], vz[BLOCK];
+
+  for (size_t i0=0; i0<n; i0+=BLOCK) {
+    const size_t nb = std::min(BLOCK, n-i0);
+    for (size_t j=0; j<nb; j++) {
+      RotateToLattice(tempvec()=k[i0+j]);
+      kx[j] = tempvec().x();
+      ky[j] = tempvec().y();
+      kz[j] = tempvec().z();
+    }
+
+    fLattice->MapKtoVg(nb, &mode[i0], kx, ky, kz, vx, vy, vz);
+
+    for (size_t j=0; j<nb; j++) {
+      vg[i0+j].set(vx[j], vy[j], vz[j]);
+      RotateToSolid(vg[i0+j]);
+    }
+  }
+}
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
 
 G4double G4LatticePhysical::MapPtoEkin(G4int iv, const G4ThreeVector& p) const {
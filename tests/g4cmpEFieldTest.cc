@@ -17,6 +17,7 @@
  * 20170527  Abort job if output file fails
  * 20180712  Expand to exercise field manager, different field types
  * 20190918  Convert to test either 2D or 3D mesh; input names predefined
+ * 20261017  Use batch GetFieldValues() for whole grid of points
  */
 
 #include "G4CMPFieldManager.hh"
@@ -127,7 +128,6 @@ void testField(G4double lx, G4double ly, G4double lz, G4int N,
   outputFile << "   x\tt   y\tt   z\tt   V\t\t   Ex\t\t   Ey\t\t   Ez"
 	     << endl;
 
-  G4double EMfield[6];
   G4int n = cbrt(N);
   G4double Deltax = lx/n;
   G4double Deltay = ly/n;
@@ -136,22 +136,29 @@ void testField(G4double lx, G4double ly, G4double lz, G4int N,
   G4cout << "Generating " << n*n*n << " points in steps of " << Deltax
 	 << " " << Deltay << " " << Deltaz << " ..." << G4endl;
 
+  vector<G4ThreeVector> pts;
+  pts.reserve(n*n*n);
   for (G4int i = 0; i < n; ++i) {
     for (G4int j = 0; j < n; ++j) {
       for (G4int k = 0; k < n; ++k) {
-	G4double x = -(Deltax * n/2) + (i * Deltax);
-	G4double y = -(Deltay * n/2) + (j * Deltay);
-	G4double z = -(Deltaz * n/2) + (k * Deltaz);
-	G4double pt[4] = {x, y, z, 0};
-	G4double V = field.GetPotential(pt);
-	field.GetFieldValue(pt, EMfield);
-
-	outputFile << x << "\t" << y << "\t" << z << "\t" << V << "\t"
-		   << EMfield[3] << "\t" << EMfield[4] << "\t" << EMfield[5]
-		   << endl;
+	pts.emplace_back(-(Deltax * n/2) + (i * Deltax),
+			 -(Deltay * n/2) + (j * Deltay),
+			 -(Deltaz * n/2) + (k * Deltaz));
       }
     }
   }
+
+  // Evaluate all points together, so mesh is traversed in spatial order
+  vector<G4double> V;
+  vector<G4ThreeVector> E;
+  field.GetFieldValues(pts, E, V);
+
+  for (size_t i = 0; i < pts.size(); ++i) {
+    outputFile << pts[i].x() << "\t" << pts[i].y() << "\t" << pts[i].z()
+	       << "\t" << V[i] << "\t"
+	       << E[i].x() << "\t" << E[i].y() << "\t" << E[i].z()
+	       << endl;
+  }
   
   outputFile.close();
 }
@@ -0,0 +1,190 @@
+// testEigenSolver3x3: Compare G4CMPEigenSolver3x3 against G4CMPEigenSolver
+//
+// Usage: testEigenSolver3x3 [-v N] [Ntrial]
+//
+// Options: -v N	Set verbosity to N: 1 = print errors, 2 = print all
+//
+// Solves Christoffel matrices for cubic (Ge) elastic constants along the
+// crystal symmetry axes, where transverse modes are degenerate, and along
+// random directions, along with random and exactly degenerate symmetric
+// matrices.  Eigenvalues must agree with the general NR solver.  Since
+// eigenvectors of degenerate eigenvalues are not unique, and signs are
+// arbitrary, each eigenvector is checked by residual and orthonormality,
+// and against the NR eigenvector (up to sign) where the eigenvalue is
+// well separated.  Exit status is the number of failed matrices.
+//
+// 20261017  New test of G4CMPEigenSolver3x3, for G4CMPPhononKinematics
+
+#include "globals.hh"
+#include "G4CMPEigenSolver.hh"
+#include "G4CMPEigenSolver3x3.hh"
+#include "G4ThreeVector.hh"
+#include "Randomize.hh"
+#include <algorithm>
+#include <stdlib.h>
+#include <unistd.h>
+
+
+// Flag to print out all calculations
+
+namespace {
+  G4int verbose = 0;
+  G4int ntest = 0;
+
+  const G4double tolerance = 1e-9;	// Relative to largest eigenvalue
+}
+
+// Christoffel matrix for cubic crystal along unit vector n; constants
+// are Ge C11, C12, C44 [GPa], divided by density [g/cm3]
+
+void fillChristoffel(const G4ThreeVector& n, G4double a[3][3]) {
+  const G4double rho = 5.323;
+  const G4double C11 = 126.0/rho, C12 = 44.0/rho, C44 = 67.7/rho;
+
+  for (G4int i=0; i<3; i++) {
+    for (G4int j=0; j<3; j++) {
+      a[i][j] = (i==j) ? C11*n[i]*n[i] + C44*(1.-n[i]*n[i])
+	: (C12+C44)*n[i]*n[j];
+    }
+  }
+}
+
+// Random symmetric matrix, optionally with the two smallest eigenvalues
+// equal, rotated to a random orientation
+
+void fillRandom(G4bool degenerate, G4double a[3][3]) {
+  G4double lambda[3] = { 1.+G4UniformRand(), G4UniformRand(), 0. };
+  lambda[2] = degenerate ? lambda[1] : G4UniformRand();
+
+  G4ThreeVector e[3];
+  e[0] = G4RandomDirection();
+  e[1] = e[0].orthogonal().unit().rotate(e[0], twopi*G4UniformRand());
+  e[2] = e[0].cross(e[1]);
+
+  for (G4int i=0; i<3; i++) {
+    for (G4int j=0; j<3; j++) {
+      a[i][j] = 0.;
+      for (G4int k=0; k<3; k++) a[i][j] += lambda[k]*e[k][i]*e[k][j];
+    }
+  }
+}
+
+// Compare solvers for given matrix; return 1 if any check fails
+
+G4int testMatrix(const char* label, const G4double a[3][3]) {
+  ntest++;
+
+  G4CMP::matrix<G4double> m(3,3,0.);
+  for (G4int i=0; i<3; i++) {
+    for (G4int j=0; j<3; j++) m[i][j] = a[i][j];
+  }
+
+  G4CMPEigenSolver nr(m);
+  G4CMPEigenSolver3x3 fast(a);
+
+  G4double scale = std::max(std::fabs(nr.d[0]), std::fabs(nr.d[2]));
+  if (scale <= 0.) scale = 1.;
+
+  G4double valDiff = 0., residual = 0., orthoDiff = 0., vecDiff = 0.;
+  for (G4int k=0; k<3; k++) {
+    valDiff = std::max(valDiff, std::fabs(fast.d[k]-nr.d[k])/scale);
+
+    for (G4int i=0; i<3; i++) {
+      G4double r = -fast.d[k]*fast.z[i][k];
+      for (G4int j=0; j<3; j++) r += a[i][j]*fast.z[j][k];
+      residual = std::max(residual, std::fabs(r)/scale);
+    }
+
+    for (G4int l=0; l<3; l++) {
+      G4double dot = 0.;
+      for (G4int i=0; i<3; i++) dot += fast.z[i][k]*fast.z[i][l];
+      orthoDiff = std::max(orthoDiff, std::fabs(dot-(k==l ? 1. : 0.)));
+    }
+
+    // Eigenvectors are only unique (up to sign) for separated eigenvalues
+    G4bool separated = true;
+    for (G4int l=0; l<3; l++) {
+      if (l != k && std::fabs(nr.d[k]-nr.d[l]) < 1e-6*scale)
+	separated = false;
+    }
+
+    if (separated) {
+      G4double dot = 0.;
+      for (G4int i=0; i<3; i++) dot += fast.z[i][k]*nr.z[i][k];
+      vecDiff = std::max(vecDiff, 1.-std::fabs(dot));
+    }
+  }
+
+  G4bool sorted = (fast.d[0] >= fast.d[1] && fast.d[1] >= fast.d[2]);
+  G4bool failed = (!sorted || valDiff > tolerance || residual > tolerance ||
+		   orthoDiff > tolerance || vecDiff > tolerance);
+
+  if (verbose>1 || (verbose && failed)) {
+    G4cout << label << (failed ? " FAILED" : "") << "\n eigenvalues "
+	   << fast.d[0] << " " << fast.d[1] << " " << fast.d[2]
+	   << (sorted ? "" : " (unsorted)")
+	   << "\n NR difference " << valDiff << " residual " << residual
+	   << " orthonormality " << orthoDiff << " eigenvectors " << vecDiff
+	   << G4endl;
+  }
+
+  return failed ? 1 : 0;
+}
+
+// Christoffel matrix along crystal direction
+
+G4int testDirection(const char* label, const G4ThreeVector& dir) {
+  G4double a[3][3];
+  fillChristoffel(dir.unit(), a);
+  return testMatrix(label, a);
+}
+
+
+int main(int argc, char* argv[]) {
+  G4int ntrial = 10000;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "v:")) != -1) {
+    if (opt == 'v') verbose = atoi(optarg);
+    else {
+      G4cerr << "Usage: " << argv[0] << " [-v N] [Ntrial]" << G4endl;
+      ::exit(1);
+    }
+  }
+  if (optind < argc) ntrial = atoi(argv[optind]);
+
+  G4int nfail = 0;
+
+  // Symmetry axes have degenerate transverse modes
+  nfail += testDirection("[100]", G4ThreeVector(1,0,0));
+  nfail += testDirection("[010]", G4ThreeVector(0,1,0));
+  nfail += testDirection("[001]", G4ThreeVector(0,0,1));
+  nfail += testDirection("[110]", G4ThreeVector(1,1,0));
+  nfail += testDirection("[111]", G4ThreeVector(1,1,1));
+  nfail += testDirection("[-1-11]", G4ThreeVector(-1,-1,1));
+
+  // Directions just off the symmetry axes are nearly degenerate
+  for (G4double eps=1e-2; eps>1e-11; eps*=1e-2) {
+    nfail += testDirection("near [001]", G4ThreeVector(eps,0.,1.));
+    nfail += testDirection("near [111]", G4ThreeVector(1.+eps,1.,1.));
+  }
+
+  G4double a[3][3];
+  for (G4int i=0; i<ntrial; i++) {
+    nfail += testDirection("random direction", G4RandomDirection());
+
+    fillRandom(false, a);
+    nfail += testMatrix("random matrix", a);
+
+    fillRandom(true, a);
+    nfail += testMatrix("degenerate matrix", a);
+  }
+
+  G4double ident[3][3] = { {1.,0.,0.}, {0.,1.,0.}, {0.,0.,1.} };
+  nfail += testMatrix("identity", ident);
+
+  G4cout << "G4CMPEigenSolver3x3: " << nfail << " of " << ntest
+	 << " matrices failed" << G4endl;
+
+  return nfail;
+}
@@ -0,0 +1,181 @@
+// testHitBlock: Write and read back G4CMPHitBlock binary hit data
+//
+// Usage: testHitBlock [-v N] [Nhits]
+//
+// Options: -v N	Set verbosity to N: 1 = print errors, 2 = print all
+//
+// Fills blocks from Nhits (default 1000) G4CMPElectrodeHits with varied
+// contents and particle names, writes a file header and the blocks to a
+// memory buffer, then reads them back.  Every column must round-trip
+// exactly, and match the hit values in output units (to float precision
+// where columns are float).  Empty blocks, end of file, and a corrupted
+// header are also checked.  Exit status is the number of failures.
+//
+// 20261017  New test of G4CMPHitBlock, for G4CMPHitWriter
+
+#include "globals.hh"
+#include "G4CMPElectrodeHit.hh"
+#include "G4CMPHitBlock.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ThreeVector.hh"
+#include <algorithm>
+#include <math.h>
+#include <sstream>
+#include <stdlib.h>
+#include <unistd.h>
+#include <vector>
+
+
+// Flag to print out all calculations
+
+namespace {
+  G4int verbose = 0;
+
+  const char* particles[] = { "phononL", "phononTS", "phononTF",
+			      "G4CMPDriftElectron", "G4CMPDriftHole" };
+}
+
+// Report failure of a single check
+
+G4int check(G4bool ok, const char* label) {
+  if (verbose>1 || (verbose && !ok)) {
+    G4cout << label << (ok ? " OK" : " FAILED") << G4endl;
+  }
+
+  return ok ? 0 : 1;
+}
+
+// Fill hit with contents varying by index
+
+void fillHit(G4int i, G4CMPElectrodeHit& hit) {
+  hit.SetTrackID(i+1);
+  hit.SetParticleName(particles[i%5]);
+  hit.SetStartEnergy((1.+0.37*i)*meV);
+  hit.SetStartPosition(G4ThreeVector(0.1*i, -0.2*i, 0.3)*mm);
+  hit.SetStartTime((1.+i*1e3)*ns);	// Wide range of times
+  hit.SetEnergyDeposit(0.5*i*meV);
+  hit.SetWeight(1./(i+1));
+  hit.SetFinalPosition(G4ThreeVector(-0.1*i, 0.2*i, -0.3)*mm);
+  hit.SetFinalTime((2.+i*1e6)*ns);
+}
+
+// Compare float or double column values with relative tolerance
+
+G4bool same(G4double a, G4double b, G4double tol) {
+  return fabs(a-b) <= tol*std::max(fabs(a), fabs(b));
+}
+
+// Compare column contents of two blocks
+
+G4bool sameBlock(const G4CMPHitBlock& a, const G4CMPHitBlock& b) {
+  if (a.Size() != b.Size()) return false;
+
+  for (size_t i=0; i<a.Size(); i++) {
+    if (a.runID[i] != b.runID[i] || a.eventID[i] != b.eventID[i] ||
+	a.trackID[i] != b.trackID[i] ||
+	a.GetParticleName(i) != b.GetParticleName(i) ||
+	a.startE[i] != b.startE[i] || a.startX[i] != b.startX[i] ||
+	a.startY[i] != b.startY[i] || a.startZ[i] != b.startZ[i] ||
+	a.startTime[i] != b.startTime[i] || a.EDep[i] != b.EDep[i] ||
+	a.weight[i] != b.weight[i] || a.finalX[i] != b.finalX[i] ||
+	a.finalY[i] != b.finalY[i] || a.finalZ[i] != b.finalZ[i] ||
+	a.finalTime[i] != b.finalTime[i]) return false;
+  }
+
+  return true;
+}
+
+// Compare block contents with original hits, in output units
+
+G4bool matchesHits(const G4CMPHitBlock& block, G4int run, G4int event,
+		   const std::vector<G4CMPElectrodeHit>& hits) {
+  if (block.Size() != hits.size()) return false;
+
+  const G4double ftol = 1e-6;		// Float columns
+  for (size_t i=0; i<hits.size(); i++) {
+    const G4CMPElectrodeHit& hit = hits[i];
+    if (block.runID[i] != run || block.eventID[i] != event ||
+	block.trackID[i] != hit.GetTrackID() ||
+	block.GetParticleName(i) != hit.GetParticleName() ||
+	!same(block.startE[i], hit.GetStartEnergy()/eV, ftol) ||
+	!same(block.startX[i], hit.GetStartPosition().x()/m, ftol) ||
+	!same(block.startY[i], hit.GetStartPosition().y()/m, ftol) ||
+	!same(block.startZ[i], hit.GetStartPosition().z()/m, ftol) ||
+	block.startTime[i] != hit.GetStartTime()/ns ||
+	!same(block.EDep[i], hit.GetEnergyDeposit()/eV, ftol) ||
+	!same(block.weight[i], hit.GetWeight(), ftol) ||
+	!same(block.finalX[i], hit.GetFinalPosition().x()/m, ftol) ||
+	!same(block.finalY[i], hit.GetFinalPosition().y()/m, ftol) ||
+	!same(block.finalZ[i], hit.GetFinalPosition().z()/m, ftol) ||
+	block.finalTime[i] != hit.GetFinalTime()/ns) return false;
+  }
+
+  return true;
+}
+
+
+int main(int argc, char* argv[]) {
+  G4int nhits = 1000;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "v:")) != -1) {
+    if (opt == 'v') verbose = atoi(optarg);
+    else {
+      G4cerr << "Usage: " << argv[0] << " [-v N] [Nhits]" << G4endl;
+      ::exit(1);
+    }
+  }
+  if (optind < argc) nhits = atoi(argv[optind]);
+
+  std::vector<G4CMPElectrodeHit> hits(nhits);
+  for (G4int i=0; i<nhits; i++) fillHit(i, hits[i]);
+
+  // Two events in separate blocks, with an empty block between
+  G4CMPHitBlock first(nhits), empty, second(nhits);
+  for (const auto& hit: hits) first.Add(3, 7, hit);
+  for (const auto& hit: hits) second.Add(3, 8, hit);
+
+  G4int nfail = 0;
+  nfail += check(matchesHits(first, 3, 7, hits), "Add() converts hits");
+  nfail += check(first.names.size() == size_t(std::min(nhits, 5)),
+		 "Particle names stored once per block");
+
+  std::stringstream buffer;
+  nfail += check(G4CMPHitBlock::WriteHeader(buffer), "WriteHeader()");
+  nfail += check(first.Write(buffer), "Write() first block");
+  nfail += check(empty.Write(buffer), "Write() empty block");
+  nfail += check(second.Write(buffer), "Write() second block");
+
+  // Reuse one block for reading, as G4CMP/tools/g4cmpHitReader does
+  G4CMPHitBlock input;
+  nfail += check(G4CMPHitBlock::ReadHeader(buffer), "ReadHeader()");
+  nfail += check(input.Read(buffer) && sameBlock(input, first),
+		 "Read() first block");
+  nfail += check(matchesHits(input, 3, 7, hits), "First block matches hits");
+  nfail += check(input.Read(buffer) && input.Empty(), "Read() empty block");
+  nfail += check(input.Read(buffer) && sameBlock(input, second),
+		 "Read() second block");
+  nfail += check(!input.Read(buffer), "Read() stops at end of file");
+
+  // CSV output should be identical after round trip
+  std::ostringstream csvOut, csvIn;
+  second.Print(csvOut);
+  input.Clear();
+  std::stringstream again;
+  second.Write(again);
+  input.Read(again);
+  input.Print(csvIn);
+  nfail += check(csvOut.str() == csvIn.str(), "Print() after round trip");
+
+  // Corrupted magic string must be rejected
+  std::string corrupt = buffer.str();
+  corrupt[0] = 'X';
+  std::istringstream bad(corrupt);
+  nfail += check(!G4CMPHitBlock::ReadHeader(bad),
+		 "ReadHeader() rejects bad file");
+
+  G4cout << "G4CMPHitBlock: " << nfail << " checks failed with " << nhits
+	 << " hits" << G4endl;
+
+  return nfail;
+}
@@ -0,0 +1,110 @@
+// testHitMerging: Exercise G4CMPHitMerging accumulator table
+//
+// Usage: testHitMerging [-v N] [Ntracks]
+//
+// Options: -v N	Set verbosity to N: 1 = print errors, 2 = print all
+//
+// Track accumulators are kept in an open-addressed table indexed by track
+// ID.  A default-constructed G4CMPStepInfo has track ID -1, which must be
+// handled like any other ID:  repeated lookups return the same entry
+// without growing the table, and it is found again at end of event.  The
+// table is then filled with Ntracks (default 1000) IDs, including zero and
+// negative values, forcing several resizes, and each entry is checked.
+// Exit status is the number of failures.
+//
+// 20261017  New test of G4CMPHitMerging accumulator table
+
+#include "globals.hh"
+#include "G4CMPHitMerging.hh"
+#include "G4CMPStepAccumulator.hh"
+#include <limits.h>
+#include <set>
+#include <stdlib.h>
+#include <unistd.h>
+
+
+// Flag to print out all calculations
+
+namespace { G4int verbose = 0; }
+
+// Expose accumulator lookup for testing
+
+class TestHitMerging : public G4CMPHitMerging {
+public:
+  using G4CMPHitMerging::GetAccumulator;
+  using G4CMPHitMerging::FindAccumulator;
+};
+
+// Report failure of a single check
+
+G4int check(G4bool ok, const char* label) {
+  if (verbose>1 || (verbose && !ok)) {
+    G4cout << label << (ok ? " OK" : " FAILED") << G4endl;
+  }
+
+  return ok ? 0 : 1;
+}
+
+
+int main(int argc, char* argv[]) {
+  G4int ntracks = 1000;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "v:")) != -1) {
+    if (opt == 'v') verbose = atoi(optarg);
+    else {
+      G4cerr << "Usage: " << argv[0] << " [-v N] [Ntracks]" << G4endl;
+      ::exit(1);
+    }
+  }
+  if (optind < argc) ntracks = atoi(argv[optind]);
+
+  TestHitMerging merging;
+  G4int nfail = 0;
+
+  // Step without track information; table must not grow on each lookup
+  G4CMPStepInfo noTrack;
+  G4CMPStepAccumulator* accum = merging.GetAccumulator(noTrack.trackID);
+  accum->nsteps = 1;
+
+  G4bool same = true;
+  for (G4int i=0; i<10*ntracks; i++) {
+    same &= (merging.GetAccumulator(noTrack.trackID) == accum);
+  }
+
+  nfail += check(same, "Repeated lookup of default track ID");
+  nfail += check(merging.FindAccumulator(noTrack.trackID) == accum,
+		 "Find default track ID");
+  nfail += check(merging.FindAccumulator(-2) == 0, "Find missing ID -2");
+  nfail += check(merging.FindAccumulator(INT_MIN) == 0,
+		 "Find missing ID INT_MIN");
+
+  // Fill table with sequential and negative IDs, marking each entry
+  std::vector<G4int> ids;
+  for (G4int i=0; i<ntracks; i++) ids.push_back(i);
+  for (G4int i=2; i<ntracks/10; i++) ids.push_back(-i);
+  ids.push_back(INT_MIN);
+  ids.push_back(INT_MAX);
+
+  for (G4int id: ids) merging.GetAccumulator(id)->eventID = id;
+
+  G4bool found = true;
+  std::set<G4CMPStepAccumulator*> entries;
+  for (G4int id: ids) {
+    G4CMPStepAccumulator* entry = merging.FindAccumulator(id);
+    found &= (entry && entry->eventID == id);
+    entries.insert(entry);
+  }
+
+  nfail += check(found, "Find all track IDs after resizing");
+  nfail += check(entries.size() == ids.size(), "Distinct entry for each ID");
+
+  accum = merging.FindAccumulator(noTrack.trackID);
+  nfail += check(accum && accum->nsteps == 1 && entries.count(accum) == 0,
+		 "Default track ID kept after resizing");
+
+  G4cout << "G4CMPHitMerging: " << nfail << " checks failed with "
+	 << ids.size()+1 << " track IDs" << G4endl;
+
+  return nfail;
+}
@@ -0,0 +1,156 @@
+// testInverseCDFTable: Validate sampling from G4CMPInverseCDFTable
+//
+// Usage: testInverseCDFTable [-v N] [Nthrow]
+//
+// Options: -v N	Set verbosity to N: 1 = print errors, 2 = print all
+//
+// Draws Nthrow (default 200000) values from tables of known PDFs, and
+// compares with the analytic CDF using the Kolmogorov-Smirnov distance.
+// Row coordinates both on and between table rows are tested; between
+// rows, the expected CDF is the weighted sum of the two adjacent rows.
+// PDFs with empty regions and an integrable endpoint singularity are
+// checked for range and mean.  Exit status is the number of failures.
+//
+// 20261017  New test of G4CMPInverseCDFTable, for G4CMPKaplanQP
+
+#include "globals.hh"
+#include "G4CMPInverseCDFTable.hh"
+#include <algorithm>
+#include <functional>
+#include <math.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <vector>
+
+
+// Flag to print out all calculations
+
+namespace {
+  G4int verbose = 0;
+  G4int nthrow = 200000;
+}
+
+// Draw values from table, sorted for comparison with CDF
+
+std::vector<G4double> sampleTable(const G4CMPInverseCDFTable& table,
+				  G4double v) {
+  std::vector<G4double> draws(nthrow);
+  for (auto& s: draws) s = table.Sample(v);
+  std::sort(draws.begin(), draws.end());
+  return draws;
+}
+
+// Kolmogorov-Smirnov test of sorted draws against expected CDF
+
+G4int testKS(const char* label, const std::vector<G4double>& draws,
+	     const std::function<G4double(G4double)>& cdf) {
+  G4double dmax = 0.;
+  const G4double n = draws.size();
+  for (size_t i=0; i<draws.size(); i++) {
+    G4double F = cdf(draws[i]);
+    dmax = std::max(dmax, std::max(F-i/n, (i+1)/n-F));
+  }
+
+  G4bool failed = (dmax*sqrt(n) > 2.);	// Beyond 99.9% confidence level
+
+  if (verbose>1 || (verbose && failed)) {
+    G4cout << label << (failed ? " FAILED" : "") << " KS distance " << dmax
+	   << " (sqrt(N)*D = " << dmax*sqrt(n) << ")" << G4endl;
+  }
+
+  return failed ? 1 : 0;
+}
+
+// Check that all draws are within [smin,smax], with expected mean
+
+G4int testRange(const char* label, const std::vector<G4double>& draws,
+		G4double smin, G4double smax, G4double mean, G4double tol) {
+  G4double sum = 0.;
+  for (G4double s: draws) sum += s;
+  sum /= draws.size();
+
+  G4bool failed = (!(draws.front() >= smin) || !(draws.back() <= smax) ||
+		   fabs(sum-mean) > tol);
+
+  if (verbose>1 || (verbose && failed)) {
+    G4cout << label << (failed ? " FAILED" : "") << " range "
+	   << draws.front() << " to " << draws.back() << " mean " << sum
+	   << " (expect " << mean << ")" << G4endl;
+  }
+
+  return failed ? 1 : 0;
+}
+
+
+// Linear PDF, 1+v*s, with normalized CDF (s + v*s^2/2)/(1 + v/2)
+
+G4double linearCDF(G4double v, G4double s) {
+  return (s + 0.5*v*s*s) / (1. + 0.5*v);
+}
+
+G4int testLinear() {
+  G4CMPInverseCDFTable table(0., 4., 5,
+			     [](G4double v, G4double s) { return 1.+v*s; });
+
+  G4int nfail = 0;
+  nfail += testKS("linear row v=0", sampleTable(table, 0.),
+		  [](G4double s) { return linearCDF(0., s); });
+  nfail += testKS("linear row v=3", sampleTable(table, 3.),
+		  [](G4double s) { return linearCDF(3., s); });
+  nfail += testKS("linear row v=4", sampleTable(table, 4.),
+		  [](G4double s) { return linearCDF(4., s); });
+
+  // Draws between rows come from either neighbour, weighted by distance
+  nfail += testKS("linear between v=1.25", sampleTable(table, 1.25),
+		  [](G4double s) {
+		    return 0.75*linearCDF(1., s) + 0.25*linearCDF(2., s);
+		  });
+
+  // Values outside range use nearest row
+  nfail += testKS("linear below v=-1", sampleTable(table, -1.),
+		  [](G4double s) { return linearCDF(0., s); });
+
+  return nfail;
+}
+
+// PDF which is zero outside [0.25,0.75]; no draws should fall there
+
+G4int testEmptyRegion() {
+  G4CMPInverseCDFTable table(0., 1., 2,
+			     [](G4double, G4double s) {
+			       return (s > 0.25 && s < 0.75) ? 1. : 0.;
+			     });
+
+  return testRange("empty region", sampleTable(table, 0.5), 0.25, 0.75,
+		   0.5, 0.005);
+}
+
+// PDF singular at s=0, 1/sqrt(s), has mean 1/3; the midpoint rule does
+// not integrate the first bin exactly, so a KS test is not used
+
+G4int testSingular() {
+  G4CMPInverseCDFTable table(0., 1., 2,
+			     [](G4double, G4double s) { return 1./sqrt(s); });
+
+  return testRange("singular", sampleTable(table, 0.5), 0., 1., 1./3., 0.01);
+}
+
+
+int main(int argc, char* argv[]) {
+  int opt;
+  while ((opt = getopt(argc, argv, "v:")) != -1) {
+    if (opt == 'v') verbose = atoi(optarg);
+    else {
+      G4cerr << "Usage: " << argv[0] << " [-v N] [Nthrow]" << G4endl;
+      ::exit(1);
+    }
+  }
+  if (optind < argc) nthrow = atoi(argv[optind]);
+
+  G4int nfail = testLinear() + testEmptyRegion() + testSingular();
+
+  G4cout << "G4CMPInverseCDFTable: " << nfail << " tests failed with "
+	 << nthrow << " throws" << G4endl;
+
+  return nfail;
+}
@@ -0,0 +1,63 @@
+//
+//  g4cmpHitReader -- Convert binary hit files from G4CMPHitWriter to CSV
+//
+//  Usage: g4cmpHitReader <hits.bin> [hits.csv]
+//
+//  Output is written to standard output if no CSV file is given.  The
+//  columns are the same as the CSV hit files written by the examples.
+//
+//  20261017  New utility, for use with G4CMPHitWriter files
+
+#include "G4CMPHitBlock.hh"
+#include <fstream>
+#include <iostream>
+using namespace std;
+
+
+int main(int argc, const char* argv[]) {
+  if (argc < 2) {
+    cerr << "Usage: " << argv[0] << " <hits.bin> [hits.csv]" << endl;
+    ::exit(1);
+  }
+
+  ifstream input(argv[1], ios::binary);
+  if (!input.good()) {
+    cerr << argv[0] << " Unable to open " << argv[1] << endl;
+    ::exit(1);
+  }
+
+  if (!G4CMPHitBlock::ReadHeader(input)) {
+    cerr << argv[0] << " " << argv[1] << " is not a G4CMP hit file,"
+	 << " or has different version or byte order" << endl;
+    ::exit(2);
+  }
+
+  ofstream csvFile;
+  if (argc > 2) {
+    csvFile.open(argv[2], ios::trunc);
+    if (!csvFile.good()) {
+      cerr << argv[0] << " Unable to open " << argv[2] << endl;
+      ::exit(1);
+    }
+  }
+
+  ostream& output = (argc > 2) ? csvFile : cout;
+  G4CMPHitBlock::PrintHeader(output);
+
+  G4CMPHitBlock block;
+  size_t nHits = 0;
+  while (input.peek() != EOF) {
+    if (!block.Read(input)) {
+      cerr << argv[0] << " Truncated block after " << nHits << " hits"
+	   << endl;
+      ::exit(3);
+    }
+
+    block.Print(output);
+    nHits += block.Size();
+  }
+
+  if (argc > 2) cout << "Converted " << nHits << " hits" << endl;
+
+  return 0;
+}